@@ -39,6 +39,7 @@ HEADERS += \
     src/backends/QMakeGeneratorBackend.h \
     src/commands/RemoteCommand.h \
     src/commands/SearchCommand.h \
+    src/commands/VerifyCommand.h \
     src/managers/BundleManager.h \
     src/commands/BundleXpcfCommand.h \
     src/commands/CleanCommand.h \
@@ -52,6 +53,8 @@ HEADERS += \
 #    src/HttpAsyncDownloader.h \
     src/commands/ListCommand.h \
     src/managers/XpcfXmlManager.h \
+    src/managers/AggregatedPathsManager.h \
+    src/managers/RunEnvironmentManager.h \
     src/tools/BrewSystemTool.h \
     src/tools/ConanSystemTool.h \
     src/tools/GitTool.h \
@@ -62,8 +65,22 @@ HEADERS += \
     src/tools/NativeSystemTools.h \
     src/tools/PkgConfigTool.h \
     src/utils/DepUtils.h \
+    src/utils/DependencyFileCache.h \
+    src/utils/DependencyFileParser.h \
+    src/utils/ElfUtils.h \
+    src/utils/InternedString.h \
+    src/utils/HashUtils.h \
+    src/utils/MappedFile.h \
+    src/utils/PackageManifest.h \
     src/utils/OsUtils.h \
     src/utils/PathBuilder.h \
+    src/utils/Stats.h \
+    src/utils/BundleEngine.h \
+    src/utils/ArchiveEntries.h \
+    src/utils/BlockDeflater.h \
+    src/utils/TarWriter.h \
+    src/utils/Trace.h \
+    src/utils/ZipWriter.h \
     src/commands/ProfileCommand.h \
     src/commands/RunCommand.h \
     src/commands/VersionCommand.h \
@@ -93,6 +110,7 @@ SOURCES += \
     src/backends/QMakeGeneratorBackend.cpp \
     src/commands/RemoteCommand.cpp \
     src/commands/SearchCommand.cpp \
+    src/commands/VerifyCommand.cpp \
     src/managers/BundleManager.cpp \
     src/commands/BundleXpcfCommand.cpp \
     src/commands/CleanCommand.cpp \
@@ -100,6 +118,8 @@ SOURCES += \
     src/commands/ConfigureCommand.cpp \
     src/commands/ListCommand.cpp \
     src/managers/XpcfXmlManager.cpp \
+    src/managers/AggregatedPathsManager.cpp \
+    src/managers/RunEnvironmentManager.cpp \
     src/tools/BrewSystemTool.cpp \
     src/tools/ConanSystemTool.cpp \
     src/tools/GitTool.cpp \
@@ -109,8 +129,22 @@ SOURCES += \
     src/tools/NativeSystemTools.cpp \
     src/tools/PkgConfigTool.cpp \
     src/utils/DepUtils.cpp \
+    src/utils/DependencyFileCache.cpp \
+    src/utils/DependencyFileParser.cpp \
+    src/utils/ElfUtils.cpp \
+    src/utils/InternedString.cpp \
+    src/utils/HashUtils.cpp \
+    src/utils/MappedFile.cpp \
+    src/utils/PackageManifest.cpp \
     src/utils/OsUtils.cpp \
     src/utils/PathBuilder.cpp \
+    src/utils/Stats.cpp \
+    src/utils/BundleEngine.cpp \
+    src/utils/ArchiveEntries.cpp \
+    src/utils/BlockDeflater.cpp \
+    src/utils/TarWriter.cpp \
+    src/utils/Trace.cpp \
+    src/utils/ZipWriter.cpp \
     src/commands/ProfileCommand.cpp \
     src/commands/RunCommand.cpp \
     src/tools/VCPKGSystemTool.cpp \
@@ -164,6 +198,8 @@ win32 {
     # windows libs
     LIBS += -L$$(WINDOWSSDKDIR)lib/winv6.3/um/x64
     LIBS += -lshell32 -lgdi32 -lComdlg32
+    # peak memory usage (--stats)
+    LIBS += -lpsapi
     # openssl libs dependencies
     LIBS += -luser32 -ladvapi32 -lCrypt32
 }
@@ -28,6 +28,7 @@
 #include <boost/asio/ssl/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/beast/core.hpp>
+#include "utils/Trace.h"
 #include <boost/asio/connect.hpp>
 #include <regex>
 #include "root_certificates.hpp"
@@ -148,10 +149,15 @@ template < typename Q, typename R>
 void AsioSocketWrapper<Q,R>::connect()
 {
     tcp::resolver resolver{m_ioc};
-     // Look up the domain name
-    auto const results = resolver.resolve(getHost(), getPort());
+    tcp::resolver::results_type results;
+    {
+        Trace::Span span("download", "dns");
+        // Look up the domain name
+        results = resolver.resolve(getHost(), getPort());
+    }
 
     // Make the connection on the IP address we get from a lookup
+    Trace::Span span("download", "connect");
     boost::asio::connect(m_comLayer, results.begin(), results.end());
 }
 
@@ -231,13 +237,21 @@ void AsioStreamWrapper<Q,R>::connect()
         throw boost::system::system_error{ec};
     }
 
-    // Look up the domain name
-    auto const results = resolver.resolve(getHost(), getPort());
+    tcp::resolver::results_type results;
+    {
+        Trace::Span span("download", "dns");
+        // Look up the domain name
+        results = resolver.resolve(getHost(), getPort());
+    }
 
-    // Make the connection on the IP address we get from a lookup
-    boost::asio::connect(m_comLayer.next_layer(), results.begin(), results.end());
+    {
+        Trace::Span span("download", "connect");
+        // Make the connection on the IP address we get from a lookup
+        boost::asio::connect(m_comLayer.next_layer(), results.begin(), results.end());
+    }
 
     // Perform the SSL handshake
+    Trace::Span span("download", "tls handshake");
     m_comLayer.handshake(ssl::stream_base::client);
 }
 
@@ -8,6 +8,7 @@
 #include <boost/process.hpp>
 #include <boost/predef.h>
 #include <boost/dll.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include "utils/DepUtils.h"
 #include "utils/PathBuilder.h"
@@ -67,6 +68,7 @@ static const map<std::string,std::vector<std::string>> validationMap ={{"action"
                                                                        {"--operating-system",{"mac","win","unix","android","ios","linux"}},
                                                                        {"--cpp-std",{"11","14","17","20"}},
                                                                        {"--generator",{"qmake","cmake","pkgconfig","make","json","bazel"}},
+                                                                       {"--link",{"copy","symlink","hardlink"}},
                                                                        #ifdef BOOST_OS_LINUX_AVAILABLE
                                                                        {"--restrict",{"brew","conan","system","vcpkg"}}
                                                                        #endif
@@ -167,6 +169,8 @@ CmdOptions::CmdOptions()
     m_cliApp.add_flag("--force,-f", m_force, "force command execution : ignore cache entries, already installed files ...\n 'force' flag also enable 'override' flag");
     m_verbose = false;
     m_cliApp.add_flag("--verbose,-v", m_verbose, "verbose mode");
+    m_cliApp.add_option("--trace", m_traceFile, "record the command spans (downloads, subprocesses, parses ...) in a Chrome trace event file to open in chrome://tracing or ui.perfetto.dev");
+    m_cliApp.add_option("--stats", m_statsFile, "print a metrics summary at the end of the command (downloads, caches, processes, phases wall time, peak memory, packages) and write the metrics in a JSON file");
     m_override = false;
     m_cliApp.add_flag("--override,-e", m_override, "override existing files while (re)-installing packages/rules...");
     m_recurse = false;
@@ -185,6 +189,11 @@ CmdOptions::CmdOptions()
     bundleCommand->add_option("--destination,-d", m_destinationRoot, "Destination directory")->required();
     bundleCommand->add_option("file", m_dependenciesFile, "Remaken dependencies files"); // ,true);
     bundleCommand->add_flag("--ignore-errors", m_ignoreErrors, "force command execution : ignore error when a remaken dependency doesn't contains shared library");
+    bundleCommand->add_flag("--incremental", m_incrementalBundle, "only copy the libraries changed since the previous bundle in the destination folder, and remove the obsolete ones");
+    bundleCommand->add_option("--link", m_bundleLinkMode, "bundle links to the remaken packages instead of copies, for local test deployments: " + getOptionString("--link") + " (default: copy) - hard links need the packages and the destination on the same file system");
+    bundleCommand->add_flag("--needed-only", m_bundleNeededOnly, "only bundle the libraries reached from the --target files through their ELF DT_NEEDED entries, and report the unresolved ones");
+    bundleCommand->add_option("--target", m_bundleTargets, "executable or library whose needed libraries are bundled with --needed-only (can be repeated)");
+    bundleCommand->add_option("--archive", m_bundleArchive, "write the bundle in a reproducible .tar.gz or .zip archive instead of copying the libraries to the destination directory (the destination directory still receives the other bundle files)");
 
     // BUNDLEXPCF COMMAND
     CLI::App * bundleXpcfCommand = m_cliApp.add_subcommand("bundleXpcf","copy xpcf modules and their dependencies from their declaration in a xpcf xml file");
@@ -194,6 +203,11 @@ CmdOptions::CmdOptions()
                                                                                "copied with their dependencies"); // ,true);
     bundleXpcfCommand->add_option("--pkgdeps", m_dependenciesFile, "Remaken dependencies files"); // ,true);
     bundleXpcfCommand->add_option("xpcf_file", m_xpcfConfigurationFile, "XPCF xml module declaration file")->required();
+    bundleXpcfCommand->add_flag("--incremental", m_incrementalBundle, "only copy the libraries changed since the previous bundle in the destination folder, and remove the obsolete ones");
+    bundleXpcfCommand->add_option("--link", m_bundleLinkMode, "bundle links to the remaken packages instead of copies, for local test deployments: " + getOptionString("--link") + " (default: copy) - hard links need the packages and the destination on the same file system");
+    bundleXpcfCommand->add_flag("--needed-only", m_bundleNeededOnly, "only bundle the libraries reached from the XPCF modules and the --target files through their ELF DT_NEEDED entries, and report the unresolved ones");
+    bundleXpcfCommand->add_option("--target", m_bundleTargets, "executable or library whose needed libraries are bundled with --needed-only (can be repeated)");
+    bundleXpcfCommand->add_option("--archive", m_bundleArchive, "write the bundle in a reproducible .tar.gz or .zip archive instead of copying the libraries to the destination directory (the destination directory still receives the other bundle files)");
     bundleXpcfCommand->add_flag("--ignore-errors", m_ignoreErrors, "force command execution : ignore error when a remaken dependency doesn't contains shared library");
 
     /*CLI::App * cleanCommand =*/ m_cliApp.add_subcommand("clean", "WARNING : remove every remaken installed packages");
@@ -204,6 +218,8 @@ CmdOptions::CmdOptions()
     configureCommand->add_option("--condition", m_configureConditions, "set condition to value");
     m_mode = "shared";
     configureCommand->add_option("--mode,-m", m_mode, "Mode: " + getOptionString("--mode")); // ,true);
+    configureCommand->add_flag("--relocatable", m_relocatable, "express paths located in the remaken root relative to a REMAKEN_ROOT variable defined in a separate remaken_root file, so that generated build files are identical across machines (qmake, cmake and bazel generators)");
+    configureCommand->add_flag("--aggregate-paths", m_aggregatePaths, "link dependencies include and lib folders in single include and lib folders of the project build folder, and only reference these folders in generated files (qmake and bazel generators)");
 
     // INFO COMMAND
     CLI::App * infoCommand = m_cliApp.add_subcommand("info", "Read package dependencies informations");
@@ -293,37 +309,28 @@ CmdOptions::CmdOptions()
     runCommand->add_option("--ref", m_remakenPackageRef, "Remaken application package reference i.e. name:version");
     runCommand->add_option("--app", m_applicationFile, "executable file path");
     runCommand->add_option("--name", m_applicationName, "executable file name (without any extension) - Useful only when application name differs from --ref package name");
+    runCommand->add_option("--link-libs", m_runLinkLibsMode, "gather links to every dependency shared library in a single folder and only export this folder: [symlink|hardlink]");
     runCommand->add_option("arguments", m_applicationArguments, "executable arguments");
 
     // PACKAGE COMMAND
     CLI::App * packageCommand = m_cliApp.add_subcommand("package","package a build result in remaken format");
-    packageCommand->add_option("--sourcedir,-s", m_packageOptions["sourcedir"], "product root directory (where libs and includes are located)"); // ,true);//->required();
-    packageCommand->add_option("--includedir,-i", m_packageOptions["includedir"], " relative path to include folder to export (defaults to the sourcedir provided with -s)\n");
-    packageCommand->add_option("--libdir,-l", m_packageOptions["libdir"], " relative path to the library folder to export (defaults to the sourcedir provided with -s)\n");
-    packageCommand->add_option("--redistfile,-f", m_packageOptions["redistfile"], " relative path and filename of a redistribution file to use (such as redist.txt intel ipp's file). Only listed libraries in this file will be packaged\n");
-    packageCommand->add_option("--destination,-d", m_destinationRoot, "Destination directory");//->required();
-    packageCommand->add_option("--packagename,-p", m_packageOptions["packagename"], " package name\n");
-    packageCommand->add_option("--packageversion,-k", m_packageOptions["packageversion"], " package version\n");
-    packageCommand->add_option("--ignore-mode,-n", m_packageOptions["ignoreMode"], " forces the pkg-config generated file to ignore the mode when providing -L flags\n");
-    m_mode = "shared";
-    packageCommand->add_option("--mode,-m", m_mode, "Mode: " + getOptionString("--mode")); // ,true);
-    packageCommand->add_option("--withsuffix", m_packageOptions["withsuffix"], " specify the suffix used by the thirdparty when building with mode mode\n");
-    packageCommand->add_option("--useOriginalPCfiles,-u", m_packageOptions["useOriginalPCfiles"], " specify to search and use original pkgconfig files from the thirdparty, instead of generating them\n");
-    packageCommand->fallthrough(false);
-    /*print "    -s, --sourcedir                  => product root directory (where libs and includes are located)\n");
-    print "    -o, --osname                     => specify the operating system targeted by the product build. It is one of [win|mac|linux]. (defaults to the current OS environment)\n";
-    print "    -i, --includedir                 => relative path to include folder to export (defaults to the sourcedir provided with -s)\n";
-    print "    -l, --libdir                     => relative path to the library folder to export (defaults to the sourcedir provided with -s)\n";
-    print "    -r, --redistfile                 => relative path and filename of a redistribution file to use (such as redist.txt intel ipp's file). Only listed libraries in this file will be packaged\n";
-    print "    -d, --destinationdir             => package directory root destination (where the resulting packaging will be stored)\n";
-    print "    -p, --packagename                => package name\n";
-    print "    -v, --packageversion             => package version\n";
-    print "    -n, --ignore-mode                => forces the pkg-config generated file to ignore the mode when providing -L flags\n";
-    print "    -m, --mode [debug|release]       => specify the current product build mode. Binaries will be packaged in the appropriate [mode] folder\n";
-    print "    -a, --architecture [x86_64|i386] => specify the current product build architecture. Binaries will be packaged in the appropriate [architecture] folder\n";
-    print "    -w, --withsuffix suffix          => specify the suffix used by the thirdparty when building with mode mode\n";
-    print "    -u, --useOriginalPCfiles         => specify to search and use original pkgconfig files from the thirdparty, instead of generating them\n";
-   */
+
+    // CREATE SUBCOMMAND
+    CLI::App * createCommand = packageCommand->add_subcommand("create","create a remaken package from a build output (libraries are packaged for --architecture and --config)");
+    createCommand->fallthrough(false);
+    m_packageOptions["sourcedir"] = boost::filesystem::initial_path().generic_string(utf8);
+    createCommand->add_option("--sourcedir,-s", m_packageOptions["sourcedir"], "product root directory (where libs and includes are located)");
+    createCommand->add_option("--includedir,-i", m_packageOptions["includedir"], "relative path to include folder to export (defaults to the sourcedir provided with -s)");
+    createCommand->add_option("--libdir,-l", m_packageOptions["libdir"], "relative path to the library folder to export (defaults to the sourcedir provided with -s)");
+    createCommand->add_option("--redistfile,-f", m_packageOptions["redistfile"], "relative path and filename of a redistribution file to use (such as redist.txt intel ipp's file). Only listed libraries in this file will be packaged");
+    m_packageOptions["destination"] = (boost::filesystem::initial_path() / "packages").generic_string(utf8);
+    createCommand->add_option("--destination,-d", m_packageOptions["destination"], "package root destination folder : the package is created in [destination]/[package name]/[package version]");
+    createCommand->add_option("--packagename,-p", m_packageOptions["packagename"], "package name")->required();
+    createCommand->add_option("--packageversion,-k", m_packageOptions["packageversion"], "package version")->required();
+    createCommand->add_flag("--ignore-mode,-n", m_packageIgnoreMode, "forces the pkg-config generated file to ignore the mode when providing -L flags");
+    createCommand->add_option("--withsuffix,-w", m_packageOptions["withsuffix"], "specify the suffix used by the thirdparty when building with config --config : only libraries with this suffix are packaged");
+    createCommand->add_flag("--useOriginalPCfiles,-u", m_packageUseOriginalPCfiles, "specify to search and use original pkgconfig files from the thirdparty, instead of generating them");
+    createCommand->add_option("--archive-destination,-z", m_packageOptions["archivedestination"], "also compress the created package in this folder, in the [package]/[version]/[os] remote layout");
 
     // COMPRESS SUBCOMMAND
     CLI::App * compressCommand = packageCommand->add_subcommand("compress","compress packages within a folder");
@@ -332,6 +339,13 @@ CmdOptions::CmdOptions()
     compressCommand->add_option("--rootdir,-s", m_packageCompressOptions["rootdir"], "folder path to root build toolchain folder or to parent package root folder (where the packages are located located)"); // ,true);
     compressCommand->add_option("--packagename,-p", m_packageCompressOptions["packagename"], " package name\n");
     compressCommand->add_option("--packageversion,-k", m_packageCompressOptions["packageversion"], " package version\n");
+    m_packageCompressOptions["destination"] = (boost::filesystem::initial_path() / "compressed-packages").generic_string(utf8);
+    compressCommand->add_option("--destination,-d", m_packageCompressOptions["destination"], "folder where the packages are compressed, in the [package]/[version]/[os] remote layout"); // ,true);
+
+    // VERIFY COMMAND
+    CLI::App * verifyCommand = m_cliApp.add_subcommand("verify","verify installed packages files against their install manifest");
+    verifyCommand->add_option("package", m_verifyPackageRef, "restrict verification to a package : name[:version]");
+    verifyCommand->add_flag("--repair", m_verifyRepair, "reinstall the packages with missing or modified files");
 
     // PARSE COMMAND
     CLI::App * parseCommand = m_cliApp.add_subcommand("parse","check dependency file validity");
@@ -377,6 +391,33 @@ void CmdOptions::validateOptions()
         m_isXpcfBundle = true;
     }
 
+    if ((sub->get_name() == "bundle") || (sub->get_name() == "bundleXpcf")) {
+        auto && validValues = validationMap.at("--link");
+        if (std::find(validValues.begin(), validValues.end(), m_bundleLinkMode) == validValues.end()) {
+            throw std::runtime_error("Option --link was set with invalid value " + m_bundleLinkMode);
+        }
+        if (!m_bundleArchive.empty()) {
+            fs::detail::utf8_codecvt_facet utf8;
+            std::string archiveName = fs::path(m_bundleArchive).filename().generic_string(utf8);
+            if (boost::algorithm::ends_with(archiveName, ".tar.zst")) {
+                throw std::runtime_error("Error : zstd compression is not available : use a .tar.gz or .zip bundle archive");
+            }
+            if (!boost::algorithm::ends_with(archiveName, ".tar.gz") && !boost::algorithm::ends_with(archiveName, ".tgz")
+                    && !boost::algorithm::ends_with(archiveName, ".zip")) {
+                throw std::runtime_error("Error : unsupported bundle archive " + m_bundleArchive + " : use a .tar.gz, .tgz or .zip archive");
+            }
+            if (m_incrementalBundle || m_bundleLinkMode != "copy") {
+                throw std::runtime_error("Error : --archive can't be used with --incremental or --link");
+            }
+        }
+        if (m_bundleNeededOnly && (m_os == "win" || m_os == "mac" || m_os == "ios")) {
+            throw std::runtime_error("Error : --needed-only is only available for ELF binaries (linux, unix and android)");
+        }
+        if (m_bundleNeededOnly && m_bundleTargets.empty() && !m_isXpcfBundle) {
+            throw std::runtime_error("Error : bundle --needed-only needs at least one --target file");
+        }
+    }
+
     if (sub->get_name() == "search") {
         for (auto opt : sub->get_options()) {
             auto name = opt->get_name();
@@ -431,8 +472,8 @@ CmdOptions::OptionResult CmdOptions::parseArguments(int argc, char** argv)
                 m_subcommand = sub->get_subcommands().at(0)->get_name();
                 if (!m_subcommand.empty()) {
                     m_zipTool = "7z";
-                    if (m_subcommand != "compress") {
-                        cout << "Error : package subcommand must be 'compress'. "<<m_subcommand<<" is an invalid subcommand !"<<endl;
+                    if (m_subcommand != "compress" && m_subcommand != "create") {
+                        cout << "Error : package subcommand must be 'compress' or 'create'. "<<m_subcommand<<" is an invalid subcommand !"<<endl;
                         return OptionResult::RESULT_ERROR;
                     }
                 }
@@ -495,6 +536,10 @@ CmdOptions::OptionResult CmdOptions::parseArguments(int argc, char** argv)
                 cout << "Error : providing the application name without a remaken ref is inconsistent !"<<endl;
                 return OptionResult::RESULT_ERROR;
             }
+            if (!getRunLinkLibsMode().empty() && getRunLinkLibsMode() != "symlink" && getRunLinkLibsMode() != "hardlink") {
+                cout << "Error : --link-libs must be either symlink or hardlink ! "<<getRunLinkLibsMode()<<" is an invalid value !"<<endl;
+                return OptionResult::RESULT_ERROR;
+            }
         }
         if (sub->get_name() == "info") {
             if (sub->get_subcommands().size() > 0) {
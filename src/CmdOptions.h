@@ -23,6 +23,7 @@
 #ifndef CMDOPTIONS_H
 #define CMDOPTIONS_H
 
+#include <set>
 #include <string>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
@@ -134,6 +135,14 @@ public:
         return m_verbose;
     }
 
+    const std::string & getTraceFile() const {
+        return m_traceFile;
+    }
+
+    const std::string & getStatsFile() const {
+        return m_statsFile;
+    }
+
     const std::string & getAlternateRepoType() const {
         return m_altRepoType;
     }
@@ -162,6 +171,26 @@ public:
         return m_isXpcfBundle;
     }
 
+    bool incrementalBundle() const {
+        return m_incrementalBundle;
+    }
+
+    const std::string & getBundleLinkMode() const {
+        return m_bundleLinkMode;
+    }
+
+    bool bundleNeededOnly() const {
+        return m_bundleNeededOnly;
+    }
+
+    const std::vector<std::string> & getBundleTargets() const {
+        return m_bundleTargets;
+    }
+
+    const std::string & getBundleArchive() const {
+        return m_bundleArchive;
+    }
+
     bool debugEnabled() const {
         return m_debugEnabled;
     }
@@ -182,6 +211,14 @@ public:
         return m_force;
     }
 
+    bool aggregatePaths() const {
+        return m_aggregatePaths;
+    }
+
+    bool relocatable() const {
+        return m_relocatable;
+    }
+
     bool ignoreErrors() const {
         return m_ignoreErrors;
     }
@@ -244,6 +281,15 @@ public:
         return m_projectRootPath;
     }
 
+    // names of every dependency configured for the project, whatever its type
+    void setConfiguredDependencies(const std::set<std::string> & dependencyNames) const {
+        m_configuredDependencies = dependencyNames;
+    }
+
+    const std::set<std::string> & getConfiguredDependencies() const  {
+        return m_configuredDependencies;
+    }
+
     const std::string & getRemakenPkgRef() const  {
         return m_remakenPackageRef;
     }
@@ -252,10 +298,34 @@ public:
         return m_applicationName;
     }
 
+    const std::string & getRunLinkLibsMode() const  {
+        return m_runLinkLibsMode;
+    }
+
+    const std::string & getVerifyPackageRef() const  {
+        return m_verifyPackageRef;
+    }
+
+    bool verifyRepair() const {
+        return m_verifyRepair;
+    }
+
     const std::map<std::string,std::string> & getCompressCommandOptions() const {
         return m_packageCompressOptions;
     }
 
+    const std::map<std::string,std::string> & getCreateCommandOptions() const {
+        return m_packageOptions;
+    }
+
+    bool packageIgnoreMode() const {
+        return m_packageIgnoreMode;
+    }
+
+    bool packageUseOriginalPCfiles() const {
+        return m_packageUseOriginalPCfiles;
+    }
+
     const std::map<std::string,std::string> & getSearchCommandOptions() const {
         return m_searchOptions;
     }
@@ -297,6 +367,7 @@ private:
     fs::path m_destinationRootPath;
     fs::path m_remakenRootPath;
     mutable fs::path m_projectRootPath;
+    mutable std::set<std::string> m_configuredDependencies;
     std::string m_repositoryType;
     std::string m_cppVersion;
     std::string m_toolchain;
@@ -304,7 +375,11 @@ private:
     std::string m_altRepoUrl;
     std::string m_altRepoType;
     std::string m_moduleSubfolder;
+    std::string m_bundleLinkMode = "copy";
+    std::string m_bundleArchive;
     std::map<std::string,std::string> m_packageOptions;
+    bool m_packageIgnoreMode = false;
+    bool m_packageUseOriginalPCfiles = false;
     std::map<std::string,std::string> m_packageCompressOptions;
     std::map<std::string,std::string> m_listOptions;
     std::map<std::string,std::string> m_searchOptions;
@@ -320,6 +395,11 @@ private:
     std::string m_generator = "qmake";
     std::string m_remakenPackageRef;
     std::string m_applicationName = "";
+    std::string m_runLinkLibsMode = "";
+    std::string m_verifyPackageRef = "";
+    std::string m_traceFile = "";
+    std::string m_statsFile = "";
+    bool m_verifyRepair = false;
     bool m_ignoreCache;
     bool m_invertRepositoryOrder = false;
     bool m_verbose;
@@ -329,8 +409,12 @@ private:
     bool m_environment = false;
     mutable bool m_projectMode = false;
     bool m_isXpcfBundle = false;
+    bool m_incrementalBundle = false;
+    bool m_bundleNeededOnly = false;
     bool m_cleanAll = true;
     bool m_force = false;
+    bool m_aggregatePaths = false;
+    bool m_relocatable = false;
     bool m_ignoreErrors = false;
     bool m_override = false;
     bool m_defaultProfileOptions = false;
@@ -341,6 +425,7 @@ private:
     bool m_infoDisplayPathsOption = false;
     std::vector<std::string> m_conanForceBuildRefs;
     std::vector<std::string> m_configureConditions;
+    std::vector<std::string> m_bundleTargets;
     CLI::App m_cliApp{"remaken"};
 };
 
@@ -35,9 +35,18 @@ public:
     static constexpr const char * REMAKEN_FOLDER = ".remaken";
     static constexpr const char * REMAKEN_PROFILES_FOLDER = "profiles";
     static constexpr const char * REMAKEN_CACHE_FILE = ".remaken-cache";
+    static constexpr const char * REMAKEN_RUNENV_CACHE_FOLDER = ".runenv-cache";
+    static constexpr const char * REMAKEN_DEPS_CACHE_FOLDER = ".deps-cache";
+    static constexpr const char * REMAKEN_STAGING_FOLDER = ".staging";
+    static constexpr const char * REMAKEN_LOCKS_FOLDER = ".locks";
+    static constexpr const char * REMAKEN_AGGREGATED_INCLUDE_FOLDER = "include";
+    static constexpr const char * REMAKEN_AGGREGATED_LIB_FOLDER = "lib";
+    static constexpr const char * REMAKEN_ROOT_FILE = "remaken_root";
     static constexpr const char * ARTIFACTORY_API_KEY = "artifactoryApiKey";
     static constexpr const char * QMAKE_RULES_DEFAULT_TAG = "4.10.0";
     static constexpr const char * PKGINFO_FOLDER = ".pkginfo";
+    static constexpr const char * PKGMANIFEST_FILE = ".pkgmanifest";
+    static constexpr const char * BUNDLE_MANIFEST_FILE = ".bundlemanifest";
     static constexpr const char * VCPKG_REPOURL = "https://github.com/microsoft/vcpkg";
     static constexpr const char * EXTRA_DEPS = "extra-packages.txt";
     static constexpr const char * REMAKEN_BUILD_RULES_FOLDER = ".build-rules";
@@ -1,6 +1,7 @@
 #include "Dependency.h"
 #include "tools/SystemTools.h"
 #include "Constants.h"
+#include "utils/DependencyFileParser.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/log/trivial.hpp>
 
@@ -49,15 +50,22 @@ Dependency::Type deduceType(const std::string typeStr)
     return Dependency::Type::REMAKEN;
 }
 
-std::string stripEndlineChar(const std::string & str)
+std::string_view stripEndlineChar(const std::string_view & str)
 {
-    std::string strippedStr = str;
-    if (!strippedStr.empty() && strippedStr[strippedStr.size() - 1] == '\r') {
-        strippedStr.erase(strippedStr.size() - 1);
+    std::string_view strippedStr = str;
+    if (!strippedStr.empty() && strippedStr.back() == '\r') {
+        strippedStr.remove_suffix(1);
     }
     return strippedStr;
 }
 
+static std::vector<std::string_view> splitFields(const std::string & rawFormat)
+{
+    std::vector<std::string_view> fields;
+    DependencyFileParser::split(rawFormat, '|', fields);
+    return fields;
+}
+
 static const std::map<std::string,std::string> identifier2repoType = {
     {"bcomBuild","artifactory"},
     {"thirdParties","artifactory"},
@@ -122,19 +130,17 @@ bool Dependency::needsPriviledgeElevation() const
     return false;
 }
 
-std::string Dependency::parseConditions(const std::string & token)
+std::string_view Dependency::parseConditions(const std::string_view & token)
 {
-    std::vector<std::string> conditions;
-    std::string firstPart;
-    boost::split(conditions, token, [](char c){return c == '%';});
-    firstPart = conditions[0];
+    std::vector<std::string_view> conditions;
+    DependencyFileParser::split(token, '%', conditions);
     if (conditions.size() >= 2) {
         m_bHasConditions = true;
         for (uint32_t i = 1 ; i< conditions.size() ; i++) {
-            m_buildConditions.push_back(conditions[i]);
+            m_buildConditions.push_back(std::string(conditions[i]));
         }
     }
-    return firstPart;
+    return conditions[0];
 }
 
 Dependency::Dependency(const CmdOptions & options, const std::string & pkgName, const std::string & name, const std::string & version, Type type)
@@ -152,36 +158,32 @@ Dependency::Dependency(const CmdOptions & options, const std::string & pkgName,
 }
 
 
-Dependency::Dependency(const std::string & rawFormat, const std::string & mainMode):m_packageChannel("stable"),m_repositoryType("github")
+Dependency::Dependency(const std::string & rawFormat, const std::string & mainMode):Dependency(splitFields(rawFormat), mainMode)
 {
-    std::vector<std::string> results, pkgInformations, repositoryInformations, conditions;
-    boost::split(results, rawFormat, [](char c){return c == '|';});
-    boost::split(pkgInformations, results[0], [](char c){return c == '#';});
-    boost::split(repositoryInformations, results[3], [](char c){return c == '@';});
+}
 
+Dependency::Dependency(const std::vector<std::string_view> & results, const std::string & mainMode):m_packageChannel("stable"),m_repositoryType("github")
+{
+    std::vector<std::string_view> pkgInformations, repositoryInformations;
+    DependencyFileParser::split(results[0], '#', pkgInformations);
+    DependencyFileParser::split(results[3], '@', repositoryInformations);
 
     if (pkgInformations.size() >= 2) {
         m_packageName = pkgInformations[0];
-        m_packageChannel = parseConditions(pkgInformations[1]);
-        boost::trim(m_packageChannel);
+        m_packageChannel = DependencyFileParser::trim(parseConditions(pkgInformations[1]));
     }
     else {
-        m_packageName = parseConditions(pkgInformations[0]);
-        boost::trim(m_packageName);
+        m_packageName = DependencyFileParser::trim(parseConditions(pkgInformations[0]));
     }
-    m_version = results[1];
-    boost::trim(m_version);
-    m_name = parseConditions(results[2]);
-    boost::trim(m_name);
-    m_identifier = repositoryInformations[0];
-    boost::trim(m_identifier);
+    m_version = DependencyFileParser::trim(results[1]);
+    m_name = DependencyFileParser::trim(parseConditions(results[2]));
+    m_identifier = DependencyFileParser::trim(repositoryInformations[0]);
     m_repositoryType = m_identifier;
     if (identifier2repoType.find(m_identifier) != identifier2repoType.end()) {
         m_repositoryType = identifier2repoType.at(m_identifier);
     } // should lead to an error when no transcription exists ? in validate ??
     if (repositoryInformations.size() >= 2) {
-        m_repositoryType = repositoryInformations[1];
-        boost::trim(m_repositoryType);
+        m_repositoryType = DependencyFileParser::trim(repositoryInformations[1]);
         m_bHasIdentifier = !m_identifier.empty();
     }
     m_type = deduceType(m_repositoryType);
@@ -200,8 +202,7 @@ Dependency::Dependency(const std::string & rawFormat, const std::string & mainMo
         }
     }
     else {
-        m_baseRepository = stripEndlineChar(results[4]);
-        boost::trim(m_baseRepository);
+        m_baseRepository = DependencyFileParser::trim(stripEndlineChar(results[4]));
         if ((m_baseRepository.empty()) &&
             ((m_repositoryType == "conan") ||
             (m_repositoryType == "system") ||
@@ -210,7 +211,7 @@ Dependency::Dependency(const std::string & rawFormat, const std::string & mainMo
         }
     }
 
-    if (m_baseRepository.find("https://github") != std::string::npos) {// github url
+    if (m_baseRepository.str().find("https://github") != std::string::npos) {// github url
         if ((m_repositoryType == "artifactory") &&
                 ((m_identifier == "bcomBuild") ||
                 (m_identifier == "thirdParties"))) { // erroneous deduction : repository type maybe a github repository
@@ -219,8 +220,7 @@ Dependency::Dependency(const std::string & rawFormat, const std::string & mainMo
     }
 
     if (results.size() >= 6){
-        m_mode = stripEndlineChar(results[5]);
-        boost::trim(m_mode);
+        m_mode = DependencyFileParser::trim(stripEndlineChar(results[5]));
         if ((m_mode!= "static" && m_mode!= "shared" && m_mode!= "na") ||  (m_mode == "default")){
             std::cout << "[WARNING]: Current mode '" << m_mode << "' is unsupported for '"<< m_name << "' dependency, then apply '" << mainMode << "'default mode" << std::endl;
             m_mode = mainMode;
@@ -233,7 +233,7 @@ Dependency::Dependency(const std::string & rawFormat, const std::string & mainMo
         }*/
     }
     if (results.size() == 7){
-        m_toolOptions = stripEndlineChar(results[6]);
+        m_toolOptions = std::string(stripEndlineChar(results[6]));
         if (!m_toolOptions.empty()) {
             m_bHasOptions = true;
         }
@@ -241,6 +241,38 @@ Dependency::Dependency(const std::string & rawFormat, const std::string & mainMo
     m_originalBaseRepository = m_baseRepository;
 }
 
+Dependency::Dependency(const Fields & fields):m_packageName(fields.packageName),m_packageChannel(fields.channel),m_name(fields.name),
+    m_version(fields.version),m_baseRepository(fields.baseRepository),m_originalBaseRepository(fields.baseRepository),
+    m_identifier(fields.identifier),m_repositoryType(fields.repositoryType),m_mode(fields.mode),m_toolOptions(fields.toolOptions),
+    m_type(fields.type),m_bHasOptions(!fields.toolOptions.empty()),m_bHasConditions(!fields.conditions.empty()),m_bHasIdentifier(fields.hasIdentifier)
+{
+    m_buildConditions.reserve(fields.conditions.size());
+    for (auto & condition : fields.conditions) {
+        m_buildConditions.push_back(std::string(condition));
+    }
+}
+
+Dependency::Fields Dependency::fields() const
+{
+    Fields fields;
+    fields.packageName = m_packageName.str();
+    fields.channel = m_packageChannel.str();
+    fields.name = m_name.str();
+    fields.version = m_version.str();
+    fields.baseRepository = m_originalBaseRepository.str();
+    fields.identifier = m_identifier.str();
+    fields.repositoryType = m_repositoryType.str();
+    fields.mode = m_mode.str();
+    fields.toolOptions = m_toolOptions;
+    fields.conditions.assign(m_buildConditions.begin(), m_buildConditions.end());
+    fields.type = m_type;
+    fields.hasIdentifier = m_bHasIdentifier;
+    return fields;
+}
+
+// dependency line fields checked by validate()
+static constexpr int REPOSITORY_FIELD = 3;
+static constexpr int MODE_FIELD = 5;
 
 static const std::vector<std::string> repoValidation = {"artifactory","github","nexus","path","vcpkg","conan","system","http"};
 static const std::vector<std::string> linkModeValidation = {"static","shared","default","na"};
@@ -248,10 +280,15 @@ static const std::map<std::string,std::vector<std::string>> unsupportedLinkModeR
 static const std::vector<std::string> systemIdentifierMap = {"system","apt-get","brew","yum","choco","scoop","pkg", "pkgutil", "pacman", "zypper"};
 
 bool Dependency::validate() const
+{
+    return invalidField() < 0;
+}
+
+int Dependency::invalidField() const
 {
     if (find(repoValidation,m_repositoryType) == std::end(repoValidation)) {
         BOOST_LOG_TRIVIAL(error)<<"Dependency file error : invalid repository type : unsupported value= "<< m_repositoryType<<std::endl<<log(*this);
-        return false;
+        return REPOSITORY_FIELD;
     }
 
     if (m_baseRepository.empty()) {
@@ -261,28 +298,28 @@ bool Dependency::validate() const
     if (m_repositoryType == "system") {
         if (find(systemIdentifierMap,m_identifier) == std::end(systemIdentifierMap)) {
             BOOST_LOG_TRIVIAL(error)<<"Dependency file error : invalid tool identifier  value= "<<m_identifier<<" for "<< m_repositoryType<<" repository"<<std::endl<<log(*this);
-            return false;
+            return REPOSITORY_FIELD;
         }
     }
     else {
         if (find(systemIdentifierMap,m_identifier) != std::end(systemIdentifierMap)) {
             BOOST_LOG_TRIVIAL(error)<<"Dependency file error : invalid identifier value= "<<m_identifier<<" for "<< m_repositoryType<<" repository"<<std::endl<<log(*this);
-            return false;
+            return REPOSITORY_FIELD;
         }
     }
     if (find(linkModeValidation,m_mode) == std::end(linkModeValidation)) {
         BOOST_LOG_TRIVIAL(error)<<"Dependency file error : invalid link mode value= "<<m_mode<<std::endl<<log(*this);
-        return false;
+        return MODE_FIELD;
     }
     for (auto & element:unsupportedLinkModeRelations) {
         if (m_mode == element.first) {
             auto & unsupportedRepolist = element.second;
             if (find(unsupportedRepolist,m_repositoryType) != std::end(unsupportedRepolist)) {
                 BOOST_LOG_TRIVIAL(error)<<"Dependency file error : invalid link mode= "<<m_mode<<" for "<< m_repositoryType<<" repository"<<std::endl<<log(*this);
-                return false;
+                return MODE_FIELD;
             }
         }
     }
-    return true;
+    return -1;
 }
 
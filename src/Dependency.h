@@ -24,9 +24,11 @@
 #define DEPENDENCY_H
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include "CmdOptions.h"
+#include "utils/InternedString.h"
 
 class Dependency
 {
@@ -42,7 +44,27 @@ public:
         SYSTEM
     };
 
+    // already tokenized and resolved fields of a parsed dependency (see DependencyFileCache)
+    struct Fields {
+        std::string_view packageName;
+        std::string_view channel;
+        std::string_view name;
+        std::string_view version;
+        std::string_view baseRepository;
+        std::string_view identifier;
+        std::string_view repositoryType;
+        std::string_view mode;
+        std::string_view toolOptions;
+        std::vector<std::string_view> conditions;
+        Type type = Type::REMAKEN;
+        bool hasIdentifier = false;
+    };
+
     explicit Dependency(const std::string & rawFormat, const std::string & mainMode);
+    // fields are the '|' separated tokens of a dependency line (at least 4 fields)
+    Dependency(const std::vector<std::string_view> & fields, const std::string & mainMode);
+    // rebuilds a parsed dependency without tokenizing
+    explicit Dependency(const Fields & fields);
     Dependency(const CmdOptions & options, const std::string & pkgName, const std::string & name, const std::string & version = "1.0.0", Type type = Type::SYSTEM);
     Dependency(const CmdOptions & options, const std::string & pkgName, const std::string & version = "1.0.0", Type type = Type::SYSTEM);
     // Dependency(Dependency && dependency) = default;
@@ -154,11 +176,16 @@ public:
     }
 
 
+    // views on the dependency fields, valid while the dependency lives
+    Fields fields() const;
+
     bool isSystemDependency() const;
     bool isSpecificSystemToolDependency() const;
     bool isGenericSystemDependency() const;
     bool needsPriviledgeElevation() const;
     bool validate() const;
+    // index of the dependency line field rejected by validate() (3 : identifier@repository type, 5 : link mode), -1 when valid
+    int invalidField() const;
 
     friend std::ostream& operator<< (std::ostream& stream, const Dependency& dep);
     std::string toString() const;
@@ -166,16 +193,17 @@ public:
     bool operator==(const Dependency& dep) const;
 
 private:
-    std::string parseConditions(const std::string & token);
-    std::string m_packageName;
-    std::string m_packageChannel;
-    std::string m_name;
-    std::string m_version;
-    std::string m_baseRepository;
-    std::string m_originalBaseRepository;
-    std::string m_identifier;
-    std::string m_repositoryType;
-    std::string m_mode;
+    std::string_view parseConditions(const std::string_view & token);
+    // low cardinality fields are interned : copying a dependency doesn't copy them
+    InternedString m_packageName;
+    InternedString m_packageChannel;
+    InternedString m_name;
+    InternedString m_version;
+    InternedString m_baseRepository;
+    InternedString m_originalBaseRepository;
+    InternedString m_identifier;
+    InternedString m_repositoryType;
+    InternedString m_mode;
     std::string m_toolOptions;
     std::vector<std::string> m_buildConditions;
     std::vector<std::string> m_cflags;
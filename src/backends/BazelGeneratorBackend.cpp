@@ -20,8 +20,11 @@
  * @date 2019-11-15
  */
 #include "backends/BazelGeneratorBackend.h"
+#include "managers/AggregatedPathsManager.h"
 #include "utils/OsUtils.h"
 #include <regex>
+#include <set>
+#include <sstream>
 
 static const std::map<Dependency::Type,std::string> type2prefixMap = {
     {Dependency::Type::BREW,"BREW"},
@@ -34,10 +37,8 @@ static const std::map<Dependency::Type,std::string> type2prefixMap = {
 };
 
 BazelGeneratorBackend::BazelGeneratorBackend(const CmdOptions & options):AbstractGeneratorBackend(options,".bzl") {
-    fs::detail::utf8_codecvt_facet utf8;
     fs::path filePath = DepUtils::getProjectBuildSubFolder(m_options)/"BUILD";
-    std::ofstream buildFile(filePath.generic_string(utf8),std::ios::out);
-    buildFile.close();
+    OsUtils::writeFileIfChanged(filePath, "");
 }
 
 std::string getValidName(const std::string & originalName)
@@ -49,6 +50,25 @@ std::string getValidName(const std::string & originalName)
     return validName;
 }
 
+// direct dependencies declared by the dependency package
+std::vector<std::string> BazelGeneratorBackend::childrenPkgNames(const Dependency & dep) const
+{
+    std::vector<std::string> children;
+    if (dep.prefix().empty()) {
+        return children;
+    }
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string filePrefix = (dep.getMode() == "shared") ? "packagedependencies" : "packagedependencies-static";
+    for (auto & depsFile : DepUtils::getChildrenDependencies(fs::path(dep.prefix(), utf8), m_options.getOS(), filePrefix)) {
+        if (fs::exists(depsFile)) {
+            for (auto & child : DepUtils::parse(depsFile, dep.getMode())) {
+                children.push_back(getValidName(child.getName()));
+            }
+        }
+    }
+    return children;
+}
+
 std::pair<std::string, fs::path> BazelGeneratorBackend::generate(const std::vector<Dependency> & deps, Dependency::Type depType)
 {
     fs::detail::utf8_codecvt_facet utf8;
@@ -58,14 +78,48 @@ std::pair<std::string, fs::path> BazelGeneratorBackend::generate(const std::vect
     std::string prefix = type2prefixMap.at(depType);
     std::string filename = boost::to_lower_copy(prefix) + getGeneratorFileName("buildinfo");
     fs::path filePath = DepUtils::getProjectBuildSubFolder(m_options)/filename;
-    std::ofstream fos(filePath.generic_string(utf8),std::ios::out);
+    std::ostringstream fos;
     std::string defines;
     std::vector<std::string> setupFuncVect;
+    std::set<std::string> setupFiles;
+    AggregatedPathsManager aggregatedPaths(m_options);
+    std::string buildSubFolderLabel = "//" + DepUtils::getBuildSubFolder(m_options).generic_string(utf8);
+    if (m_options.relocatable()) {
+        writeRootFile();
+    }
+    // starlark expression of a path : relocatable mode expresses remaken root paths from REMAKEN_ROOT,
+    // and aggregated folders from the project build folder location
+    auto bazelPath = [&](const std::string & pathStr) -> std::string {
+        std::string relativePath = relocatePath(pathStr, m_options.getRemakenRoot(), "");
+        if (relativePath != pathStr) {
+            return relativePath.empty() ? "REMAKEN_ROOT" : "REMAKEN_ROOT + \"" + relativePath + "\"";
+        }
+        relativePath = relocatePath(pathStr, DepUtils::getProjectBuildSubFolder(m_options), "");
+        if (relativePath != pathStr) {
+            return "str(ctx.path(Label(\"" + buildSubFolderLabel + ":BUILD\")).dirname) + \"" + relativePath + "\"";
+        }
+        return "\"" + pathStr + "\"";
+    };
+    // every configured dependency of the project has its own repository, whatever its type file : deps edges are only emitted towards them
+    std::set<std::string> configuredPkgNames;
+    for (auto & depName : m_options.getConfiguredDependencies()) {
+        configuredPkgNames.insert(getValidName(depName));
+    }
+    for (auto & dep : deps) {
+        configuredPkgNames.insert(getValidName(dep.getName()));
+    }
+    // one file per dependency : bazel only re-evaluates repository rules of the dependencies that changed
     for (auto dep : deps ) {
         std::string bazelPkgName = getValidName(dep.getName());
+        bool includeRootUsed = false, libRootUsed = false;
+        std::ostringstream depStream;
+        if (m_options.relocatable()) {
+            depStream<<"load(\""<<buildSubFolderLabel<<":"<<getGeneratorFileName(Constants::REMAKEN_ROOT_FILE)<<"\", \"REMAKEN_ROOT\")"<<std::endl;
+            depStream<<std::endl;
+        }
 
         std::map<std::string,bool> incPaths, defines;
-        std::vector<std::string> libsVect;
+        std::vector<std::string> libsVect, libNames;
         for (auto & cflagInfos : dep.cflags()) {
             std::vector<std::string> cflagsVect;
             boost::split_regex(cflagsVect, cflagInfos, boost::regex( " -" ));
@@ -78,6 +132,10 @@ std::pair<std::string, fs::path> BazelGeneratorBackend::generate(const std::vect
                     // remove -I
                     cflag.erase(0,1);
                     boost::trim(cflag);
+                    if (m_options.aggregatePaths() && aggregatedPaths.addIncludePath(fs::path(cflag, utf8))) {
+                        includeRootUsed = true;
+                        continue;
+                    }
                     fs::path incPath = OsUtils::extractPath(dep.prefix(),cflag);
                     fs::path symlinkFolder(bazelPkgName, utf8);
                     if (!mapContains(incPaths,(symlinkFolder/incPath).generic_string(utf8))) {
@@ -106,7 +164,10 @@ std::pair<std::string, fs::path> BazelGeneratorBackend::generate(const std::vect
                     option.erase(0,1);
                     dep.libdirs().push_back(option);
                 }
-                //TODO : extract lib paths from libdefs and put quotes around libs path
+                else if (optionPrefix == "l") {
+                    boost::trim(option);
+                    libNames.push_back(option.substr(1));
+                }
                 else {
                     boost::trim(option);
                     libsVect.push_back(option);
@@ -114,85 +175,169 @@ std::pair<std::string, fs::path> BazelGeneratorBackend::generate(const std::vect
             }
         }
 
-        fos<<"def _setup_"<<bazelPkgName<<"_impl(ctx):"<<std::endl;
-        fos<<"    "<< bazelPkgName<<"_root = \""<<dep.prefix()<<"\""<<std::endl;
-        fos<<std::endl;
-        fos<<"    ctx.symlink("<<bazelPkgName<<"_root, \""<<bazelPkgName<<"\")"<<std::endl;
-        fos<<"    ctx.file(\"BUILD\", \"\"\""<<std::endl;
-        fos<<"cc_library("<<std::endl;
-        fos<<"    name = \""<<bazelPkgName<<"\","<<std::endl;
-        fos<<"    hdrs = glob([";
+        // libraries located in the dependency folder are imported as cc_import targets : bazel tracks them as inputs
+        std::vector<std::pair<std::string,std::string>> importedLibs;
+        for (auto & libName : libNames) {
+            fs::path libPath = resolveLibrary(libName, dep.libdirs());
+            fs::path relativeLibPath = OsUtils::extractPath(dep.prefix(), libPath);
+            if (m_options.getOS() == "win" || libPath.empty() || relativeLibPath.is_absolute()) {
+                libsVect.push_back("l" + libName);
+                continue;
+            }
+            importedLibs.push_back({libName, (fs::path(bazelPkgName, utf8)/relativeLibPath).generic_string(utf8)});
+        }
+
+        depStream<<"def _setup_"<<bazelPkgName<<"_impl(ctx):"<<std::endl;
+        depStream<<"    "<< bazelPkgName<<"_root = "<<bazelPath(dep.prefix())<<std::endl;
+        depStream<<std::endl;
+        depStream<<"    ctx.symlink("<<bazelPkgName<<"_root, \""<<bazelPkgName<<"\")"<<std::endl;
+        std::vector<std::string> libFolders;
+        for (auto & libFolder : dep.libdirs()) {
+            if (m_options.aggregatePaths() && aggregatedPaths.addLibPath(fs::path(libFolder, utf8))) {
+                libRootUsed = true;
+                continue;
+            }
+            fs::path libPath = OsUtils::extractPath(dep.prefix(),libFolder);
+            fs::path symlinkFolder(bazelPkgName, utf8);
+            libFolders.push_back((symlinkFolder/libPath).generic_string(utf8));
+        }
+        if (includeRootUsed) {
+            depStream<<"    ctx.symlink("<<bazelPath(aggregatedPaths.includeRoot().generic_string(utf8))<<", \"remaken_include\")"<<std::endl;
+            incPaths.insert({"remaken_include",true});
+        }
+        if (libRootUsed) {
+            depStream<<"    ctx.symlink("<<bazelPath(aggregatedPaths.libRoot().generic_string(utf8))<<", \"remaken_lib\")"<<std::endl;
+            libFolders.insert(libFolders.begin(), "remaken_lib");
+        }
+        depStream<<"    ctx.file(\"BUILD\", \"\"\""<<std::endl;
+        for (auto & [libName, libPath] : importedLibs) {
+            bool isStaticLib = OsUtils::hasLibrarySuffix(fs::path(libPath, utf8), OsUtils::staticSuffix(m_options.getOS()));
+            depStream<<"cc_import("<<std::endl;
+            depStream<<"    name = \""<<bazelPkgName<<"_"<<libName<<"\","<<std::endl;
+            depStream<<"    "<<(isStaticLib ? "static_library" : "shared_library")<<" = \""<<libPath<<"\","<<std::endl;
+            depStream<<")"<<std::endl;
+            depStream<<std::endl;
+        }
+        depStream<<"cc_library("<<std::endl;
+        depStream<<"    name = \""<<bazelPkgName<<"\","<<std::endl;
+        depStream<<"    hdrs = glob([";
         bool start = true;
         for (auto & [incP,b] : incPaths) {
             if (!start) {
-                fos<<", ";
+                depStream<<", ";
             }
-            fos<<"\""<<incP<<"/**/*.h\", \""<<incP<<"/**/*.hpp\", \""<<incP<<"/**/*.ipp\"";
+            depStream<<"\""<<incP<<"/**/*.h\", \""<<incP<<"/**/*.hpp\", \""<<incP<<"/**/*.ipp\"";
             start = false;
         }
-        fos<<"]),"<<std::endl;
+        depStream<<"]),"<<std::endl;
         start = true;
-        fos<<"    includes = [";
+        depStream<<"    includes = [";
         for (auto & [incP,b]: incPaths) {
             if (!start) {
-                fos<<", ";
+                depStream<<", ";
             }
-            fos<<"\""<<incP<<"\"";
+            depStream<<"\""<<incP<<"\"";
             start = false;
         }
-        fos<<"],"<<std::endl;
+        depStream<<"],"<<std::endl;
         start = true;
-        fos<<"    defines = [";
+        depStream<<"    defines = [";
         for (auto & [def,b] : defines) {
             if (!start) {
-                fos<<", ";
+                depStream<<", ";
             }
             std::string define = boost::replace_all_copy(def,"\"","\\\"");
-            fos<<"\""<<define<<"\"";
+            depStream<<"\""<<define<<"\"";
             start = false;
         }
-        fos<<"],"<<std::endl;
-        fos<<"    visibility = [\"//visibility:public\"],"<<std::endl;
-        fos<<"    linkopts = ["<<std::endl;
-        fos<<"        \"-Wl,--start-group\","<<std::endl;
-        for (auto & libFolder : dep.libdirs()) {
-            fs::path libPath = OsUtils::extractPath(dep.prefix(),libFolder);
-            fs::path symlinkFolder(bazelPkgName, utf8);
-            fos<<"        \"-L"<<(symlinkFolder/libPath).generic_string(utf8)<<"\","<<std::endl;
+        depStream<<"],"<<std::endl;
+        depStream<<"    deps = [";
+        start = true;
+        for (auto & [libName, libPath] : importedLibs) {
+            if (!start) {
+                depStream<<", ";
+            }
+            depStream<<"\":"<<bazelPkgName<<"_"<<libName<<"\"";
+            start = false;
+        }
+        for (auto & child : childrenPkgNames(dep)) {
+            if (child != bazelPkgName && configuredPkgNames.find(child) != configuredPkgNames.end()) {
+                if (!start) {
+                    depStream<<", ";
+                }
+                depStream<<"\"@"<<child<<"//:"<<child<<"\"";
+                start = false;
+            }
+        }
+        depStream<<"],"<<std::endl;
+        depStream<<"    visibility = [\"//visibility:public\"],"<<std::endl;
+        depStream<<"    linkopts = ["<<std::endl;
+        depStream<<"        \"-Wl,--start-group\","<<std::endl;
+        for (auto & libFolder : libFolders) {
+            depStream<<"        \"-L"<<libFolder<<"\","<<std::endl;
         }
         for (auto & lib : libsVect) {
-            fos<<"        \"-"<<lib<<"\","<<std::endl;
+            depStream<<"        \"-"<<lib<<"\","<<std::endl;
         }
-        fos<<"        \"-Wl,--end-group\"],"<<std::endl;
-        fos<<")"<<std::endl;
-        fos<<"\"\"\")"<<std::endl;
-        fos<<std::endl;
-        fos<<"_setup_"<<bazelPkgName<<" = repository_rule("<<std::endl;
-        fos<<"    implementation = _setup_"<<bazelPkgName<<"_impl"<<std::endl;
-        fos<<")"<<std::endl;
-        fos<<std::endl;
+        depStream<<"        \"-Wl,--end-group\"],"<<std::endl;
+        depStream<<")"<<std::endl;
+        depStream<<"\"\"\")"<<std::endl;
+        depStream<<std::endl;
+        depStream<<"_setup_"<<bazelPkgName<<" = repository_rule("<<std::endl;
+        depStream<<"    implementation = _setup_"<<bazelPkgName<<"_impl"<<std::endl;
+        depStream<<")"<<std::endl;
+        depStream<<std::endl;
+        depStream<<"def setup_"<<bazelPkgName<<"():"<<std::endl;
+        depStream<<"    print(\"--> Setup "<<dep.getName()<<" dependency\")"<<std::endl;
+        depStream<<"    _setup_"<<bazelPkgName<<"(name = \""<<bazelPkgName<<"\")"<<std::endl;
+
+        std::string depFilename = boost::to_lower_copy(prefix) + "_" + bazelPkgName + getGeneratorFileName("_setup");
+        OsUtils::writeFileIfChanged(DepUtils::getProjectBuildSubFolder(m_options)/depFilename, depStream.str());
+        setupFiles.insert(depFilename);
+        fos<<"load(\""<<buildSubFolderLabel<<":"<<depFilename<<"\", \"setup_"<<bazelPkgName<<"\")"<<std::endl;
         setupFuncVect.push_back("setup_"+ bazelPkgName + "()");
-        fos<<"def setup_"<<bazelPkgName<<"():"<<std::endl;
-        fos<<"    print(\"--> Setup "<<dep.getName()<<" dependency\")"<<std::endl;
-        fos<<"    _setup_"<<bazelPkgName<<"(name = \""<<bazelPkgName<<"\")"<<std::endl;
-        fos<<std::endl;
     }
+    fos<<std::endl;
     std::string setupFunc = "setup_" + boost::to_lower_copy(prefix) + "_deps";
     fos<<"def "<<setupFunc<<"():"<<std::endl;
     fos<<"    print(\"--> Setup "<<boost::to_lower_copy(prefix)<<" dependencies\")"<<std::endl;
     for (auto & setupFunc : setupFuncVect) {
         fos<<"    "<<setupFunc<<std::endl;
     }
-    fos.close();
+    OsUtils::writeFileIfChanged(filePath, fos.str());
+    removeObsoleteSetupFiles(boost::to_lower_copy(prefix), setupFiles);
     return {setupFunc,filePath};
 }
 
+void BazelGeneratorBackend::removeObsoleteSetupFiles(const std::string & typePrefix, const std::set<std::string> & setupFiles)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // [type]_[name]_setup files of dependencies no more used by the project would remain loadable
+    std::string setupSuffix = getGeneratorFileName("_setup");
+    for (fs::directory_entry& x : fs::directory_iterator(DepUtils::getProjectBuildSubFolder(m_options))) {
+        std::string fileName = x.path().filename().generic_string(utf8);
+        if (fs::is_regular_file(x.path()) && boost::algorithm::starts_with(fileName, typePrefix + "_")
+                && boost::algorithm::ends_with(fileName, setupSuffix) && setupFiles.find(fileName) == setupFiles.end()) {
+            m_options.verboseMessage("===> removing obsolete file " + x.path().generic_string(utf8));
+            fs::remove(x.path());
+        }
+    }
+}
+
+void BazelGeneratorBackend::writeRootFile()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // the only machine specific file in relocatable mode
+    fs::path rootFilePath = DepUtils::getProjectBuildSubFolder(m_options) / getGeneratorFileName(Constants::REMAKEN_ROOT_FILE);
+    OsUtils::writeFileIfChanged(rootFilePath, "REMAKEN_ROOT = \"" + m_options.getRemakenRoot().generic_string(utf8) + "\"\n");
+}
+
 void BazelGeneratorBackend::generateIndex(std::map<std::string,fs::path> setupInfos)
 {
     fs::detail::utf8_codecvt_facet utf8;
     fs::path buildProjectSubFolderPath = DepUtils::getProjectBuildSubFolder(m_options);
     fs::path depsInfoFilePath = buildProjectSubFolderPath / getGeneratorFileName("dependenciesBuildInfo"); // extension should later depend on generator type
-    std::ofstream depsOstream(depsInfoFilePath.generic_string(utf8),std::ios::out);
+    std::ostringstream depsOstream;
 
     fs::path  buildSubFolderPath = DepUtils::getBuildSubFolder(m_options);
     for (auto & kv : setupInfos) {
@@ -207,7 +352,7 @@ void BazelGeneratorBackend::generateIndex(std::map<std::string,fs::path> setupIn
     for (auto & kv : setupInfos) {
         depsOstream<<"    "<<kv.first<<"()"<<std::endl;
     }
-    depsOstream.close();
+    OsUtils::writeFileIfChanged(depsInfoFilePath, depsOstream.str());
 }
 
 void BazelGeneratorBackend::generateConfigureConditionsFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps)
@@ -215,18 +360,14 @@ void BazelGeneratorBackend::generateConfigureConditionsFile(const fs::path &  ro
     fs::detail::utf8_codecvt_facet utf8;
     fs::path buildFolderPath = rootFolderPath/DepUtils::getBuildPlatformFolder(m_options);
     fs::path configureFilePath = buildFolderPath / getGeneratorFileName("configure_conditions");
-    if (fs::exists(configureFilePath) ) {
-        fs::remove(configureFilePath);
-    }
-
     if (deps.empty()) {
+        if (fs::exists(configureFilePath) ) {
+            fs::remove(configureFilePath);
+        }
         return;
     }
 
-    if (!fs::exists(buildFolderPath)) {
-        fs::create_directories(buildFolderPath);
-    }
-    std::ofstream configureFile(configureFilePath.generic_string(utf8).c_str(), std::ios::out);
+    std::ostringstream configureFile;
     configureFile << "REMAKENDEFINES = [";
     bool start = true;
     for (auto & dep : deps) {
@@ -240,7 +381,7 @@ void BazelGeneratorBackend::generateConfigureConditionsFile(const fs::path &  ro
         }
     }
     configureFile << "]\n";
-    configureFile.close();
+    OsUtils::writeFileIfChanged(configureFilePath, configureFile.str());
 }
 
 void BazelGeneratorBackend::parseConditionsFile(const fs::path &  rootFolderPath, std::map<std::string,bool> & conditionsMap)
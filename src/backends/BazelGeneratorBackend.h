@@ -23,6 +23,7 @@
 #ifndef BAZELGENERATORBACKEND_H
 #define BAZELGENERATORBACKEND_H
 #include "backends/IGeneratorBackend.h"
+#include <set>
 
 class BazelGeneratorBackend : virtual public AbstractGeneratorBackend
 {
@@ -33,6 +34,11 @@ public:
     void generateIndex(std::map<std::string,fs::path> setupInfos) override;
     void generateConfigureConditionsFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps) override;
     void parseConditionsFile(const fs::path &  rootFolderPath, std::map<std::string,bool> & conditionsMap) override;
+
+private:
+    void writeRootFile();
+    void removeObsoleteSetupFiles(const std::string & typePrefix, const std::set<std::string> & setupFiles);
+    std::vector<std::string> childrenPkgNames(const Dependency & dep) const;
 };
 
 #endif // BAZELGENERATORBACKEND_H
@@ -21,26 +21,252 @@
  */
 
 #include "backends/CMakeGeneratorBackend.h"
+#include "utils/OsUtils.h"
+#include <fstream>
+#include <ios>
+#include <sstream>
 
-#include <boost/log/trivial.hpp>
+static const std::map<Dependency::Type,std::string> type2prefixMap = {
+    {Dependency::Type::BREW,"BREW"},
+    {Dependency::Type::REMAKEN,"REMAKEN"},
+    {Dependency::Type::CONAN,"CONAN"},
+    {Dependency::Type::CHOCO,"CHOCO"},
+    {Dependency::Type::SYSTEM,"SYSTEM"},
+    {Dependency::Type::SCOOP,"SCOOP"},
+    {Dependency::Type::VCPKG,"VCPKG"}
+};
 
-std::pair<std::string, fs::path> CMakeGeneratorBackend::generate([[maybe_unused]] const std::vector<Dependency> & deps, [[maybe_unused]] Dependency::Type depType)
+static std::string cmakeEscape(const std::string & value)
 {
-    BOOST_LOG_TRIVIAL(warning)<<"CMakeGeneratorBackend::generate NOT IMPLEMENTED";
-    return {"",fs::path()};
+    std::string escapedValue;
+    for (char c : value) {
+        if (c == '"' || c == '\\' || c == '$' || c == ';') {
+            escapedValue += '\\';
+        }
+        escapedValue += c;
+    }
+    return escapedValue;
 }
 
-void CMakeGeneratorBackend::generateIndex([[maybe_unused]] std::map<std::string,fs::path> setupInfos)
+static std::string cmakeList(const std::vector<std::string> & values)
 {
-    BOOST_LOG_TRIVIAL(warning)<<"CMakeGeneratorBackend::generateIndex NOT IMPLEMENTED";
+    std::string list;
+    for (auto & value : values) {
+        if (!list.empty()) {
+            list += ";";
+        }
+        list += cmakeEscape(value);
+    }
+    return list;
 }
 
-void CMakeGeneratorBackend::generateConfigureConditionsFile([[maybe_unused]] const fs::path &  rootFolderPath, [[maybe_unused]] const std::vector<Dependency> & deps)
+static void addUnique(std::vector<std::string> & values, const std::string & value)
 {
-    BOOST_LOG_TRIVIAL(warning)<<"CMakeGeneratorBackend::generateConfigureConditionsFile NOT IMPLEMENTED";
+    if (!value.empty() && std::find(values.begin(), values.end(), value) == values.end()) {
+        values.push_back(value);
+    }
 }
 
-void CMakeGeneratorBackend::parseConditionsFile([[maybe_unused]] const fs::path &  rootFolderPath, [[maybe_unused]] std::map<std::string,bool> & conditionsMap)
+std::pair<std::string, fs::path> CMakeGeneratorBackend::generate(const std::vector<Dependency> & deps, Dependency::Type depType)
 {
-    BOOST_LOG_TRIVIAL(warning)<<"CMakeGeneratorBackend::parseConditionsFile NOT IMPLEMENTED";
+    fs::detail::utf8_codecvt_facet utf8;
+    if (!mapContains(type2prefixMap,depType)) {
+        throw std::runtime_error("Error dependency type " + std::to_string(static_cast<uint32_t>(depType)) + " no supported");
+    }
+    std::string prefix = type2prefixMap.at(depType);
+    std::string targetNamespace = boost::to_lower_copy(prefix) + "::";
+    std::string filename = boost::to_lower_copy(prefix) + getGeneratorFileName("buildinfo");
+    fs::path filePath = DepUtils::getProjectBuildSubFolder(m_options)/filename;
+    std::ostringstream fos;
+    std::vector<std::string> targets;
+    fos<<"# Generated by remaken : "<<boost::to_lower_copy(prefix)<<" dependencies imported targets (requires CMake 3.13)"<<std::endl;
+    if (m_options.relocatable()) {
+        writeRootFile();
+        fos<<"include(${CMAKE_CURRENT_LIST_DIR}/"<<getGeneratorFileName(Constants::REMAKEN_ROOT_FILE)<<")"<<std::endl;
+    }
+    auto cmakePathList = [&](const std::vector<std::string> & values) {
+        std::string list;
+        for (auto & value : values) {
+            if (!list.empty()) {
+                list += ";";
+            }
+            std::string relocatedPath = relocatePath(cmakeEscape(value), DepUtils::getProjectBuildSubFolder(m_options), "${CMAKE_CURRENT_LIST_DIR}");
+            list += relocatePath(relocatedPath, m_options.getRemakenRoot(), "${REMAKEN_ROOT}");
+        }
+        return list;
+    };
+    for (auto & dep : deps ) {
+        std::vector<std::string> includeDirs, defines, compileOptions, libdirs, libs, linkOptions;
+        for (auto & cflagInfos : dep.cflags()) {
+            std::vector<std::string> cflagsVect;
+            boost::split_regex(cflagsVect, cflagInfos, boost::regex( " -" ));
+            for (auto & cflag: cflagsVect) {
+                boost::trim(cflag);
+                if (cflag.empty()) {
+                    continue;
+                }
+                if (cflag[0] == '-') {
+                    cflag.erase(0,1);
+                }
+                std::string cflagPrefix = cflag.substr(0,1);
+                if (cflagPrefix == "I") {
+                    addUnique(includeDirs, boost::trim_copy(cflag.substr(1)));
+                }
+                else if (cflagPrefix == "D") {
+                    addUnique(defines, boost::trim_copy(cflag.substr(1)));
+                }
+                else {
+                    addUnique(compileOptions, "-" + cflag);
+                }
+            }
+        }
+        for (auto & define : dep.defines()) {
+            addUnique(defines, define);
+        }
+        for (auto & libdir : dep.libdirs()) {
+            addUnique(libdirs, libdir);
+        }
+        std::vector<std::string> libNames;
+        for (auto & libInfos : dep.libs()) {
+            std::vector<std::string> optionsVect;
+            boost::split_regex(optionsVect, libInfos, boost::regex( " -" ));
+            for (auto & option: optionsVect) {
+                boost::trim(option);
+                if (option.empty()) {
+                    continue;
+                }
+                if (option[0] == '-') {
+                    option.erase(0,1);
+                }
+                std::string optionPrefix = option.substr(0,1);
+                if (optionPrefix == "L") {
+                    addUnique(libdirs, boost::trim_copy(option.substr(1)));
+                }
+                else if (optionPrefix == "l") {
+                    addUnique(libNames, option.substr(1));
+                }
+                else {
+                    addUnique(linkOptions, "-" + option);
+                }
+            }
+        }
+        // lib folders are complete once every -L option is parsed
+        for (auto & libName : libNames) {
+            fs::path libPath = resolveLibrary(libName, libdirs);
+            addUnique(libs, libPath.empty() ? "-l" + libName : libPath.generic_string(utf8));
+        }
+
+        std::string target = targetNamespace + dep.getName();
+        targets.push_back(target);
+        fos<<std::endl;
+        fos<<"# "<<dep.getName()<<" "<<dep.getVersion()<<std::endl;
+        fos<<"if(NOT TARGET "<<target<<")"<<std::endl;
+        fos<<"    add_library("<<target<<" INTERFACE IMPORTED)"<<std::endl;
+        fos<<"    set_target_properties("<<target<<" PROPERTIES"<<std::endl;
+        fos<<"        INTERFACE_INCLUDE_DIRECTORIES \""<<cmakePathList(includeDirs)<<"\""<<std::endl;
+        fos<<"        INTERFACE_COMPILE_DEFINITIONS \""<<cmakeList(defines)<<"\""<<std::endl;
+        fos<<"        INTERFACE_COMPILE_OPTIONS \""<<cmakeList(compileOptions)<<"\""<<std::endl;
+        fos<<"        INTERFACE_LINK_DIRECTORIES \""<<cmakePathList(libdirs)<<"\""<<std::endl;
+        fos<<"        INTERFACE_LINK_LIBRARIES \""<<cmakePathList(libs)<<"\""<<std::endl;
+        fos<<"        INTERFACE_LINK_OPTIONS \""<<cmakeList(linkOptions)<<"\")"<<std::endl;
+        fos<<"endif()"<<std::endl;
+    }
+    std::string setupTarget = "remaken::" + boost::to_lower_copy(prefix) + "_deps";
+    fos<<std::endl;
+    fos<<"if(NOT TARGET "<<setupTarget<<")"<<std::endl;
+    fos<<"    add_library("<<setupTarget<<" INTERFACE IMPORTED)"<<std::endl;
+    fos<<"    set_target_properties("<<setupTarget<<" PROPERTIES INTERFACE_LINK_LIBRARIES \""<<cmakeList(targets)<<"\")"<<std::endl;
+    fos<<"endif()"<<std::endl;
+    OsUtils::writeFileIfChanged(filePath, fos.str());
+    return {setupTarget, filePath};
+}
+
+void CMakeGeneratorBackend::writeRootFile()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // the only machine specific file in relocatable mode
+    fs::path rootFilePath = DepUtils::getProjectBuildSubFolder(m_options) / getGeneratorFileName(Constants::REMAKEN_ROOT_FILE);
+    OsUtils::writeFileIfChanged(rootFilePath, "set(REMAKEN_ROOT \"" + cmakeEscape(m_options.getRemakenRoot().generic_string(utf8)) + "\")\n");
+}
+
+void CMakeGeneratorBackend::generateIndex(std::map<std::string,fs::path> setupInfos)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path buildProjectSubFolderPath = DepUtils::getProjectBuildSubFolder(m_options);
+    fs::path depsInfoFilePath = buildProjectSubFolderPath / getGeneratorFileName("dependenciesBuildInfo");
+    std::ostringstream depsOstream;
+    std::vector<std::string> targets;
+    depsOstream<<"# Generated by remaken : include this file then link with remaken::all_deps"<<std::endl;
+    for (auto & kv : setupInfos) {
+        fs::path setupFilePath = kv.second.filename();
+        if (!setupFilePath.empty()) {
+            depsOstream<<"include(${CMAKE_CURRENT_LIST_DIR}/"<<setupFilePath.generic_string(utf8)<<")"<<std::endl;
+            if (kv.first.find("::") != std::string::npos) {
+                targets.push_back(kv.first);
+            }
+            else {
+                // conan native cmake generator provides a setup macro instead of a target
+                depsOstream<<"if(COMMAND "<<kv.first<<")"<<std::endl;
+                depsOstream<<"    "<<kv.first<<"(TARGETS)"<<std::endl;
+                depsOstream<<"endif()"<<std::endl;
+            }
+        }
+    }
+    depsOstream<<std::endl;
+    depsOstream<<"if(NOT TARGET remaken::all_deps)"<<std::endl;
+    depsOstream<<"    add_library(remaken::all_deps INTERFACE IMPORTED)"<<std::endl;
+    depsOstream<<"    set_target_properties(remaken::all_deps PROPERTIES INTERFACE_LINK_LIBRARIES \""<<cmakeList(targets)<<"\")"<<std::endl;
+    depsOstream<<"endif()"<<std::endl;
+    OsUtils::writeFileIfChanged(depsInfoFilePath, depsOstream.str());
+}
+
+void CMakeGeneratorBackend::generateConfigureConditionsFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps)
+{
+    fs::path buildFolderPath = rootFolderPath/DepUtils::getBuildPlatformFolder(m_options);
+    fs::path configureFilePath = buildFolderPath / getGeneratorFileName("configure_conditions");
+    if (deps.empty()) {
+        if (fs::exists(configureFilePath) ) {
+            fs::remove(configureFilePath);
+        }
+        return;
+    }
+
+    std::ostringstream configureFile;
+    for (auto & dep : deps) {
+        for (auto & condition : dep.getConditions()) {
+            configureFile << "add_compile_definitions(" << condition << ")";
+            configureFile << "\n";
+        }
+    }
+    OsUtils::writeFileIfChanged(configureFilePath, configureFile.str());
+}
+
+void CMakeGeneratorBackend::parseConditionsFile(const fs::path &  rootFolderPath, std::map<std::string,bool> & conditionsMap)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path configureFilePath = rootFolderPath / getGeneratorFileName("configure_conditions");
+    if (!fs::exists(configureFilePath)) {
+        return;
+    }
+
+    // supported forms : add_compile_definitions(CONDITION) enables, remove_definitions(-DCONDITION) disables
+    std::ifstream configureFile(configureFilePath.generic_string(utf8).c_str(), std::ios::in);
+    std::string curStr;
+    while (getline(configureFile,curStr)) {
+        boost::trim(curStr);
+        std::size_t openPos = curStr.find('(');
+        std::size_t closePos = curStr.rfind(')');
+        if (openPos == std::string::npos || closePos == std::string::npos || closePos < openPos) {
+            continue;
+        }
+        std::string command = boost::trim_copy(curStr.substr(0, openPos));
+        std::string conditionValue = boost::trim_copy(curStr.substr(openPos + 1, closePos - openPos - 1));
+        if (command == "add_compile_definitions") {
+            conditionsMap.insert_or_assign(conditionValue, true);
+        }
+        if (command == "remove_definitions" && boost::starts_with(conditionValue, "-D")) {
+            conditionsMap.insert_or_assign(conditionValue.substr(2), false);
+        }
+    }
+    configureFile.close();
 }
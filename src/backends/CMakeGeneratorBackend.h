@@ -33,6 +33,9 @@ public:
     void generateIndex(std::map<std::string,fs::path> setupInfos) override;
     void generateConfigureConditionsFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps) override;
     void parseConditionsFile(const fs::path &  rootFolderPath, std::map<std::string,bool> & conditionsMap) override;
+
+private:
+    void writeRootFile();
 };
 
 #endif // CMAKEGENERATORBACKEND_H
@@ -27,8 +27,11 @@
 #include "Dependency.h"
 #include "Constants.h"
 #include "CmdOptions.h"
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string_regex.hpp>
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
 #include "utils/DepUtils.h"
+#include "utils/OsUtils.h"
 
 namespace fs = boost::filesystem;
 
@@ -78,6 +81,58 @@ protected:
         return fileName;
     }
 
+    // resolves -l<libName> to the library file found in libdirs, so that build tools don't search it.
+    // returns an empty path when the library is not found
+    fs::path resolveLibrary(const std::string & libName, const std::vector<std::string> & libdirs) const
+    {
+        fs::detail::utf8_codecvt_facet utf8;
+        std::vector<std::string> candidates;
+        if (m_options.getOS() == "win") {
+            candidates.push_back(libName + std::string(OsUtils::staticSuffix(m_options.getOS())));
+        }
+        else {
+            std::string_view firstSuffix = OsUtils::sharedSuffix(m_options.getOS());
+            std::string_view secondSuffix = OsUtils::staticSuffix(m_options.getOS());
+            if (m_options.getMode() == "static") {
+                std::swap(firstSuffix, secondSuffix);
+            }
+            candidates.push_back("lib" + libName + std::string(firstSuffix));
+            candidates.push_back("lib" + libName + std::string(secondSuffix));
+        }
+        for (auto & libdir : libdirs) {
+            for (auto & candidate : candidates) {
+                fs::path libPath = fs::path(libdir, utf8) / candidate;
+                boost::system::error_code ec;
+                if (fs::exists(libPath, ec)) {
+                    return libPath;
+                }
+            }
+        }
+        return fs::path();
+    }
+
+    // relocatable mode : expresses a path located in rootPath relative to rootReference (a variable of the generated file holding rootPath).
+    // Other paths are kept as is
+    std::string relocatePath(const std::string & pathStr, const fs::path & rootPath, const std::string & rootReference) const
+    {
+        fs::detail::utf8_codecvt_facet utf8;
+        if (!m_options.relocatable() || rootPath.empty()) {
+            return pathStr;
+        }
+        std::string rootStr = rootPath.generic_string(utf8);
+        while (rootStr.size() > 1 && rootStr.back() == '/') {
+            rootStr.pop_back();
+        }
+        std::string genericPathStr = fs::path(pathStr, utf8).generic_string(utf8);
+        if (genericPathStr == rootStr) {
+            return rootReference;
+        }
+        if (boost::starts_with(genericPathStr, rootStr + "/")) {
+            return rootReference + genericPathStr.substr(rootStr.size());
+        }
+        return pathStr;
+    }
+
     const CmdOptions & m_options;
     std::string m_extension;
 };
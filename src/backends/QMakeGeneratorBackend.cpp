@@ -21,8 +21,11 @@
  */
 
 #include "backends/QMakeGeneratorBackend.h"
+#include "managers/AggregatedPathsManager.h"
+#include "utils/OsUtils.h"
 #include <fstream>
 #include <ios>
+#include <sstream>
 #include <regex>
 
 static const std::map<Dependency::Type,std::string> type2prefixMap = {
@@ -44,8 +47,33 @@ std::pair<std::string, fs::path> QMakeGeneratorBackend::generate(const std::vect
     std::string prefix = type2prefixMap.at(depType);
     std::string filename = boost::to_lower_copy(prefix) + getGeneratorFileName("buildinfo");
     fs::path filePath = DepUtils::getProjectBuildSubFolder(m_options)/filename;
-    std::ofstream fos(filePath.generic_string(utf8),std::ios::out);
+    std::ostringstream fos;
     std::string libdirs, libsStr, defines, cflags;
+    AggregatedPathsManager aggregatedPaths(m_options);
+    bool includeRootUsed = false, libRootUsed = false;
+    if (m_options.relocatable()) {
+        writeRootFile();
+        fos<<"include($$PWD/"<<getGeneratorFileName(Constants::REMAKEN_ROOT_FILE)<<")"<<std::endl;
+    }
+    // aggregated folders are located next to the generated file
+    auto relocate = [&](const std::string & pathStr) {
+        std::string relocatedPath = relocatePath(pathStr, DepUtils::getProjectBuildSubFolder(m_options), "$$PWD");
+        return relocatePath(relocatedPath, m_options.getRemakenRoot(), "$${REMAKEN_ROOT}");
+    };
+    auto addIncludePath = [&](const std::string & includePath) {
+        if (m_options.aggregatePaths() && aggregatedPaths.addIncludePath(fs::path(includePath, utf8))) {
+            includeRootUsed = true;
+            return;
+        }
+        cflags += " \"" + relocate(includePath) + "\"";
+    };
+    auto addLibPath = [&](const std::string & libPath) {
+        if (m_options.aggregatePaths() && aggregatedPaths.addLibPath(fs::path(libPath, utf8))) {
+            libRootUsed = true;
+            return;
+        }
+        libdirs += " -L\"" + relocate(libPath) + "\"";
+    };
     for (auto & dep : deps ) {
         for (auto & cflagInfos : dep.cflags()) {
             std::vector<std::string> cflagsVect;
@@ -59,7 +87,7 @@ std::pair<std::string, fs::path> QMakeGeneratorBackend::generate(const std::vect
                     // remove -I
                     cflag.erase(0,1);
                     boost::trim(cflag);
-                    cflags += " \"" + cflag + "\"";
+                    addIncludePath(cflag);
                 }
                 else if (cflagPrefix == "D") {
                     // remove -D
@@ -83,7 +111,8 @@ std::pair<std::string, fs::path> QMakeGeneratorBackend::generate(const std::vect
                 std::string optionPrefix = option.substr(0,1);
                 if (optionPrefix == "L") {
                     option.erase(0,1);
-                    libdirs += " -L\"" + option + "\"";
+                    boost::trim(option);
+                    addLibPath(option);
                 }
                 //TODO : extract lib paths from libdefs and put quotes around libs path
                 else {
@@ -93,9 +122,15 @@ std::pair<std::string, fs::path> QMakeGeneratorBackend::generate(const std::vect
             }
         }
         for (auto & libdir : dep.libdirs()) {
-            libdirs += " -L\"" + libdir + "\"";
+            addLibPath(libdir);
         }
     }
+    if (includeRootUsed) {
+        cflags = " \"" + relocate(aggregatedPaths.includeRoot().generic_string(utf8)) + "\"" + cflags;
+    }
+    if (libRootUsed) {
+        libdirs = " -L\"" + relocate(aggregatedPaths.libRoot().generic_string(utf8)) + "\"" + libdirs;
+    }
     fos<<prefix<<"_INCLUDEPATH +="<<cflags<<std::endl;
     fos<<prefix<<"_LIBS +="<<libsStr<<std::endl;
     fos<<prefix<<"_SYSTEMLIBS += "<<std::endl;
@@ -119,17 +154,25 @@ std::pair<std::string, fs::path> QMakeGeneratorBackend::generate(const std::vect
     fos<<"QMAKE_CXXFLAGS += $$"<<prefix<<"_QMAKE_CXXFLAGS"<<std::endl;
     fos<<"QMAKE_CFLAGS += $$"<<prefix<<"_QMAKE_CFLAGS"<<std::endl;
     fos<<"QMAKE_LFLAGS += $$"<<prefix<<"_QMAKE_LFLAGS"<<std::endl;
-    fos.close();
+    OsUtils::writeFileIfChanged(filePath, fos.str());
     return {boost::to_lower_copy(prefix)+"_basic_setup", filePath};
 }
 
 
+void QMakeGeneratorBackend::writeRootFile()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // the only machine specific file in relocatable mode
+    fs::path rootFilePath = DepUtils::getProjectBuildSubFolder(m_options) / getGeneratorFileName(Constants::REMAKEN_ROOT_FILE);
+    OsUtils::writeFileIfChanged(rootFilePath, "REMAKEN_ROOT = $$quote(" + m_options.getRemakenRoot().generic_string(utf8) + ")\n");
+}
+
 void QMakeGeneratorBackend::generateIndex(std::map<std::string,fs::path> setupInfos)
 {
     fs::detail::utf8_codecvt_facet utf8;
     fs::path buildProjectSubFolderPath = DepUtils::getProjectBuildSubFolder(m_options);
     fs::path depsInfoFilePath = buildProjectSubFolderPath / getGeneratorFileName("dependenciesBuildInfo"); // extension should later depend on generator type
-    std::ofstream depsOstream(depsInfoFilePath.generic_string(utf8),std::ios::out);
+    std::ostringstream depsOstream;
     for (auto & kv : setupInfos) {
         depsOstream<<"CONFIG += "<<kv.first<<std::endl;
     }
@@ -140,7 +183,7 @@ void QMakeGeneratorBackend::generateIndex(std::map<std::string,fs::path> setupIn
             depsOstream<<"include($$_PRO_FILE_PWD_/"<<buildSubFolderPath.generic_string(utf8)<<"/"<<setupFilePath.filename().generic_string(utf8)<<")\n";
         }
     }
-    depsOstream.close();
+    OsUtils::writeFileIfChanged(depsInfoFilePath, depsOstream.str());
 }
 
 void QMakeGeneratorBackend::generateConfigureConditionsFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps)
@@ -148,25 +191,21 @@ void QMakeGeneratorBackend::generateConfigureConditionsFile(const fs::path &  ro
     fs::detail::utf8_codecvt_facet utf8;
     fs::path buildFolderPath = rootFolderPath/DepUtils::getBuildPlatformFolder(m_options);
     fs::path configureFilePath = buildFolderPath / getGeneratorFileName("configure_conditions");
-    if (fs::exists(configureFilePath) ) {
-        fs::remove(configureFilePath);
-    }
-
     if (deps.empty()) {
+        if (fs::exists(configureFilePath) ) {
+            fs::remove(configureFilePath);
+        }
         return;
     }
 
-    if (!fs::exists(buildFolderPath)) {
-        fs::create_directories(buildFolderPath);
-    }
-    std::ofstream configureFile(configureFilePath.generic_string(utf8).c_str(), std::ios::out);
+    std::ostringstream configureFile;
     for (auto & dep : deps) {
         for (auto & condition : dep.getConditions()) {
             configureFile << "DEFINES += " << condition;
             configureFile << "\n";
         }
     }
-    configureFile.close();
+    OsUtils::writeFileIfChanged(configureFilePath, configureFile.str());
 }
 
 void QMakeGeneratorBackend::parseConditionsFile(const fs::path &  rootFolderPath, std::map<std::string,bool> & conditionsMap)
@@ -1,5 +1,6 @@
 #include "ConfigureCommand.h"
 #include "utils/DepUtils.h"
+#include "managers/AggregatedPathsManager.h"
 #include "managers/XpcfXmlManager.h"
 #include "utils/OsUtils.h"
 #include <boost/log/trivial.hpp>
@@ -7,8 +8,11 @@
 #include "FileHandlerFactory.h"
 #include <memory>
 #include <map>
+#include <set>
 #include <vector>
+#include <boost/algorithm/string.hpp>
 #include "backends/BackendGeneratorFactory.h"
+#include "utils/Trace.h"
 
 
 namespace bp = boost::process;
@@ -20,6 +24,44 @@ ConfigureCommand::ConfigureCommand(const CmdOptions & options):AbstractCommand(C
 {
 }
 
+void ConfigureCommand::removeObsoleteBuildInfoFiles(const fs::path & buildProjectSubFolderPath, const std::map<std::string,fs::path> & setupInfoMap)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // [type]buildinfo files of dependency types no more used by the project, with their [type]_[name]_setup files (bazel generator)
+    std::string buildInfoSuffix = m_options.getGeneratorFilePath("buildinfo");
+    std::string setupSuffix = m_options.getGeneratorFilePath("_setup");
+    std::set<fs::path> generatedFiles;
+    for (auto & [setupName, setupFilePath] : setupInfoMap) {
+        generatedFiles.insert(setupFilePath.filename());
+    }
+    std::vector<std::string> obsoleteTypePrefixes;
+    for (fs::directory_entry& x : fs::directory_iterator(buildProjectSubFolderPath)) {
+        std::string fileName = x.path().filename().generic_string(utf8);
+        if (fs::is_regular_file(x.path()) && boost::algorithm::ends_with(fileName, buildInfoSuffix)
+                && generatedFiles.find(x.path().filename()) == generatedFiles.end()) {
+            obsoleteTypePrefixes.push_back(fileName.substr(0, fileName.size() - buildInfoSuffix.size()) + "_");
+            m_options.verboseMessage("===> removing obsolete file " + x.path().generic_string(utf8));
+            fs::remove(x.path());
+        }
+    }
+    if (obsoleteTypePrefixes.empty()) {
+        return;
+    }
+    for (fs::directory_entry& x : fs::directory_iterator(buildProjectSubFolderPath)) {
+        std::string fileName = x.path().filename().generic_string(utf8);
+        if (!fs::is_regular_file(x.path()) || !boost::algorithm::ends_with(fileName, setupSuffix)) {
+            continue;
+        }
+        for (auto & typePrefix : obsoleteTypePrefixes) {
+            if (boost::algorithm::starts_with(fileName, typePrefix)) {
+                m_options.verboseMessage("===> removing obsolete file " + x.path().generic_string(utf8));
+                fs::remove(x.path());
+                break;
+            }
+        }
+    }
+}
+
 int ConfigureCommand::execute()
 {
     // pb : configurecommand must be run on generated pkgdeps ... the command should use configure options and/or generate the pkgdeps ??
@@ -79,15 +121,15 @@ int ConfigureCommand::execute()
         }
         // timestamp obsolete or absent
         if (!m_options.force() && !m_options.override()) {
-            std::cout<<"=> File " << depPath.generic_string(utf8) << " has recent changes: cleaning up and starting a fresh build configuration"<<std::endl;
+            std::cout<<"=> File " << depPath.generic_string(utf8) << " has recent changes: updating the build configuration"<<std::endl;
         }
         else {
-            std::cout<<"=> Force generation: cleaning up and starting a fresh build configuration ---------"<<std::endl;
+            std::cout<<"=> Force generation: updating the build configuration"<<std::endl;
         }
 
-        fs::remove_all(buildProjectSubFolderPath);
+        // the project build folder is updated incrementally : generators only rewrite files whose content changed,
+        // so that build tools don't re-evaluate unchanged files
         fs::create_directories(buildProjectSubFolderPath);
-        fs::detail::utf8_codecvt_facet utf8;
 
         std::vector<Dependency> depsVect;
         DepUtils::parseRecurse(depPath, m_options, depsVect);
@@ -96,6 +138,16 @@ int ConfigureCommand::execute()
         for (auto & dep : dependencies) {
             depsVectMap[dep.getType()].push_back(dep);
         }
+        // dependencies of the generated types : generators can reference them from any type file
+        std::set<std::string> configuredDependencies;
+        for (auto type : {Dependency::Type::CONAN, Dependency::Type::REMAKEN, Dependency::Type::BREW, Dependency::Type::SYSTEM}) {
+            if (mapContains(depsVectMap, type)) {
+                for (auto & dep : depsVectMap.at(type)) {
+                    configuredDependencies.insert(dep.getName());
+                }
+            }
+        }
+        m_options.setConfiguredDependencies(configuredDependencies);
         std::map<std::string,fs::path> setupInfoMap;
         if (mapContains(depsVectMap, Dependency::Type::CONAN)) {
             std::cout<<std::endl<<"=> Conan dependencies build information generation in progress ... please wait"<<std::endl;
@@ -121,13 +173,22 @@ int ConfigureCommand::execute()
             shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(Dependency::Type::SYSTEM, m_options, "system");
             setupInfoMap.insert(fileRetriever->invokeGenerator(depVect));
         }
+        // aggregated paths folders only change where the dependencies folders changed
+        AggregatedPathsManager::update(m_options);
         std::cout<<std::endl<<"=> Generating main dependenciesBuildInfo file"<<std::endl;
-        generator->generateIndex(setupInfoMap);
+        {
+            Trace::Span span("generator", m_options.getGenerator() + " index");
+            generator->generateIndex(setupInfoMap);
+        }
+        removeObsoleteBuildInfoFiles(buildProjectSubFolderPath, setupInfoMap);
         std::ofstream fos(timestampPath.generic_string(utf8),std::ios::out);
         int64_t nanoSeconds = nsDuration.count();
         fos<<std::to_string(nanoSeconds)<<std::endl;
         fos.close();
-        generator->generateConfigureConditionsFile(depFolder, dependencies);
+        {
+            Trace::Span span("generator", m_options.getGenerator() + " configure conditions");
+            generator->generateConfigureConditionsFile(depFolder, dependencies);
+        }
         std::cout<<"====> Configure done successfully !"<<std::endl;
         return 0;
     }
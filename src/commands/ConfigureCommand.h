@@ -24,6 +24,11 @@
 
 #include "AbstractCommand.h"
 #include "CmdOptions.h"
+#include <map>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
 
 class ConfigureCommand : public AbstractCommand
 {
@@ -33,6 +38,7 @@ public:
     static constexpr const char * NAME="configure";
 
 private:
+    void removeObsoleteBuildInfoFiles(const fs::path & buildProjectSubFolderPath, const std::map<std::string,fs::path> & setupInfoMap);
     const CmdOptions & m_options;
 };
 
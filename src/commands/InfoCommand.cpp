@@ -48,7 +48,7 @@ void InfoCommand::displayInfoPaths()
 
 
         std::map<std::string,Dependency> depsMap;
-        for (auto dependency : depsVect) {//filter redundant deps
+        for (const auto & dependency : depsVect) {//filter redundant deps
             //std::cout<<dependency.toString()<<std::endl;
             depsMap.insert_or_assign(dependency.getName()+dependency.getVersion(), dependency);
         }
@@ -4,6 +4,7 @@
 #include "utils/PathBuilder.h"
 #include "retrievers/HttpFileRetriever.h"
 #include "utils/OsUtils.h"
+#include "utils/Trace.h"
 #include "utils/DepUtils.h"
 #include "tools/GitTool.h"
 #include <boost/log/trivial.hpp>
@@ -48,6 +49,7 @@ int setupVCPKG(const fs::path & remakenRootPackagesPath, const std::string & tag
     if (result != 0) {
         return result;
     }
+    Trace::Span span("process", "bootstrap-vcpkg");
 #ifdef BOOST_OS_WINDOWS_AVAILABLE
     result = bp::system(remakenRootPackagesPath / "vcpkg" / "bootstrap-vcpkg.bat");
 #else
@@ -60,6 +62,7 @@ int setupVCPKG(const fs::path & remakenRootPackagesPath, const std::string & tag
 int setupBrew()
 {
     int result = -1;
+    Trace::Span span("process", "bash");
     result = bp::system("/bin/bash","-c","-fsSL","https://raw.githubusercontent.com/Homebrew/install/HEAD/install.sh)");
     return result;
 }
@@ -1,113 +1,529 @@
 #include "PackageCommand.h"
 //#include "managers/DependencyManager.h"
-#include "tools/ZipTool.h"
-//#include "utils/OsUtils.h"
+#include "Constants.h"
+#include "utils/HashUtils.h"
+#include "utils/OsUtils.h"
+#include "utils/Trace.h"
+#include "utils/ZipWriter.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+static constexpr const char * COMPRESS_MANIFESTS_FOLDER = ".manifests";
+static constexpr int COMPRESS_ARCHIVE_FORMAT_VERSION = 1;
 
 PackageCommand::PackageCommand(const CmdOptions & options):AbstractCommand(PackageCommand::NAME),m_options(options)
 {
 }
 
-void PackageCommand::compressFolder([[maybe_unused]] fs::path folderPath)
+namespace {
+
+std::vector<fs::path> subFolders(const fs::path & folderPath)
 {
-    auto zipTool = ZipTool::createZipTool(m_options);
+    std::vector<fs::path> folders;
+    if (fs::is_directory(folderPath)) {
+        for (fs::directory_entry & entry : fs::directory_iterator(folderPath)) {
+            if (fs::is_directory(entry.path())) {
+                folders.push_back(entry.path().filename());
+            }
+        }
+    }
+    return folders;
+}
+
+// adds every file below folderPath : symbolic links are kept as links
+void addFolderFiles(const fs::path & folderPath, const fs::path & relativeFolderPath, std::vector<std::pair<fs::path, fs::path>> & files)
+{
+    if (!fs::is_directory(folderPath)) {
+        return;
+    }
+    for (fs::recursive_directory_iterator it(folderPath), end; it != end; ++it) {
+        fs::file_status status = it->symlink_status();
+        if (fs::is_regular_file(status) || fs::is_symlink(status)) {
+            files.push_back({it->path(), relativeFolderPath / it->path().lexically_relative(folderPath)});
+        }
+    }
+}
 
 }
+
 // whatever package type i.e. lib, bin or headers
 // copy *.pc, pkgdeps*.txt
 // copy or create .pkginfo with adequate .lib, .bin or .headers
 // copy pkgname-version_remakeninfo.txt
 // copy every folder from post install package root folder
+std::vector<PackageCommand::PackageVariant> PackageCommand::collectVariants(const fs::path & pkgVersionFolder, const fs::path & destinationFolder)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string pkgName = pkgVersionFolder.parent_path().filename().generic_string(utf8);
+    std::string pkgVersion = pkgVersionFolder.filename().generic_string(utf8);
+    fs::path archiveRoot = pkgVersionFolder.parent_path().filename() / pkgVersionFolder.filename();
+
+    // every variant holds the package root files and folders, except lib and bin
+    std::vector<std::pair<fs::path, fs::path>> commonFiles;
+    std::set<fs::path> variantPaths; // architecture/mode/config
+    for (fs::directory_entry & entry : fs::directory_iterator(pkgVersionFolder)) {
+        fs::path entryName = entry.path().filename();
+        fs::file_status status = entry.symlink_status();
+        if (fs::is_directory(status)) {
+            if (entryName == "lib" || entryName == "bin") {
+                for (auto & platform : subFolders(entry.path())) {
+                    for (auto & mode : subFolders(entry.path() / platform)) {
+                        for (auto & config : subFolders(entry.path() / platform / mode)) {
+                            variantPaths.insert(platform / mode / config);
+                        }
+                    }
+                }
+            }
+            else {
+                addFolderFiles(entry.path(), archiveRoot / entryName, commonFiles);
+            }
+        }
+        else if (fs::is_regular_file(status) || fs::is_symlink(status)) {
+            commonFiles.push_back({entry.path(), archiveRoot / entryName});
+        }
+    }
+    if (variantPaths.empty()) { // package without libs : use mode and config from options
+        variantPaths.insert(fs::path(m_options.getArchitecture(), utf8) / m_options.getMode() / m_options.getConfig());
+    }
+
+    bool withPkgInfo = fs::is_directory(pkgVersionFolder / Constants::PKGINFO_FOLDER);
+    std::vector<PackageVariant> variants;
+    for (auto & variantPath : variantPaths) {
+        PackageVariant variant;
+        variant.name = pkgName + "_" + pkgVersion;
+        for (auto & part : variantPath) {
+            variant.name += "_" + part.generic_string(utf8);
+        }
+        variant.archivePath = destinationFolder / pkgName / pkgVersion / m_options.getOS() / (variant.name + ".zip");
+        variant.files = commonFiles;
+        bool withLibDir = fs::is_directory(pkgVersionFolder / "lib" / variantPath);
+        bool withBinDir = fs::is_directory(pkgVersionFolder / "bin" / variantPath);
+        addFolderFiles(pkgVersionFolder / "lib" / variantPath, archiveRoot / "lib" / variantPath, variant.files);
+        addFolderFiles(pkgVersionFolder / "bin" / variantPath, archiveRoot / "bin" / variantPath, variant.files);
+        if (!withPkgInfo) {
+            if (fs::is_directory(pkgVersionFolder / "interfaces")) {
+                variant.pkgInfoMarkers.push_back(archiveRoot / Constants::PKGINFO_FOLDER / ".headers");
+            }
+            if (withLibDir) {
+                variant.pkgInfoMarkers.push_back(archiveRoot / Constants::PKGINFO_FOLDER / ".lib");
+            }
+            if (withBinDir) {
+                variant.pkgInfoMarkers.push_back(archiveRoot / Constants::PKGINFO_FOLDER / ".bin");
+            }
+        }
+        std::sort(variant.files.begin(), variant.files.end(), [](const auto & a, const auto & b) {
+            return a.second < b.second;
+        });
+        variants.push_back(std::move(variant));
+    }
+    return variants;
+}
+
+std::string PackageCommand::computeManifestHash(const PackageVariant & variant)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::ostringstream manifest;
+    for (auto & [sourcePath, relativePath] : variant.files) {
+        boost::system::error_code ec;
+        manifest << relativePath.generic_string(utf8);
+        if (fs::is_symlink(sourcePath, ec)) {
+            manifest << " -> " << fs::read_symlink(sourcePath, ec).generic_string(utf8);
+        }
+        else {
+            manifest << " " << fs::file_size(sourcePath, ec) << " " << fs::last_write_time(sourcePath, ec);
+        }
+        manifest << std::endl;
+    }
+    for (auto & marker : variant.pkgInfoMarkers) {
+        manifest << marker.generic_string(utf8) << std::endl;
+    }
+    // archives written by another archive format version are rebuilt
+    manifest << "#zipwriter " << COMPRESS_ARCHIVE_FORMAT_VERSION << std::endl;
+    return HashUtils::sha256(manifest.str());
+}
+
+fs::path PackageCommand::manifestHashPath(const PackageVariant & variant, const fs::path & destinationFolder)
+{
+    return destinationFolder / COMPRESS_MANIFESTS_FOLDER / (variant.name + ".sha256");
+}
+
+void PackageCommand::compressVariant(const PackageVariant & variant, const fs::path & destinationFolder, const std::string & manifestHash)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    Trace::Span span("zip", "compress " + variant.archivePath.filename().generic_string(utf8));
+    ZipWriter writer;
+    for (auto & [sourcePath, relativePath] : variant.files) {
+        writer.addFile(relativePath.generic_string(utf8), sourcePath);
+    }
+    for (auto & marker : variant.pkgInfoMarkers) {
+        writer.addEmptyFile(marker.generic_string(utf8));
+    }
+    fs::create_directories(variant.archivePath.parent_path());
+    writer.write(variant.archivePath);
+    OsUtils::writeFileIfChanged(manifestHashPath(variant, destinationFolder), manifestHash);
+}
+
+int PackageCommand::compressVariants(const std::vector<PackageVariant> & variants, const fs::path & destinationFolder)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::mutex outputMutex;
+    std::size_t compressedCount = 0, upToDateCount = 0;
+    bool bFailed = false;
+    boost::asio::thread_pool pool(HashUtils::defaultJobs());
+    for (auto & variant : variants) {
+        boost::asio::post(pool, [&, this]() {
+            try {
+                std::string manifestHash = computeManifestHash(variant);
+                std::ifstream fis(manifestHashPath(variant, destinationFolder).generic_string(utf8), std::ios::in);
+                std::string previousHash;
+                std::getline(fis, previousHash);
+                if (previousHash == manifestHash && fs::exists(variant.archivePath)) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    upToDateCount++;
+                    m_options.verboseMessage("===> " + variant.name + " is up to date");
+                    return;
+                }
+                compressVariant(variant, destinationFolder, manifestHash);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                compressedCount++;
+                std::cout<<"===> "<<variant.name<<" compressed in "<<variant.archivePath.generic_string(utf8)<<std::endl;
+            }
+            catch (const std::exception & e) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                bFailed = true;
+                BOOST_LOG_TRIVIAL(error)<<"==> Unable to compress "<<variant.name<<" : "<<e.what();
+            }
+        });
+    }
+    pool.join();
+    std::cout<<"=> "<<compressedCount<<" package(s) compressed, "<<upToDateCount<<" up to date"<<std::endl;
+    return bFailed ? -1 : 0;
+}
 
 int PackageCommand::compress()
 {
     fs::detail::utf8_codecvt_facet utf8;
-    //bool bRecurse = false;
     const std::map<std::string,std::string> & compressOptions = m_options.getCompressCommandOptions();
     fs::path rootFolder = compressOptions.at("rootdir");
+    fs::path destinationFolder = fs::absolute(fs::path(compressOptions.at("destination"), utf8)).lexically_normal();
+    const std::string & pkgNameFilter = compressOptions.at("packagename");
+    const std::string & pkgVersionFilter = compressOptions.at("packageversion");
     fs::path toolChainPrefix =  m_options.getOS() + "-" + m_options.getBuildToolchain();
-    if (fs::is_directory(rootFolder)) {
-        fs::path subFolder = rootFolder;
-        subFolder /= toolChainPrefix;
-        if (fs::is_directory(subFolder)) {
-            rootFolder = subFolder;
-        }
-        for (fs::directory_entry& pkgFolder : fs::directory_iterator(rootFolder)) {
-            if (fs::is_directory(pkgFolder.path())) {//found pkg
-                std::cout<<pkgFolder.path().c_str()<<std::endl;
-                fs::path pkgName = pkgFolder.path().filename();
-                for (fs::directory_entry& pkgVersionFolder : fs::directory_iterator(pkgFolder.path())) {
-                    if (fs::is_directory(pkgVersionFolder.path())) {//found version
-                        std::cout<<pkgVersionFolder.path().c_str()<<std::endl;
-                        fs::path pkgVersion = pkgVersionFolder.path().filename();
-                        if (!fs::exists(pkgVersionFolder.path()/"lib") || !fs::is_directory(pkgVersionFolder.path()/"lib")) {// package without libs
-                            //fs::create_directories();
-                            //use mode and config from options at first
-                            fs::path tmpFolder = toolChainPrefix;
-                            tmpFolder += "_";
-                            tmpFolder += m_options.getArchitecture();
-                            tmpFolder += "_";
-                            tmpFolder += m_options.getMode();
-                            tmpFolder += "_";
-                            tmpFolder += m_options.getConfig();
-                            tmpFolder /= pkgName;
-                            tmpFolder /= pkgVersion;
-                            std::cout<<tmpFolder.c_str()<<std::endl;
-
-                            fs::create_directories(tmpFolder/Constants::PKGINFO_FOLDER);
-                            try {
-                                fs::copy(pkgVersionFolder.path()/"interfaces", tmpFolder/"interfaces", fs::copy_options::recursive);
-                            }
-                            catch (std::exception&) { // Not using fs::filesystem_error since std::bad_alloc can throw too.
-                                // Handle exception or use error code overload of fs::copy.
-                            }
-                        }
-                        else {// package with libs
-                            for (fs::directory_entry& platformFolder : fs::directory_iterator(pkgVersionFolder.path()/"lib")) {
-                                if (fs::is_directory(platformFolder.path())) {//found platform
-                                    std::cout<<platformFolder.path().c_str()<<std::endl;
-                                    fs::path platform = platformFolder.path().filename();
-                                    for (fs::directory_entry& modeFolder : fs::directory_iterator(platformFolder.path())) {
-                                        if (fs::is_directory(modeFolder.path())) {//found mode
-                                            std::cout<<modeFolder.path().c_str()<<std::endl;
-                                            fs::path mode = modeFolder.path().filename();
-                                            for (fs::directory_entry& configFolder : fs::directory_iterator(modeFolder.path())) {
-                                                if (fs::is_directory(configFolder.path())) {//found config
-                                                    std::cout<<configFolder.path().c_str()<<std::endl;
-                                                    fs::path config = configFolder.path().filename();
-                                                    fs::path tmpFolder = toolChainPrefix;
-                                                    tmpFolder += "_";
-                                                    tmpFolder += platform;
-                                                    tmpFolder += "_";
-                                                    tmpFolder += mode;
-                                                    tmpFolder += "_";
-                                                    tmpFolder += config;
-                                                    tmpFolder /= pkgName;
-                                                    tmpFolder /= pkgVersion;
-                                                    std::cout<<tmpFolder.c_str()<<std::endl;
-
-                                                    fs::create_directories(tmpFolder/Constants::PKGINFO_FOLDER);
-                                                    try {
-                                                        fs::copy(pkgVersionFolder.path()/"interfaces", tmpFolder/"interfaces", fs::copy_options::recursive);
-                                                        //OsUtils::copyLibraries(configFolder.path(),tmpFolder/,OsUtils::sharedSuffix(m_options.getOS()));
-                                                        //OsUtils::copyLibraries(configFolder.path(),tmpFolder/,OsUtils::staticSuffix(m_options.getOS()));
-                                                    }
-                                                    catch (std::exception&) { // Not using fs::filesystem_error since std::bad_alloc can throw too.
-                                                        // Handle exception or use error code overload of fs::copy.
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
+    if (!fs::is_directory(rootFolder)) {
+        BOOST_LOG_TRIVIAL(error)<<"Package root folder "<<rootFolder<<" doesn't exist";
+        return -1;
+    }
+    fs::path subFolder = rootFolder;
+    subFolder /= toolChainPrefix;
+    if (fs::is_directory(subFolder)) {
+        rootFolder = subFolder;
+    }
+
+    std::vector<PackageVariant> variants;
+    for (fs::directory_entry& pkgFolder : fs::directory_iterator(rootFolder)) {
+        std::string pkgName = pkgFolder.path().filename().generic_string(utf8);
+        // skip remaken internal folders (.locks, .staging ...) and the destination folder
+        if (!fs::is_directory(pkgFolder.path()) || pkgName.front() == '.'
+                || fs::absolute(pkgFolder.path()).lexically_normal() == destinationFolder) {
+            continue;
+        }
+        if (!pkgNameFilter.empty() && pkgName != pkgNameFilter) {
+            continue;
+        }
+        for (fs::directory_entry& pkgVersionFolder : fs::directory_iterator(pkgFolder.path())) {
+            if (!fs::is_directory(pkgVersionFolder.path())) {
+                continue;
+            }
+            if (!pkgVersionFilter.empty() && pkgVersionFolder.path().filename().generic_string(utf8) != pkgVersionFilter) {
+                continue;
+            }
+            std::vector<PackageVariant> pkgVariants = collectVariants(pkgVersionFolder.path(), destinationFolder);
+            std::move(pkgVariants.begin(), pkgVariants.end(), std::back_inserter(variants));
+        }
+    }
+
+    return compressVariants(variants, destinationFolder);
+}
+
+namespace {
+
+// library file names listed in a redistribution file (such as intel ipp redist.txt) : "<installdir>/path/to/libname.ext"
+std::set<std::string> parseRedistFile(const fs::path & redistFilePath, const std::string_view & sharedSuffix, const std::string_view & staticSuffix)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::set<std::string> redistLibraries;
+    std::ifstream fis(redistFilePath.generic_string(utf8), std::ios::in);
+    if (!fis.is_open()) {
+        throw std::runtime_error("Unable to open redistribution file " + redistFilePath.generic_string(utf8));
+    }
+    std::string line;
+    while (std::getline(fis, line)) {
+        boost::trim(line);
+        if (line.find("<installdir>") == std::string::npos || line.find("lib") == std::string::npos) {
+            continue;
+        }
+        fs::path libraryPath(line, utf8);
+        if (OsUtils::hasLibrarySuffix(libraryPath, sharedSuffix) || OsUtils::hasLibrarySuffix(libraryPath, staticSuffix)) {
+            redistLibraries.insert(libraryPath.filename().generic_string(utf8));
+        }
+    }
+    return redistLibraries;
+}
+
+// library name used in link flags : file name without extensions and without lib prefix on unixes
+std::string libraryName(const fs::path & libraryPath, const std::string & os)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string name = libraryPath.stem().generic_string(utf8);
+    if (os != "win" && boost::starts_with(name, "lib")) {
+        name = name.substr(3);
+    }
+    return name;
+}
+
+}
+
+PackageCommand::BuildOutput PackageCommand::scanBuildOutput(const fs::path & sourceFolder, const fs::path & libFolder, const fs::path & includeFolder)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    const std::map<std::string,std::string> & createOptions = m_options.getCreateCommandOptions();
+    const std::string & libSuffix = createOptions.at("withsuffix");
+    const std::string_view & sharedSuffix = OsUtils::sharedSuffix(m_options.getOS());
+    const std::string_view & staticSuffix = OsUtils::staticSuffix(m_options.getOS());
+    std::set<std::string> redistLibraries;
+    bool withRedistFile = !createOptions.at("redistfile").empty();
+    if (withRedistFile) {
+        redistLibraries = parseRedistFile(sourceFolder / fs::path(createOptions.at("redistfile"), utf8), sharedSuffix, staticSuffix);
+    }
+
+    // libraries, headers and original pkgconfig files are searched concurrently
+    BuildOutput buildOutput;
+    std::vector<std::string> errors(3);
+    boost::asio::thread_pool pool(3);
+    boost::asio::post(pool, [&]() {
+        try {
+            for (fs::recursive_directory_iterator it(libFolder), end; it != end; ++it) {
+                fs::file_status status = it->symlink_status();
+                if (!fs::is_regular_file(status) && !fs::is_symlink(status)) {
+                    continue;
+                }
+                std::string fileName = it->path().filename().generic_string(utf8);
+                if ((!libSuffix.empty() && it->path().stem().generic_string(utf8).find(libSuffix) == std::string::npos)
+                        || (withRedistFile && redistLibraries.count(fileName) == 0)) {
+                    continue;
+                }
+                if (OsUtils::hasLibrarySuffix(it->path(), sharedSuffix)) {
+                    buildOutput.sharedLibraries.push_back(it->path());
+                }
+                else if (OsUtils::hasLibrarySuffix(it->path(), staticSuffix)) {
+                    buildOutput.staticLibraries.push_back(it->path());
+                }
+            }
+        }
+        catch (const std::exception & e) {
+            errors[0] = e.what();
+        }
+    });
+    boost::asio::post(pool, [&]() {
+        try {
+            static const std::set<std::string> headerExtensions = {".h", ".hpp", ".ipp"};
+            for (fs::recursive_directory_iterator it(includeFolder), end; it != end; ++it) {
+                if (fs::is_regular_file(it->path()) && headerExtensions.count(it->path().extension().generic_string(utf8)) > 0) {
+                    fs::path headerFolder = it->path().parent_path().lexically_relative(includeFolder);
+                    buildOutput.headers.push_back({it->path(), headerFolder == "." ? fs::path() : headerFolder});
+                }
+            }
+        }
+        catch (const std::exception & e) {
+            errors[1] = e.what();
+        }
+    });
+    if (m_options.packageUseOriginalPCfiles()) {
+        boost::asio::post(pool, [&]() {
+            try {
+                for (fs::recursive_directory_iterator it(sourceFolder), end; it != end; ++it) {
+                    if (fs::is_regular_file(it->path()) && it->path().extension() == ".pc") {
+                        buildOutput.pkgConfigFiles.push_back(it->path());
                     }
                 }
             }
+            catch (const std::exception & e) {
+                errors[2] = e.what();
+            }
+        });
+    }
+    pool.join();
+    for (auto & error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+    std::sort(buildOutput.sharedLibraries.begin(), buildOutput.sharedLibraries.end());
+    std::sort(buildOutput.staticLibraries.begin(), buildOutput.staticLibraries.end());
+    std::sort(buildOutput.headers.begin(), buildOutput.headers.end());
+    std::sort(buildOutput.pkgConfigFiles.begin(), buildOutput.pkgConfigFiles.end());
+    return buildOutput;
+}
+
+std::string PackageCommand::createPkgConfigContent(const BuildOutput & buildOutput)
+{
+    const std::map<std::string,std::string> & createOptions = m_options.getCreateCommandOptions();
+    const std::string & pkgName = createOptions.at("packagename");
+    std::string libPrefix = "${prefix}/lib/" + m_options.getArchitecture();
+    std::string sharedLibFolder = m_options.packageIgnoreMode() ? libPrefix + "/shared/" + m_options.getConfig() : "${libdir}";
+    std::string staticLibFolder = m_options.packageIgnoreMode() ? libPrefix + "/static/" + m_options.getConfig() : "${libdir}";
+
+    std::string ldflags, libflags, cflags;
+    std::set<std::string> linkedLibraries;
+    for (auto & library : buildOutput.sharedLibraries) {
+        // versioned libraries (libfoo.so.1.2) are only packaged : links use libfoo.so
+        if (library.extension().generic_string() == OsUtils::sharedSuffix(m_options.getOS())
+                && linkedLibraries.insert(libraryName(library, m_options.getOS())).second) {
+            ldflags += " -l" + libraryName(library, m_options.getOS());
+        }
+    }
+    if (!ldflags.empty()) {
+        ldflags = " -L" + sharedLibFolder + ldflags;
+    }
+    for (auto & library : buildOutput.staticLibraries) {
+        libflags += " " + staticLibFolder + "/${pfx}" + libraryName(library, m_options.getOS()) + ".${lext}";
+    }
+    std::set<fs::path> includeFolders;
+    for (auto & [header, includeFolder] : buildOutput.headers) {
+        if (includeFolders.insert(includeFolder).second) {
+            fs::detail::utf8_codecvt_facet utf8;
+            cflags += " -I${includedir}";
+            if (!includeFolder.empty()) {
+                cflags += "/" + includeFolder.generic_string(utf8);
+            }
         }
+    }
 
+    std::ostringstream content;
+    content << "libname=" << pkgName << std::endl;
+    content << "prefix=/usr/local" << std::endl;
+    content << "exec_prefix=${prefix}" << std::endl;
+    content << "libdir=${exec_prefix}/lib" << std::endl;
+    content << "includedir=${prefix}/interfaces" << std::endl;
+    content << std::endl;
+    content << "Name: " << pkgName << std::endl;
+    content << "Description: " << std::endl;
+    content << "Version: " << createOptions.at("packageversion") << std::endl;
+    content << "Requires:" << std::endl;
+    content << "Libs:" << ldflags << std::endl;
+    content << "Libs.private:" << libflags << std::endl;
+    content << "Cflags:" << cflags << std::endl;
+    return content.str();
+}
+
+int PackageCommand::create()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    const std::map<std::string,std::string> & createOptions = m_options.getCreateCommandOptions();
+    const std::string & pkgName = createOptions.at("packagename");
+    const std::string & pkgVersion = createOptions.at("packageversion");
+    fs::path sourceFolder = fs::absolute(fs::path(createOptions.at("sourcedir"), utf8)).lexically_normal();
+    if (!fs::is_directory(sourceFolder)) {
+        BOOST_LOG_TRIVIAL(error)<<"Product root folder "<<sourceFolder<<" doesn't exist";
+        return -1;
     }
-    return 0;
+    fs::path libFolder = (sourceFolder / fs::path(createOptions.at("libdir"), utf8)).lexically_normal();
+    fs::path includeFolder = (sourceFolder / fs::path(createOptions.at("includedir"), utf8)).lexically_normal();
+    fs::path pkgRootFolder = fs::absolute(fs::path(createOptions.at("destination"), utf8)) / pkgName / pkgVersion;
+
+    BuildOutput buildOutput = scanBuildOutput(sourceFolder, libFolder, includeFolder);
+    if (m_options.packageUseOriginalPCfiles() && buildOutput.pkgConfigFiles.empty()) {
+        BOOST_LOG_TRIVIAL(error)<<"No original pkgconfig file found in "<<sourceFolder;
+        return -1;
+    }
+    fs::path interfacesFolder = pkgRootFolder / "interfaces";
+    fs::path sharedLibFolder = pkgRootFolder / "lib" / m_options.getArchitecture() / "shared" / m_options.getConfig();
+    fs::path staticLibFolder = pkgRootFolder / "lib" / m_options.getArchitecture() / "static" / m_options.getConfig();
+    fs::create_directories(pkgRootFolder);
+    for (auto & [header, includeSubFolder] : buildOutput.headers) {
+        fs::create_directories(interfacesFolder / includeSubFolder);
+    }
+    if (!buildOutput.sharedLibraries.empty()) {
+        fs::create_directories(sharedLibFolder);
+    }
+    if (!buildOutput.staticLibraries.empty()) {
+        fs::create_directories(staticLibFolder);
+    }
+
+    std::mutex outputMutex;
+    bool bFailed = false;
+    auto copyTask = [&](const std::function<void()> & copy, const fs::path & sourcePath) {
+        try {
+            copy();
+        }
+        catch (const std::exception & e) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            bFailed = true;
+            BOOST_LOG_TRIVIAL(error)<<"==> Unable to copy "<<sourcePath.generic_string(utf8)<<" : "<<e.what();
+        }
+    };
+    boost::asio::thread_pool pool(HashUtils::defaultJobs());
+    for (auto & [header, includeSubFolder] : buildOutput.headers) {
+        boost::asio::post(pool, [&, &header = header, &includeSubFolder = includeSubFolder]() {
+            copyTask([&]() {
+                OsUtils::copyFile(header, interfacesFolder / includeSubFolder / header.filename());
+            }, header);
+        });
+    }
+    for (auto & library : buildOutput.sharedLibraries) {
+        boost::asio::post(pool, [&]() {
+            copyTask([&]() { OsUtils::copyLibrary(library, sharedLibFolder, OsUtils::sharedSuffix(m_options.getOS()), true); }, library);
+        });
+    }
+    for (auto & library : buildOutput.staticLibraries) {
+        boost::asio::post(pool, [&]() {
+            copyTask([&]() { OsUtils::copyLibrary(library, staticLibFolder, OsUtils::staticSuffix(m_options.getOS()), true); }, library);
+        });
+    }
+    pool.join();
+    if (bFailed) {
+        return -1;
+    }
+
+    if (m_options.packageUseOriginalPCfiles()) {
+        for (auto & pkgConfigFile : buildOutput.pkgConfigFiles) {
+            fs::copy_file(pkgConfigFile, pkgRootFolder / pkgConfigFile.filename(), fs::copy_options::overwrite_existing);
+        }
+    }
+    else {
+        std::string pkgConfigFileName = Constants::REMAKEN_PKGCONFIG_PREFIX;
+        if (!createOptions.at("withsuffix").empty()) {
+            pkgConfigFileName += m_options.getConfig() + "-";
+        }
+        pkgConfigFileName += pkgName + ".pc";
+        OsUtils::writeFileIfChanged(pkgRootFolder / pkgConfigFileName, createPkgConfigContent(buildOutput));
+    }
+    fs::create_directories(pkgRootFolder / Constants::PKGINFO_FOLDER);
+    if (!buildOutput.headers.empty()) {
+        OsUtils::writeFileIfChanged(pkgRootFolder / Constants::PKGINFO_FOLDER / ".headers", "");
+    }
+    if (!buildOutput.sharedLibraries.empty() || !buildOutput.staticLibraries.empty()) {
+        OsUtils::writeFileIfChanged(pkgRootFolder / Constants::PKGINFO_FOLDER / ".lib", "");
+    }
+    std::cout<<"===> "<<pkgName<<":"<<pkgVersion<<" created in "<<pkgRootFolder.generic_string(utf8)<<" : "
+            <<buildOutput.headers.size()<<" headers, "
+            <<buildOutput.sharedLibraries.size()<<" shared libraries, "
+            <<buildOutput.staticLibraries.size()<<" static libraries"<<std::endl;
+
+    if (createOptions.at("archivedestination").empty()) {
+        return 0;
+    }
+    fs::path archiveFolder = fs::absolute(fs::path(createOptions.at("archivedestination"), utf8)).lexically_normal();
+    return compressVariants(collectVariants(pkgRootFolder, archiveFolder), archiveFolder);
 }
 
 int PackageCommand::execute()
@@ -116,6 +532,9 @@ int PackageCommand::execute()
     if (subCommand == "compress") {
         return compress();
     }
+    if (subCommand == "create") {
+        return create();
+    }
     // no subcommand, process package command
     // auto mgr = DependencyManager{m_options};
     //return mgr.bundle();
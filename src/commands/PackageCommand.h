@@ -25,6 +25,9 @@
 
 #include "AbstractCommand.h"
 #include "CmdOptions.h"
+#include <string>
+#include <utility>
+#include <vector>
 
 class PackageCommand : public AbstractCommand
 {
@@ -34,8 +37,35 @@ public:
     static constexpr const char * NAME="package";
 
 private:
+    typedef struct {
+        std::string name; // pkg_version_architecture_mode_config
+        fs::path archivePath;
+        // source files and their path relative to the archive root
+        std::vector<std::pair<fs::path, fs::path>> files;
+        // .pkginfo markers to create when the package has no .pkginfo folder
+        std::vector<fs::path> pkgInfoMarkers;
+    } PackageVariant;
+
+    // build output files found for remaken package create
+    typedef struct {
+        std::vector<fs::path> sharedLibraries;
+        std::vector<fs::path> staticLibraries;
+        // header files and their folder relative to the include folder
+        std::vector<std::pair<fs::path, fs::path>> headers;
+        std::vector<fs::path> pkgConfigFiles;
+    } BuildOutput;
+
     int compress();
-    void compressFolder(fs::path folderPath);
+    int create();
+    BuildOutput scanBuildOutput(const fs::path & sourceFolder, const fs::path & libFolder, const fs::path & includeFolder);
+    std::string createPkgConfigContent(const BuildOutput & buildOutput);
+    std::vector<PackageVariant> collectVariants(const fs::path & pkgVersionFolder, const fs::path & destinationFolder);
+    // hash of the variant files list (relative path, size and modification time)
+    static std::string computeManifestHash(const PackageVariant & variant);
+    static fs::path manifestHashPath(const PackageVariant & variant, const fs::path & destinationFolder);
+    static void compressVariant(const PackageVariant & variant, const fs::path & destinationFolder, const std::string & manifestHash);
+    // compresses the variants on a thread pool, skipping the variants whose archive is up to date
+    int compressVariants(const std::vector<PackageVariant> & variants, const fs::path & destinationFolder);
     const CmdOptions & m_options;
 };
 
@@ -1,11 +1,11 @@
 #include "RunCommand.h"
 #include "utils/DepUtils.h"
-#include "managers/XpcfXmlManager.h"
+#include "managers/RunEnvironmentManager.h"
 #include "utils/OsUtils.h"
+#include "utils/Trace.h"
 #include <boost/log/trivial.hpp>
 #include <boost/process.hpp>
 #include <boost/algorithm/string.hpp>
-#include "FileHandlerFactory.h"
 #include <memory>
 
 
@@ -97,51 +97,24 @@ int RunCommand::execute()
         findBinary(pkgName, pkgVersion);
     }
 
-    std::vector<Dependency> deps;
     std::vector<fs::path> libPaths;
-    if (!m_xpcfXmlFile.empty()) {
-        XpcfXmlManager xpcfManager(m_options);
-        try {
-            fs::path xpcfConfigFilePath = DepUtils::buildDependencyPath(m_xpcfXmlFile.generic_string(utf8));
+    try {
+        fs::path xpcfConfigFilePath;
+        if (!m_xpcfXmlFile.empty()) {
+            xpcfConfigFilePath = DepUtils::buildDependencyPath(m_xpcfXmlFile.generic_string(utf8));
             if ( xpcfConfigFilePath.extension() != ".xml") {
                 return -1;
             }
-            const std::map<std::string, fs::path> & modulesPathMap = xpcfManager.parseXpcfModulesConfiguration(xpcfConfigFilePath);
-
-            for (auto & [name,modulePath] : modulesPathMap) {
-                fs::path packageRootPath = XpcfXmlManager::findPackageRoot(modulePath, m_options.getVerbose());
-                if (!fs::exists(packageRootPath)) {
-                    BOOST_LOG_TRIVIAL(warning)<<"Unable to find root package path "<<packageRootPath<<" for module "<<name<<" path="<<modulePath;
-                }
-                // The following line should not be needed mandatory as xpcf loads dynamically the modules
-                // libPaths.push_back(modulePath);
-                if (fs::exists(packageRootPath/"packagedependencies.txt")) {
-                    DepUtils::parseRecurse(packageRootPath/"packagedependencies.txt",m_options,deps);
-                }
-                else {
-                    BOOST_LOG_TRIVIAL(warning)<<"Unable to find packagedependencies.txt file in package path"<<packageRootPath<<" for module "<<name;
-                }
-            }
         }
-        catch (const std::runtime_error & e) {
-            BOOST_LOG_TRIVIAL(error)<<e.what();
-            return -1;
+        RunEnvironmentManager runEnvManager(m_options);
+        libPaths = runEnvManager.libPaths(m_applicationFile, xpcfConfigFilePath, m_depsFile);
+        if (!m_options.getRunLinkLibsMode().empty()) {
+            libPaths = { runEnvManager.linkLibraries(m_options.getRunLinkLibsMode()) };
         }
     }
-
-    if (!m_depsFile.empty()) {
-        DepUtils::parseRecurse(m_depsFile, m_options, deps);
-    }
-    // std::cout<<"Exhaustive deps list:"<<std::endl;
-    std::map<std::string,Dependency> depsMap;
-    for (auto dependency : deps) {//filter redundant deps
-        //std::cout<<dependency.toString()<<std::endl;
-        depsMap.insert_or_assign(dependency.getName()+dependency.getVersion(), dependency);
-    }
-    for (auto & [name,dependency]: depsMap) {
-        shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(dependency, m_options);
-        std::vector<fs::path> paths = fileRetriever->libPaths(dependency);
-        libPaths.insert(libPaths.end(),paths.begin(), paths.end());
+    catch (const std::runtime_error & e) {
+        BOOST_LOG_TRIVIAL(error)<<e.what();
+        return -1;
     }
 
     std::string SharedLibraryPathEnvName(OsUtils::sharedLibraryPathEnvName(m_options.getOS()));
@@ -153,8 +126,7 @@ int RunCommand::execute()
         // display results
         std::string result;
         std::cout<<SharedLibraryPathEnvName<<"=";
-        for (auto path: libPaths) {
-            fs::detail::utf8_codecvt_facet utf8;
+        for (auto & path: libPaths) {
             result += path.generic_string(utf8) + envSeparator;
         }
         std::cout<<result<<envPrefix<<SharedLibraryPathEnvName<<envSuffix<<std::endl;
@@ -200,7 +172,6 @@ int RunCommand::execute()
         auto env = boost::this_process::environment();
         bp::environment runEnv = env;
         for (auto & path: libPaths) {
-            fs::detail::utf8_codecvt_facet utf8;
             runEnv[SharedLibraryPathEnvName] += path.generic_string(utf8);
         }
         std::vector<std::string> parsedArgs;
@@ -214,6 +185,7 @@ int RunCommand::execute()
             parsedArgs.push_back(argument);
         }
 
+        Trace::Span span("process", m_applicationFile.filename().generic_string(utf8));
         result = bp::system(m_applicationFile, bp::args(parsedArgs), runEnv);
     }
 
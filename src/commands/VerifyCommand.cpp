@@ -0,0 +1,162 @@
+#include "VerifyCommand.h"
+#include "Constants.h"
+#include "FileHandlerFactory.h"
+#include "utils/DepUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/OsUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+
+VerifyCommand::VerifyCommand(const CmdOptions & options):AbstractCommand(VerifyCommand::NAME),m_options(options)
+{
+}
+
+std::vector<VerifyCommand::InstalledPackage> VerifyCommand::findPackages(const std::string & pkgName, const std::string & pkgVersion)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::vector<InstalledPackage> packages;
+    fs::path remakenRootPackagesPath = OsUtils::computeRemakenRootPackageDir(m_options);
+    if (!fs::exists(remakenRootPackagesPath)) {
+        return packages;
+    }
+    for (fs::recursive_directory_iterator it(remakenRootPackagesPath), end; it != end; ++it) {
+        if (!fs::is_directory(it->path()) || !fs::exists(PackageManifest::manifestPath(it->path()))) {
+            continue;
+        }
+        // package root found : its content is described by the manifest
+        it.disable_recursion_pending();
+        std::string versionStr = it->path().filename().generic_string(utf8);
+        std::string nameStr = it->path().parent_path().filename().generic_string(utf8);
+        if ((!pkgName.empty() && nameStr != pkgName) || (!pkgVersion.empty() && versionStr != pkgVersion)) {
+            continue;
+        }
+        InstalledPackage package;
+        package.root = it->path();
+        package.manifest.load(package.root);
+        packages.push_back(std::move(package));
+    }
+    return packages;
+}
+
+void VerifyCommand::verifyPackages(std::vector<InstalledPackage> & packages)
+{
+    // missing files and size mismatches are detected without hashing :
+    // every remaining file of every package is then hashed on the same thread pool
+    fs::detail::utf8_codecvt_facet utf8;
+    std::vector<fs::path> filesToHash;
+    std::vector<std::pair<std::size_t, const PackageManifest::FileEntry *>> hashedEntries;
+    for (std::size_t index = 0; index < packages.size(); index++) {
+        InstalledPackage & package = packages[index];
+        for (auto & entry : package.manifest.files()) {
+            fs::path filePath = package.root / fs::path(entry.relativePath, utf8);
+            boost::system::error_code ec;
+            if (!fs::is_regular_file(filePath, ec)) {
+                std::cout<<"[MISSING]: "<<filePath.generic_string(utf8)<<std::endl;
+                package.damagedFiles.push_back(entry);
+            }
+            else if (fs::file_size(filePath, ec) != entry.size) {
+                std::cout<<"[MODIFIED]: "<<filePath.generic_string(utf8)<<" (size)"<<std::endl;
+                package.damagedFiles.push_back(entry);
+            }
+            else {
+                filesToHash.push_back(filePath);
+                hashedEntries.push_back({index, &entry});
+            }
+        }
+    }
+    std::vector<std::string> hashes = HashUtils::sha256Files(filesToHash);
+    for (std::size_t i = 0; i < hashes.size(); i++) {
+        auto & [index, entry] = hashedEntries[i];
+        if (hashes[i] != entry->hash) {
+            std::cout<<"[MODIFIED]: "<<filesToHash[i].generic_string(utf8)<<std::endl;
+            packages[index].damagedFiles.push_back(*entry);
+        }
+    }
+}
+
+bool VerifyCommand::repairPackage(const InstalledPackage & package)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    if (package.manifest.dependencyDescription().empty()) {
+        BOOST_LOG_TRIVIAL(error)<<"==> No dependency description found in "<<PackageManifest::manifestPath(package.root);
+        return false;
+    }
+    Dependency dependency(package.manifest.dependencyDescription(), m_options.getMode());
+    std::string installKey = PackageManifest::installKey(m_options, dependency.getMode());
+    if (package.manifest.installKeys().count(installKey) == 0) {
+        std::string installedKeys = boost::algorithm::join(package.manifest.installKeys(), ", ");
+        BOOST_LOG_TRIVIAL(error)<<"==> "<<dependency.getName()<<":"<<dependency.getVersion()<<" was not installed for "<<installKey
+                               <<" : repair it with the --architecture and --config options matching one of ["<<installedKeys<<"]";
+        return false;
+    }
+    // only the files of the reinstalled archive are repaired : damaged files of other install keys are left as is
+    std::set<std::string> otherInstallKeys;
+    std::size_t repairableFiles = 0;
+    for (auto & entry : package.damagedFiles) {
+        if (entry.installKeys.count(installKey) == 0) {
+            std::cout<<"[NOT REPAIRED]: "<<(package.root / fs::path(entry.relativePath, utf8)).generic_string(utf8)<<" belongs to "<<boost::algorithm::join(entry.installKeys, ", ")<<std::endl;
+            otherInstallKeys.insert(entry.installKeys.begin(), entry.installKeys.end());
+            continue;
+        }
+        // damaged files are removed first : the archive extraction doesn't always replace existing files
+        boost::system::error_code ec;
+        fs::remove(package.root / fs::path(entry.relativePath, utf8), ec);
+        repairableFiles++;
+    }
+    if (repairableFiles > 0) {
+        std::cout<<"=> Repairing "<<dependency.getName()<<":"<<dependency.getVersion()<<" from "<<dependency.getBaseRepository()<<std::endl;
+        std::shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(dependency, m_options);
+        fileRetriever->installArtefact(dependency);
+    }
+    if (!otherInstallKeys.empty()) {
+        BOOST_LOG_TRIVIAL(error)<<"==> "<<package.damagedFiles.size() - repairableFiles<<" damaged files of "<<dependency.getName()<<":"<<dependency.getVersion()
+                               <<" belong to other install keys and were not repaired : repair them with the --architecture and --config options matching one of ["<<boost::algorithm::join(otherInstallKeys, ", ")<<"]";
+        return false;
+    }
+    return true;
+}
+
+int VerifyCommand::execute()
+{
+    std::vector<std::string> refParts;
+    boost::split(refParts, m_options.getVerifyPackageRef(), [](char c){return c == ':';});
+    std::string pkgName = refParts[0];
+    std::string pkgVersion = (refParts.size() > 1) ? refParts[1] : "";
+
+    fs::detail::utf8_codecvt_facet utf8;
+    std::vector<InstalledPackage> packages = findPackages(pkgName, pkgVersion);
+    if (packages.empty()) {
+        if (!pkgName.empty() && !pkgVersion.empty() && !DepUtils::findPackageFolder(m_options, pkgName, pkgVersion).empty()) {
+            BOOST_LOG_TRIVIAL(error)<<"==> "<<pkgName<<":"<<pkgVersion<<" has no install manifest : reinstall it with --force to verify it later";
+            return -1;
+        }
+        std::cout<<"===> No installed package with an install manifest found"<<std::endl;
+        return pkgName.empty() ? 0 : -1;
+    }
+    verifyPackages(packages);
+
+    int result = 0;
+    for (auto & package : packages) {
+        std::string packageRef = package.root.parent_path().filename().generic_string(utf8) + ":" + package.root.filename().generic_string(utf8);
+        if (package.damagedFiles.empty()) {
+            std::cout<<"===> "<<packageRef<<" : "<<package.manifest.files().size()<<" files verified"<<std::endl;
+            continue;
+        }
+        std::cout<<"===> "<<packageRef<<" : "<<package.damagedFiles.size()<<" missing or modified files"<<std::endl;
+        if (!m_options.verifyRepair()) {
+            result = -1;
+            continue;
+        }
+        try {
+            if (!repairPackage(package)) {
+                result = -1;
+            }
+        }
+        catch (const std::runtime_error & e) {
+            BOOST_LOG_TRIVIAL(error)<<"==> Unable to repair "<<packageRef<<" : "<<e.what();
+            result = -1;
+        }
+    }
+    return result;
+}
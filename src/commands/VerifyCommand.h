@@ -0,0 +1,49 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @date 2026-10-19
+ */
+
+#ifndef VERIFYCOMMAND_H
+#define VERIFYCOMMAND_H
+
+#include "AbstractCommand.h"
+#include "CmdOptions.h"
+#include "utils/PackageManifest.h"
+
+class VerifyCommand : public AbstractCommand
+{
+public:
+    VerifyCommand(const CmdOptions & options);
+    int execute() override;
+    static constexpr const char * NAME="verify";
+
+private:
+    typedef struct {
+        fs::path root;
+        PackageManifest manifest;
+        std::vector<PackageManifest::FileEntry> damagedFiles;
+    } InstalledPackage;
+
+    std::vector<InstalledPackage> findPackages(const std::string & pkgName, const std::string & pkgVersion);
+    void verifyPackages(std::vector<InstalledPackage> & packages);
+    bool repairPackage(const InstalledPackage & package);
+    const CmdOptions & m_options;
+};
+
+#endif
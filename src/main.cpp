@@ -16,6 +16,10 @@
 #include "commands/RemoteCommand.h"
 #include "commands/RunCommand.h"
 #include "commands/SearchCommand.h"
+#include "commands/VerifyCommand.h"
+#include "utils/DependencyFileCache.h"
+#include "utils/Stats.h"
+#include "utils/Trace.h"
 #include <memory>
 
 using namespace std;
@@ -29,6 +33,13 @@ int main(int argc, char** argv)
         if (auto result = opts.parseArguments(argc,argv); result != CmdOptions::OptionResult::RESULT_SUCCESS ) {
             return static_cast<int>(result);
         }
+        DependencyFileCache::setCacheFolder(opts.getRemakenRoot() / Constants::REMAKEN_DEPS_CACHE_FOLDER);
+        if (!opts.getTraceFile().empty()) {
+            Trace::start(fs::absolute(opts.getTraceFile()));
+        }
+        if (!opts.getStatsFile().empty()) {
+            Stats::start();
+        }
         dispatcher["clean"] = make_shared<CleanCommand>(opts);
         dispatcher["configure"] = make_shared<ConfigureCommand>(opts);
         dispatcher["init"] = make_shared<InitCommand>(opts);
@@ -43,9 +54,17 @@ int main(int argc, char** argv)
         dispatcher["profile"] = make_shared<ProfileCommand>(opts);
         dispatcher["remote"] = make_shared<RemoteCommand>(opts);
         dispatcher["search"] = make_shared<SearchCommand>(opts);
+        dispatcher["verify"] = make_shared<VerifyCommand>(opts);
         dispatcher["version"] = make_shared<VersionCommand>();
         if (mapContains(dispatcher, opts.getAction())) {
-            return dispatcher.at(opts.getAction())->execute();
+            int result = -1;
+            {
+                Trace::Span span("command", opts.getAction());
+                result = dispatcher.at(opts.getAction())->execute();
+            }
+            Trace::stop();
+            Stats::stop(opts.getAction(), opts.getStatsFile());
+            return result;
         }
         else {
             return -1;
@@ -53,6 +72,8 @@ int main(int argc, char** argv)
         return 0;
     }
     catch (std::runtime_error & e) {
+        Trace::stop();
+        Stats::stop(opts.getAction(), opts.getStatsFile());
         std::cout << "ERROR: "<<e.what() << std::endl;
         opts.printUsage();
     }
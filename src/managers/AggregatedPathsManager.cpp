@@ -0,0 +1,147 @@
+#include "AggregatedPathsManager.h"
+#include "Constants.h"
+#include "utils/DepUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <vector>
+
+// folders already searched by the compiler and linker : aggregating them would break #include_next and default search orders
+static const std::vector<std::string> systemFolders = {"/usr/include", "/usr/local/include", "/lib", "/lib64", "/usr/lib", "/usr/lib64", "/usr/local/lib"};
+
+std::map<fs::path, AggregatedPathsManager::Node> AggregatedPathsManager::m_roots;
+
+AggregatedPathsManager::AggregatedPathsManager(const CmdOptions & options):m_options(options)
+{
+    fs::path buildProjectSubFolderPath = DepUtils::getProjectBuildSubFolder(m_options);
+    m_includeRoot = buildProjectSubFolderPath / Constants::REMAKEN_AGGREGATED_INCLUDE_FOLDER;
+    m_libRoot = buildProjectSubFolderPath / Constants::REMAKEN_AGGREGATED_LIB_FOLDER;
+}
+
+bool AggregatedPathsManager::addIncludePath(const fs::path & includePath)
+{
+    return addPath(includePath, m_includeRoot, "header");
+}
+
+bool AggregatedPathsManager::addLibPath(const fs::path & libPath)
+{
+    return addPath(libPath, m_libRoot, "library");
+}
+
+bool AggregatedPathsManager::addPath(const fs::path & sourcePath, const fs::path & rootPath, const std::string & kind)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    if (!sourcePath.is_absolute() || !fs::is_directory(sourcePath, ec)) {
+        return false;
+    }
+    fs::path normalizedPath = sourcePath.lexically_normal();
+    std::string pathStr = normalizedPath.generic_string(utf8);
+    if (!pathStr.empty() && pathStr.back() == '/') {
+        pathStr.pop_back();
+    }
+    if (std::find(systemFolders.begin(), systemFolders.end(), pathStr) != systemFolders.end()) {
+        return false;
+    }
+    try {
+        // work on a copy : a failing path leaves the root content unchanged
+        Node root = m_roots[rootPath];
+        mergeFolder(normalizedPath, root, fs::path(), kind);
+        m_roots[rootPath] = std::move(root);
+    }
+    catch (const fs::filesystem_error & e) {
+        BOOST_LOG_TRIVIAL(warning)<<"Unable to aggregate "<<sourcePath<<" in "<<rootPath<<" : "<<e.what();
+        return false;
+    }
+    return true;
+}
+
+void AggregatedPathsManager::mergeFolder(const fs::path & sourceFolder, Node & folder, const fs::path & relativePath, const std::string & kind)
+{
+    // sorted entries : the aggregated tree doesn't depend on the directory listing order
+    std::vector<fs::path> entries;
+    for (fs::directory_entry& x : fs::directory_iterator(sourceFolder)) {
+        entries.push_back(x.path());
+    }
+    std::sort(entries.begin(), entries.end());
+    for (auto & entry : entries) {
+        boost::system::error_code ec;
+        auto it = folder.children.find(entry.filename());
+        if (it == folder.children.end()) {
+            folder.children[entry.filename()] = std::make_shared<Node>(Node{entry, {}});
+            continue;
+        }
+        // copy on write : nodes may be shared with a previous copy of the root
+        Node child = *it->second;
+        if (!child.target.empty() && fs::equivalent(child.target, entry, ec)) {
+            // same folder or file provided twice
+            continue;
+        }
+        if (fs::is_directory(entry) && (child.target.empty() || fs::is_directory(child.target))) {
+            if (!child.target.empty()) {
+                // replace the folder link with a real folder merging both contents
+                fs::path linkedFolder = child.target;
+                child.target.clear();
+                mergeFolder(linkedFolder, child, relativePath / entry.filename(), kind);
+            }
+            mergeFolder(entry, child, relativePath / entry.filename(), kind);
+            it->second = std::make_shared<Node>(std::move(child));
+            continue;
+        }
+        // first path wins, as it would with the compiler/linker search order
+        BOOST_LOG_TRIVIAL(warning)<<"Aggregated "<<kind<<" collision: "<<relativePath / entry.filename()<<" is provided by "
+                                 <<(child.target.empty() ? "several folders" : child.target.generic_string())<<" and "<<entry<<" - using the first one";
+    }
+}
+
+void AggregatedPathsManager::updateFolder(const Node & folder, const fs::path & folderPath)
+{
+    boost::system::error_code ec;
+    fs::file_status status = fs::symlink_status(folderPath, ec);
+    if (fs::exists(status) && !fs::is_directory(status)) {
+        fs::remove(folderPath);
+    }
+    fs::create_directories(folderPath);
+    std::vector<fs::path> obsoleteEntries;
+    for (fs::directory_entry& x : fs::directory_iterator(folderPath)) {
+        if (folder.children.find(x.path().filename()) == folder.children.end()) {
+            obsoleteEntries.push_back(x.path());
+        }
+    }
+    for (auto & entry : obsoleteEntries) {
+        // removes links, not the linked dependencies files
+        fs::remove_all(entry);
+    }
+    for (auto & [name, child] : folder.children) {
+        fs::path entryPath = folderPath / name;
+        if (child->target.empty()) {
+            updateFolder(*child, entryPath);
+            continue;
+        }
+        if (fs::is_symlink(entryPath, ec) && fs::read_symlink(entryPath, ec) == child->target) {
+            continue;
+        }
+        if (fs::exists(fs::symlink_status(entryPath, ec))) {
+            fs::remove_all(entryPath);
+        }
+        fs::create_symlink(child->target, entryPath);
+    }
+}
+
+void AggregatedPathsManager::update(const CmdOptions & options)
+{
+    AggregatedPathsManager aggregatedPaths(options);
+    for (auto & rootPath : {aggregatedPaths.includeRoot(), aggregatedPaths.libRoot()}) {
+        if (!mapContains(m_roots, rootPath)) {
+            fs::remove_all(rootPath);
+            continue;
+        }
+        try {
+            updateFolder(m_roots.at(rootPath), rootPath);
+        }
+        catch (const fs::filesystem_error & e) {
+            BOOST_LOG_TRIVIAL(warning)<<"Unable to update the aggregated folder "<<rootPath<<" : "<<e.what();
+        }
+    }
+    m_roots.clear();
+}
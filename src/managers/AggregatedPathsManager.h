@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @date 2026-10-19
+ */
+
+
+#ifndef AGGREGATEDPATHSMANAGER_H
+#define AGGREGATEDPATHSMANAGER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "CmdOptions.h"
+
+namespace fs = boost::filesystem;
+
+// Builds per-project include and lib folders made of links to the dependencies folders,
+// so that generated build files only reference these two roots.
+// Folders are merged : a folder provided by several dependencies becomes a real folder of links.
+// The folders content is gathered in memory from every generator, then update() only applies the differences
+// with the folders of the previous configuration : unchanged links are kept.
+class AggregatedPathsManager
+{
+public:
+    AggregatedPathsManager(const CmdOptions & options);
+    const fs::path & includeRoot() const { return m_includeRoot; }
+    const fs::path & libRoot() const { return m_libRoot; }
+    // links the content of includePath in the include root.
+    // returns false when the path is not aggregated (compiler system folders, missing folder) : the path must then be used as is
+    bool addIncludePath(const fs::path & includePath);
+    bool addLibPath(const fs::path & libPath);
+    // updates the project include and lib folders from the paths added since the previous update.
+    // Folders without any added path are removed
+    static void update(const CmdOptions & options);
+
+private:
+    // aggregated entry : a link to a dependency file or folder, or a folder merging several dependencies folders (empty target)
+    struct Node {
+        fs::path target;
+        std::map<fs::path, std::shared_ptr<Node>> children;
+    };
+
+    bool addPath(const fs::path & sourcePath, const fs::path & rootPath, const std::string & kind);
+    static void mergeFolder(const fs::path & sourceFolder, Node & folder, const fs::path & relativePath, const std::string & kind);
+    static void updateFolder(const Node & folder, const fs::path & folderPath);
+    fs::path m_includeRoot;
+    fs::path m_libRoot;
+    const CmdOptions & m_options;
+    // root path -> content added by the generators
+    static std::map<fs::path, Node> m_roots;
+};
+
+#endif // AGGREGATEDPATHSMANAGER_H
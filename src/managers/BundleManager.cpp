@@ -9,9 +9,12 @@
 #include <future>
 #include "tools/SystemTools.h"
 #include "utils/DepUtils.h"
+#include "utils/BundleEngine.h"
+#include "utils/DependencyFileParser.h"
 #include "utils/OsUtils.h"
 #include <boost/log/trivial.hpp>
 #include <regex>
+#include <sstream>
 
 using namespace std;
 using std::placeholders::_1;
@@ -32,54 +35,55 @@ void BundleManager::parseIgnoreInstall(const fs::path &  filepath)
 {
     std::vector<fs::path> ignoreFileList = DepUtils::getChildrenDependencies(filepath.parent_path(), m_options.getOS(), "packageignoreinstall");
     for (fs::path & ignoreFile : ignoreFileList) {
-        if (fs::exists(ignoreFile)) {
-            ifstream fis(ignoreFile.generic_string(),ios::in);
-            while (!fis.eof()) {
-                string curStr;
-                getline(fis,curStr);
-                if (!curStr.empty()) {
-                    std::string commentRegexStr = "^[ \t]*//";
-                    std::regex commentRegex(commentRegexStr, std::regex_constants::extended);
-                    std::smatch sm;
-                    // parsing finds commented lines
-                    if (!std::regex_search(curStr, sm, commentRegex, std::regex_constants::match_any)) {
-                        // line is not commented: parsing the package name
-                        boost::trim(curStr);
-                        m_ignoredPackages[curStr] = true;
-                    }
-                    else {
-                        std::cout<<"[IGNORED]: line '"<<curStr<<"' is commented !"<<std::endl;
-                    }
-                }
-            }
-            fis.close();
+        for (auto & package : DependencyFileParser::parsePackageList(ignoreFile)) {
+            m_ignoredPackages[package] = true;
         }
     }
 }
 
+void BundleManager::collectDependencies(BundleEngine & engine)
+{
+    if (!fs::exists(m_options.getDestinationRoot())) {
+        fs::create_directory(m_options.getDestinationRoot());
+    }
+    fs::path rootPath = buildDependencyPath();
+    fs::path extradeps;
+    if (fs::is_directory(rootPath)) {
+        extradeps = rootPath / Constants::EXTRA_DEPS;
+    }
+    else {
+        extradeps = rootPath.parent_path() / Constants::EXTRA_DEPS;
+    }
+    bundleDependencies(extradeps, engine, DependencyFileType::EXTRA_DEPS);
+    bundleDependencies(rootPath, engine);
+}
+
+void BundleManager::addTargets(BundleEngine & engine)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    for (auto & target : m_options.getBundleTargets()) {
+        fs::path targetPath = fs::absolute(fs::path(target, utf8));
+        if (!fs::is_regular_file(targetPath)) {
+            throw std::runtime_error("Error : bundle target " + targetPath.generic_string(utf8) + " not found");
+        }
+        engine.addTarget(targetPath);
+    }
+}
+
 int BundleManager::bundle()
 {
     try {
-        if (!fs::exists(m_options.getDestinationRoot())) {
-            fs::create_directory(m_options.getDestinationRoot());
-        }
-        fs::path rootPath = buildDependencyPath();
-        fs::path extradeps;
-        if (fs::is_directory(rootPath)) {
-            extradeps = rootPath / Constants::EXTRA_DEPS;
-        }
-        else {
-            extradeps = rootPath.parent_path() / Constants::EXTRA_DEPS;
-        }
-        bundleDependencies(extradeps, DependencyFileType::EXTRA_DEPS);
-        bundleDependencies(rootPath);
+        BundleEngine engine(m_options);
+        addTargets(engine);
+        collectDependencies(engine);
+        engine.run();
     }
     catch (const std::runtime_error & e) {
         BOOST_LOG_TRIVIAL(error)<<e.what();
         return -1;
     }
 
-#ifndef BOOST_OS_WINDOWS_AVAILABLE
+#ifdef BOOST_OS_MACOS_AVAILABLE
     BOOST_LOG_TRIVIAL(warning)<<"bundle command under implementation : rpath not reinterpreted after copy";
 #endif
     return 0;
@@ -88,12 +92,14 @@ int BundleManager::bundle()
 int BundleManager::bundleXpcf()
 {
     try {
+        BundleEngine engine(m_options);
+        addTargets(engine);
         // create bundle modules directory
         if (!fs::exists(m_options.getDestinationRoot()/m_options.getModulesSubfolder())) {
             fs::create_directories(m_options.getDestinationRoot()/m_options.getModulesSubfolder());
         }
         m_options.verboseMessage("=> bundling direct dependencies");
-        bundle();
+        collectDependencies(engine);
         m_options.verboseMessage("=> bundling XPCF modules dependencies");
         fs::path xpcfConfigFilePath = DepUtils::buildDependencyPath(m_options.getXpcfXmlFile());
         if ( xpcfConfigFilePath.extension() != ".xml") {
@@ -115,27 +121,44 @@ int BundleManager::bundleXpcf()
             }
             m_options.verboseMessage("--------------- Remaken bundleXpcf ---------------");
             m_options.verboseMessage("===> bundling from : " + modulePath.generic_string(utf8));
-            OsUtils::copySharedLibraries(modulePath,m_options);
+            engine.setOrigin(name);
+            engine.addSharedLibraries(modulePath);
+            if (m_options.bundleNeededOnly()) {
+                // xpcf loads the module library from its decorated name
+                fs::path moduleLibraryPath = modulePath / ("lib" + name + std::string(OsUtils::sharedSuffix(m_options.getOS())));
+                if (fs::exists(moduleLibraryPath)) {
+                    engine.addTarget(moduleLibraryPath);
+                }
+                else if (fs::exists(modulePath)) {
+                    BOOST_LOG_TRIVIAL(warning)<<"Module library "<<moduleLibraryPath<<" not found : every library of "<<modulePath<<" is needed";
+                    for (fs::directory_entry & x : fs::directory_iterator(modulePath)) {
+                        if (fs::is_regular_file(x.path()) && OsUtils::hasLibrarySuffix(x.path(), OsUtils::sharedSuffix(m_options.getOS()))) {
+                            engine.addTarget(x.path());
+                        }
+                    }
+                }
+            }
         }
 
-        for (auto & [name,modulePath] : modulesPathMap) {
-            fs::path packageRootPath = XpcfXmlManager::findPackageRoot(modulePath, m_options.getVerbose());
+        // modules sharing a package bundle its dependencies once
+        for (auto & [packageRootPath,moduleNames] : XpcfXmlManager::resolvePackageRoots(modulesPathMap, m_options.getVerbose())) {
             if (!fs::exists(packageRootPath)) {
-                BOOST_LOG_TRIVIAL(warning)<<"Unable to find root package path '"<<packageRootPath<<"' for module '"<<name<<"'";
+                BOOST_LOG_TRIVIAL(warning)<<"Unable to find root package path '"<<packageRootPath<<"' for modules '"<<boost::algorithm::join(moduleNames, ",")<<"'";
             }
             if (fs::exists(packageRootPath/"packagedependencies.txt")) {
-                bundleDependencies(packageRootPath/"packagedependencies.txt");
+                bundleDependencies(packageRootPath/"packagedependencies.txt", engine);
             }
             else {
-                BOOST_LOG_TRIVIAL(warning)<<"Unable to find packagedependencies.txt file in package path '"<<packageRootPath<<"' for module '"<<name<<"'";
+                BOOST_LOG_TRIVIAL(warning)<<"Unable to find packagedependencies.txt file in package path '"<<packageRootPath<<"' for modules '"<<boost::algorithm::join(moduleNames, ",")<<"'";
             }
         }
+        engine.run();
     }
     catch (const std::runtime_error & e) {
         BOOST_LOG_TRIVIAL(error)<<e.what();
         return -1;
     }
-#ifndef BOOST_OS_WINDOWS_AVAILABLE
+#ifdef BOOST_OS_MACOS_AVAILABLE
     BOOST_LOG_TRIVIAL(warning)<<"bundleXpcf command under implementation : rpath not reinterpreted after copy";
 #endif
     return 0;
@@ -146,22 +169,29 @@ static const std::map<DependencyFileType, std::string> typeToNameMap = {
     {DependencyFileType::EXTRA_DEPS, Constants::EXTRA_DEPS}
 };
 
-void BundleManager::bundleDependency(const Dependency & dependency, DependencyFileType type)
+void BundleManager::bundleDependency(const Dependency & dependency, BundleEngine & engine, DependencyFileType type)
 {
     fs::detail::utf8_codecvt_facet utf8;
+    // dependencies shared by several packages are only bundled once
+    std::ostringstream dependencyKey;
+    dependencyKey<<static_cast<int>(type)<<"|"<<dependency.toString();
+    if (!m_bundledDependencies.insert(dependencyKey.str()).second) {
+        return;
+    }
+    engine.setOrigin(dependency.getName() + ":" + dependency.getVersion());
     shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(dependency, m_options);
-    fs::path outputDirectory = fileRetriever->bundleArtefact(dependency);
+    fs::path outputDirectory = fileRetriever->bundleArtefact(dependency, engine);
     if (!outputDirectory.empty() && dependency.getType() == Dependency::Type::REMAKEN && m_options.recurse()) {
-        this->bundleDependencies(outputDirectory / Constants::EXTRA_DEPS,  DependencyFileType::EXTRA_DEPS);
+        this->bundleDependencies(outputDirectory / Constants::EXTRA_DEPS, engine, DependencyFileType::EXTRA_DEPS);
         if (type != DependencyFileType::EXTRA_DEPS) {
             if (dependency.getMode() != "static") {
-                this->bundleDependencies(outputDirectory / typeToNameMap.at(type), type);
+                this->bundleDependencies(outputDirectory / typeToNameMap.at(type), engine, type);
             }
         }
     }
 }
 
-void BundleManager::bundleDependencies(const fs::path &  dependenciesFile, DependencyFileType type)
+void BundleManager::bundleDependencies(const fs::path &  dependenciesFile, BundleEngine & engine, DependencyFileType type)
 {
     fs::detail::utf8_codecvt_facet utf8;
     std::vector<fs::path> dependenciesFileList = DepUtils::getChildrenDependencies(dependenciesFile.parent_path(), m_options.getOS(),dependenciesFile.stem().generic_string(utf8));
@@ -178,7 +208,7 @@ void BundleManager::bundleDependencies(const fs::path &  dependenciesFile, Depen
                         || dependency.getType() == Dependency::Type::VCPKG
                         || dependency.getType() == Dependency::Type::SYSTEM) {
                     if (!mapContains(m_ignoredPackages, dependency.getPackageName())) {
-                        bundleDependency(dependency, type);
+                        bundleDependency(dependency, engine, type);
                     }
                 }
             }
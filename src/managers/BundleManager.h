@@ -24,6 +24,7 @@
 
 #include <string>
 #include <vector>
+#include <set>
 #include <iostream>
 #include <boost/filesystem.hpp>
 #include "Dependency.h"
@@ -31,6 +32,7 @@
 #include "Cache.h"
 #include "tinyxmlhelper.h"
 #include "XpcfXmlManager.h"
+#include "utils/BundleEngine.h"
 
 namespace fs = boost::filesystem;
 
@@ -46,9 +48,14 @@ private:
     XpcfXmlManager m_xpcfManager;
     void parseIgnoreInstall(const fs::path &  dependenciesPath);
 
-    void bundleDependencies(const fs::path & dependenciesFiles, DependencyFileType type = DependencyFileType::PACKAGE);
-    void bundleDependency(const Dependency & dep, DependencyFileType type);
+    // --target files of the needed only mode
+    void addTargets(BundleEngine & engine);
+    // resolves the libraries of the dependencies files found from the current dependencies file
+    void collectDependencies(BundleEngine & engine);
+    void bundleDependencies(const fs::path & dependenciesFiles, BundleEngine & engine, DependencyFileType type = DependencyFileType::PACKAGE);
+    void bundleDependency(const Dependency & dep, BundleEngine & engine, DependencyFileType type);
     std::map<std::string,bool> m_ignoredPackages;
+    std::set<std::string> m_bundledDependencies;
     const CmdOptions & m_options;
 
 };
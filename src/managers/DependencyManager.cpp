@@ -13,7 +13,10 @@
 #include "backends/BackendGeneratorFactory.h"
 #include <boost/log/trivial.hpp>
 #include "utils/PathBuilder.h"
+#include "utils/Stats.h"
+#include "utils/Trace.h"
 #include <regex>
+#include <sstream>
 
 using namespace std;
 using std::placeholders::_1;
@@ -83,7 +86,7 @@ int DependencyManager::parse()
 #endif
     fs::path depPath = buildDependencyPath();
     std::vector<Dependency> dependencies = DepUtils::parse(depPath, m_options.getMode());
-    for (auto dep : dependencies) {
+    for (const auto & dep : dependencies) {
         if (!dep.validate()) {
             bValid = false;
         }
@@ -205,6 +208,8 @@ static const std::map<DependencyFileType, std::string> typeToNameMap = {
 void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyFileType type)
 {
     fs::detail::utf8_codecvt_facet utf8;
+    Trace::Span span("retrieve", dependency.getName() + ":" + dependency.getVersion());
+    span.setArg("repository", dependency.getRepositoryType());
     shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(dependency, m_options);
     std::string currentRepositoryType = dependency.getRepositoryType();
     if (m_options.invertRepositoryOrder() && dependency.getType() == Dependency::Type::REMAKEN) {// what about cache management in this case ?
@@ -226,10 +231,16 @@ void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyF
         return;
     }
 
-    if (installDep(dependency, source, outputDirectory, libDirectory, binDirectory) || m_options.force()) {
+    bool install = false;
+    {
+        Trace::Span checkSpan("retrieve", "check installed");
+        install = installDep(dependency, source, outputDirectory, libDirectory, binDirectory) || m_options.force();
+    }
+    if (install) {
         try {
             std::cout<<"=> Installing "<<currentRepositoryType<<"::"<<source<<std::endl;
             try {
+                Trace::Span installSpan("retrieve", "install");
                 outputDirectory = fileRetriever->installArtefact(dependency);
             }
             catch (std::runtime_error & e) { // try alternate/primary repository
@@ -249,6 +260,7 @@ void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyF
                     source = fileRetriever->computeSourcePath(dependency);
                     try {
                         std::cout<<"==> Trying to find '"<<dependency.getPackageName()<<":"<<dependency.getVersion()<<"' on alternate repository "<<dependency.getBaseRepository()<<"('"<<source<<"')"<<std::endl;
+                        Trace::Span alternateSpan("retrieve", "install from alternate repository");
                         outputDirectory = fileRetriever->installArtefact(dependency);
                     }
                     catch (std::runtime_error & e) {
@@ -258,8 +270,10 @@ void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyF
                 }
             }
             std::cout<<"===> "<<dependency.getName()<<" installed in "<<outputDirectory<<std::endl;
+            Stats::addPackage(true);
             if (dependency.getType() != Dependency::Type::CONAN) {
                 if (m_options.useCache()) {
+                    Trace::Span cacheSpan("retrieve", "cache update");
                     m_cache.add(source);
                 }
             }
@@ -269,6 +283,7 @@ void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyF
         }
     }
     else {
+        Stats::addPackage(false);
         if (m_cache.contains(source) && m_options.useCache()) {
             std::cout<<"===> "<<dependency.getRepositoryType()<<"::"<<dependency.getName()<<"-"<<dependency.getVersion()<<" found in cache : already installed"<<std::endl;
         }
@@ -287,27 +302,20 @@ void DependencyManager::retrieveDependency(Dependency &  dependency, DependencyF
 
 void DependencyManager::generateConfigureFile(const fs::path &  rootFolderPath, const std::vector<Dependency> & deps)
 {
-    fs::detail::utf8_codecvt_facet utf8;
     fs::path buildFolderPath = rootFolderPath/DepUtils::getBuildPlatformFolder(m_options);
     fs::path configureFilePath = buildFolderPath/"configure_conditions.pri";
     if (deps.empty()) {
         return;
     }
-    if (fs::exists(configureFilePath) ) {
-        fs::remove(configureFilePath);
-    }
-    if (!fs::exists(buildFolderPath)) {
-        fs::create_directories(buildFolderPath);
-    }
 
-    std::ofstream configureFile(configureFilePath.generic_string(utf8).c_str(), std::ios::out);
+    std::ostringstream configureFile;
     for (auto & dep : deps) {
         for (auto & condition : dep.getConditions()) {
             configureFile << "DEFINES += " << condition;
             configureFile << "\n";
         }
     }
-    configureFile.close();
+    OsUtils::writeFileIfChanged(configureFilePath, configureFile.str());
 }
 
 void DependencyManager::retrieveDependencies(const fs::path &  dependenciesFile, DependencyFileType type)
@@ -323,7 +331,7 @@ void DependencyManager::retrieveDependencies(const fs::path &  dependenciesFile,
     for (fs::path depsFile : dependenciesFileList) {
         if (fs::exists(depsFile)) {
             std::vector<Dependency> dependencies = DepUtils::filterConditionDependencies(conditionsMap, DepUtils::parse(depsFile, m_options.getMode()) );
-            for (auto dep : dependencies) {
+            for (const auto & dep : dependencies) {
                 if (!dep.validate()) {
                     throw std::runtime_error("Error parsing dependency file : invalid format ");
                 }
@@ -336,7 +344,7 @@ void DependencyManager::retrieveDependencies(const fs::path &  dependenciesFile,
             std::vector<std::shared_ptr<std::thread>> thread_group;
             for (Dependency & dependency : dependencies) {
 #ifdef REMAKEN_USE_THREADS
-                thread_group.push_back(std::make_shared<std::thread>(&DependencyManager::retrieveDependency,this, dependency));
+                thread_group.push_back(std::make_shared<std::thread>(&DependencyManager::retrieveDependency,this, std::ref(dependency), type));
 #else
                 retrieveDependency(dependency, type);
                 if (dependency.hasConditions()) {
@@ -349,6 +357,7 @@ void DependencyManager::retrieveDependencies(const fs::path &  dependenciesFile,
             }
         }
     }
+    Trace::Span generatorSpan("generator", m_options.getGenerator() + " configure conditions");
     generator->generateConfigureConditionsFile(dependenciesFile.parent_path(), conditionsDependencies);
 }
 
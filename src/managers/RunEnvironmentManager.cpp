@@ -0,0 +1,428 @@
+#include "RunEnvironmentManager.h"
+#include "Constants.h"
+#include "FileHandlerFactory.h"
+#include "managers/XpcfXmlManager.h"
+#include "utils/DepUtils.h"
+#include "utils/ElfUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/MappedFile.h"
+#include "utils/OsUtils.h"
+#include "utils/Stats.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace std;
+
+static constexpr const char * RUNENV_CACHE_HEADER = "#remaken-runenv-cache 2";
+static constexpr const char * RUNENV_LIBS_STAMP = ".remaken-libs";
+
+RunEnvironmentManager::RunEnvironmentManager(const CmdOptions & options):m_options(options)
+{
+}
+
+// stable cache file name from the cache key
+static std::string cacheKeyHash(const std::string & str)
+{
+    std::ostringstream sstr;
+    sstr<<std::hex<<std::setw(16)<<std::setfill('0')<<HashUtils::fnv1a(str);
+    return sstr.str();
+}
+
+RunEnvironmentManager::InputFileInfo RunEnvironmentManager::computeInputFileInfo(const fs::path & filePath)
+{
+    boost::system::error_code ec;
+    InputFileInfo info {filePath, 0, -1, 0};
+    if (fs::is_regular_file(filePath, ec)) {
+        info.lastWriteTime = fs::last_write_time(filePath, ec);
+        info.size = static_cast<int64_t>(fs::file_size(filePath, ec));
+    }
+    return info;
+}
+
+uint64_t RunEnvironmentManager::computeContentHash(const fs::path & filePath)
+{
+    try {
+        MappedFile file(filePath);
+        return HashUtils::fnv1a(file.content());
+    }
+    catch (const std::runtime_error &) {
+        return 0;
+    }
+}
+
+void RunEnvironmentManager::addInputFile(const fs::path & filePath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string filePathStr = filePath.lexically_normal().generic_string(utf8);
+    if (m_inputFilesSet.insert(filePathStr).second) {
+        InputFileInfo info = computeInputFileInfo(fs::path(filePathStr, utf8));
+        if (info.size >= 0) {
+            info.contentHash = computeContentHash(info.path);
+        }
+        m_inputFiles.push_back(info);
+    }
+}
+
+void RunEnvironmentManager::addLibPath(const fs::path & libPath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string libPathStr = libPath.lexically_normal().generic_string(utf8);
+    if (libPathStr.empty()) {
+        return;
+    }
+    // keep first occurrence order : deterministic and dependency order preserving
+    if (m_libPathsSet.insert(libPathStr).second) {
+        m_libPaths.push_back(fs::path(libPathStr, utf8));
+    }
+}
+
+std::string RunEnvironmentManager::computeCacheKey(const fs::path & applicationFile, const fs::path & xpcfXmlFile, const fs::path & depsFile) const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string cacheKey = m_options.getBuildConfig();
+    cacheKey += "|" + m_options.getBuildToolchain();
+    cacheKey += "|" + m_options.getRemakenRoot().generic_string(utf8);
+    cacheKey += "|" + (applicationFile.empty() ? std::string() : fs::absolute(applicationFile).lexically_normal().generic_string(utf8));
+    cacheKey += "|" + (xpcfXmlFile.empty() ? std::string() : fs::absolute(xpcfXmlFile).lexically_normal().generic_string(utf8));
+    cacheKey += "|" + (depsFile.empty() ? std::string() : fs::absolute(depsFile).lexically_normal().generic_string(utf8));
+    return cacheKey;
+}
+
+fs::path RunEnvironmentManager::computeCacheFilePath(const std::string & cacheKey) const
+{
+    return m_options.getRemakenRoot() / Constants::REMAKEN_RUNENV_CACHE_FOLDER / (cacheKeyHash(cacheKey) + ".txt");
+}
+
+bool RunEnvironmentManager::loadCache(const fs::path & cacheFilePath, const std::string & cacheKey)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    if (!fs::exists(cacheFilePath)) {
+        return false;
+    }
+    std::vector<InputFileInfo> inputFiles;
+    std::vector<fs::path> libPaths;
+    std::time_t creationTime = 0;
+    ifstream fis(cacheFilePath.generic_string(utf8),ios::in);
+    std::string curStr;
+    if (!getline(fis, curStr) || curStr != RUNENV_CACHE_HEADER) {
+        return false;
+    }
+    if (!getline(fis, curStr) || curStr != "key\t" + cacheKey) {
+        // hash collision or corrupted entry
+        return false;
+    }
+    while (getline(fis, curStr)) {
+        if (curStr.empty()) {
+            continue;
+        }
+        std::vector<std::string> results;
+        boost::split(results, curStr, [](char c){return c == '\t';});
+        if (results[0] == "created" && results.size() == 2) {
+            try {
+                creationTime = static_cast<std::time_t>(std::stoll(results[1]));
+            }
+            catch (const std::exception &) {
+                return false;
+            }
+        }
+        else if (results[0] == "input" && results.size() == 5) {
+            try {
+                inputFiles.push_back({fs::path(results[4], utf8), static_cast<std::time_t>(std::stoll(results[1])), std::stoll(results[2]), std::stoull(results[3], nullptr, 16)});
+            }
+            catch (const std::exception &) {
+                return false;
+            }
+        }
+        else if (results[0] == "libpath" && results.size() == 2) {
+            libPaths.push_back(fs::path(results[1], utf8));
+        }
+        else {
+            return false;
+        }
+    }
+    fis.close();
+    // invalidate the entry when any input file changed, appeared or disappeared
+    bool refreshEntry = false;
+    for (auto & inputFile : inputFiles) {
+        InputFileInfo currentInfo = computeInputFileInfo(inputFile.path);
+        if (currentInfo.size != inputFile.size) {
+            m_options.verboseMessage("===> run environment cache invalidated by " + inputFile.path.generic_string(utf8));
+            return false;
+        }
+        // modification times have a one second resolution : a file modified in the second the entry was written
+        // may have changed without a new modification time, its content is checked instead
+        if (currentInfo.size < 0 || (currentInfo.lastWriteTime == inputFile.lastWriteTime && inputFile.lastWriteTime + 1 < creationTime)) {
+            continue;
+        }
+        if (computeContentHash(inputFile.path) != inputFile.contentHash) {
+            m_options.verboseMessage("===> run environment cache invalidated by " + inputFile.path.generic_string(utf8));
+            return false;
+        }
+        inputFile.lastWriteTime = currentInfo.lastWriteTime;
+        refreshEntry = true;
+    }
+    for (auto & libPath : libPaths) {
+        addLibPath(libPath);
+    }
+    if (refreshEntry) {
+        // same content with a new modification time : the entry is rewritten to skip the content check next time
+        m_inputFiles = inputFiles;
+        writeCache(cacheFilePath, cacheKey);
+    }
+    return true;
+}
+
+void RunEnvironmentManager::writeCache(const fs::path & cacheFilePath, const std::string & cacheKey)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    try {
+        fs::create_directories(cacheFilePath.parent_path());
+        // write to a temporary file first, then rename : concurrent runs never read a partial entry
+        fs::path tmpFilePath = cacheFilePath;
+        tmpFilePath += "." + fs::unique_path().generic_string(utf8);
+        ofstream fos(tmpFilePath.generic_string(utf8),ios::out|ios::trunc);
+        fos<<RUNENV_CACHE_HEADER<<'\n';
+        fos<<"key\t"<<cacheKey<<'\n';
+        fos<<"created\t"<<static_cast<int64_t>(std::time(nullptr))<<'\n';
+        for (auto & inputFile : m_inputFiles) {
+            fos<<"input\t"<<static_cast<int64_t>(inputFile.lastWriteTime)<<'\t'<<inputFile.size<<'\t'<<std::hex<<inputFile.contentHash<<std::dec
+               <<'\t'<<inputFile.path.generic_string(utf8)<<'\n';
+        }
+        for (auto & libPath : m_libPaths) {
+            fos<<"libpath\t"<<libPath.generic_string(utf8)<<'\n';
+        }
+        fos.close();
+        fs::rename(tmpFilePath, cacheFilePath);
+    }
+    catch (const fs::filesystem_error & e) {
+        // the cache is an optimization : failing to write it must not prevent the run
+        BOOST_LOG_TRIVIAL(warning)<<"Unable to write run environment cache "<<cacheFilePath<<" : "<<e.what();
+    }
+}
+
+void RunEnvironmentManager::resolve(const fs::path & xpcfXmlFile, const fs::path & depsFile)
+{
+    std::vector<Dependency> deps;
+    std::vector<fs::path> inputFiles;
+    if (!xpcfXmlFile.empty()) {
+        XpcfXmlManager xpcfManager(m_options);
+        addInputFile(fs::absolute(xpcfXmlFile));
+        const std::map<std::string, fs::path> & modulesPathMap = xpcfManager.parseXpcfModulesConfiguration(xpcfXmlFile);
+
+        // modules sharing a package are resolved once, then the packages dependencies are walked in parallel
+        std::vector<fs::path> packagesDependencies;
+        for (auto & [packageRootPath,moduleNames] : XpcfXmlManager::resolvePackageRoots(modulesPathMap, m_options.getVerbose())) {
+            if (!fs::exists(packageRootPath)) {
+                BOOST_LOG_TRIVIAL(warning)<<"Unable to find root package path "<<packageRootPath<<" for modules "<<boost::algorithm::join(moduleNames, ",");
+            }
+            // The following line should not be needed mandatory as xpcf loads dynamically the modules
+            // addLibPath(modulePath);
+            if (fs::exists(packageRootPath/"packagedependencies.txt")) {
+                packagesDependencies.push_back(packageRootPath/"packagedependencies.txt");
+            }
+            else {
+                // record the missing file : its later installation invalidates the cache
+                inputFiles.push_back(fs::absolute(packageRootPath/"packagedependencies.txt"));
+                BOOST_LOG_TRIVIAL(warning)<<"Unable to find packagedependencies.txt file in package path"<<packageRootPath<<" for modules "<<boost::algorithm::join(moduleNames, ",");
+            }
+        }
+        DepUtils::parseRecurse(packagesDependencies, m_options, deps, &inputFiles);
+    }
+
+    if (!depsFile.empty()) {
+        DepUtils::parseRecurse(depsFile, m_options, deps, &inputFiles);
+    }
+    for (auto & inputFile : inputFiles) {
+        addInputFile(inputFile);
+    }
+
+    std::map<std::string,const Dependency *> depsMap;
+    for (auto & dependency : deps) {//filter redundant deps
+        depsMap.insert_or_assign(dependency.getName()+dependency.getVersion(), &dependency);
+    }
+    for (auto & [name,dependency]: depsMap) {
+        shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(*dependency, m_options);
+        for (auto & path : fileRetriever->libPaths(*dependency)) {
+            addLibPath(path);
+        }
+    }
+}
+
+const std::vector<fs::path> & RunEnvironmentManager::libPaths(const fs::path & applicationFile, const fs::path & xpcfXmlFile, const fs::path & depsFile)
+{
+    m_inputFiles.clear();
+    m_inputFilesSet.clear();
+    m_libPaths.clear();
+    m_libPathsSet.clear();
+
+    std::string cacheKey = computeCacheKey(applicationFile, xpcfXmlFile, depsFile);
+    m_cacheFilePath = computeCacheFilePath(cacheKey);
+    m_cacheHit = !m_options.force() && loadCache(m_cacheFilePath, cacheKey);
+    Stats::addCacheLookup("run environment", m_cacheHit);
+    if (m_cacheHit) {
+        m_options.verboseMessage("===> run environment loaded from cache " + m_cacheFilePath.generic_string());
+        return m_libPaths;
+    }
+    m_libPaths.clear();
+    m_libPathsSet.clear();
+    resolve(xpcfXmlFile, depsFile);
+    writeCache(m_cacheFilePath, cacheKey);
+    return m_libPaths;
+}
+
+bool RunEnvironmentManager::linkLibrary(const fs::path & sourceFile, const fs::path & linkPath, const std::string & linkMode)
+{
+    boost::system::error_code ec;
+    if (linkMode == "hardlink") {
+        fs::create_hard_link(sourceFile, linkPath, ec);
+        if (!ec) {
+            return true;
+        }
+        // hardlinks can't cross filesystems : fallback to a symbolic link
+        m_options.verboseMessage("===> unable to hardlink " + sourceFile.generic_string() + " (" + ec.message() + ") : using a symbolic link");
+        ec.clear();
+    }
+    fs::create_symlink(sourceFile, linkPath, ec);
+    if (ec) {
+        BOOST_LOG_TRIVIAL(warning)<<"Unable to link "<<sourceFile<<" to "<<linkPath<<" : "<<ec.message();
+        return false;
+    }
+    return true;
+}
+
+bool RunEnvironmentManager::linkedLibrariesUpToDate(const fs::path & stampPath, const std::string & linkMode)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    if (!fs::exists(stampPath)) {
+        return false;
+    }
+    ifstream fis(stampPath.generic_string(utf8),ios::in);
+    std::string curStr;
+    if (!getline(fis, curStr) || curStr != linkMode) {
+        return false;
+    }
+    // hardlinks keep the content of the file they were created from : a reinstalled library needs a new link
+    while (getline(fis, curStr)) {
+        std::vector<std::string> results;
+        boost::split(results, curStr, [](char c){return c == '\t';});
+        if (results.size() != 2 || OsUtils::fileIdentity(fs::path(results[1], utf8)) != results[0]) {
+            m_options.verboseMessage("===> shared libraries links invalidated by " + (results.size() == 2 ? results[1] : curStr));
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunEnvironmentManager::publishLinkedLibraries(const fs::path & folderPath, const fs::path & libsFolderPath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    // libsFolderPath is a symbolic link to the current links folder, replaced with an atomic rename :
+    // concurrent runs always find a complete folder
+    fs::path symlinkPath = folderPath;
+    symlinkPath += ".link";
+    fs::create_directory_symlink(folderPath.filename(), symlinkPath, ec);
+    if (ec) {
+        // directory symbolic links may not be available (windows without privileges) : the folder is replaced
+        m_options.verboseMessage("===> unable to create a symbolic link to " + folderPath.generic_string(utf8) + " (" + ec.message() + ") : replacing the folder");
+        fs::remove_all(libsFolderPath);
+        fs::rename(folderPath, libsFolderPath);
+        return;
+    }
+    fs::path previousFolderPath;
+    if (fs::is_symlink(libsFolderPath)) {
+        previousFolderPath = libsFolderPath.parent_path() / fs::read_symlink(libsFolderPath, ec);
+    }
+    else if (fs::exists(libsFolderPath)) {
+        fs::remove_all(libsFolderPath);
+    }
+    fs::rename(symlinkPath, libsFolderPath);
+    if (!previousFolderPath.empty() && previousFolderPath != folderPath) {
+        fs::remove_all(previousFolderPath, ec);
+    }
+}
+
+fs::path RunEnvironmentManager::linkLibraries(const std::string & linkMode)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path libsFolderPath = m_cacheFilePath.parent_path() / (m_cacheFilePath.stem().generic_string(utf8) + "-libs");
+    if (m_cacheHit && linkedLibrariesUpToDate(libsFolderPath / RUNENV_LIBS_STAMP, linkMode)) {
+        return libsFolderPath;
+    }
+
+    m_options.verboseMessage("===> gathering shared libraries links in " + libsFolderPath.generic_string(utf8));
+    fs::path folderPath = libsFolderPath;
+    folderPath += "." + fs::unique_path().generic_string(utf8);
+    fs::create_directories(folderPath);
+    std::string_view suffix = OsUtils::sharedSuffix(m_options.getOS());
+    // link name -> linked file (canonical path)
+    std::map<std::string, fs::path> linkedFiles;
+    // SONAME -> providing file (canonical path)
+    std::map<std::string, fs::path> sonameProviders;
+    for (auto & libPath : m_libPaths) {
+        boost::system::error_code ec;
+        if (!fs::is_directory(libPath, ec)) {
+            continue;
+        }
+        std::vector<fs::path> entries;
+        for (fs::directory_entry& x : fs::directory_iterator(libPath)) {
+            if (OsUtils::hasLibrarySuffix(x.path(), suffix) && !fs::is_directory(x.path(), ec)) {
+                entries.push_back(x.path());
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        for (auto & entry : entries) {
+            fs::path realFile = fs::canonical(entry, ec);
+            if (ec) { // dangling symlink
+                continue;
+            }
+            std::string linkName = entry.filename().generic_string(utf8);
+            if (mapContains(linkedFiles, linkName)) {
+                // the first path wins, as it would with the library path environment variable
+                if (linkedFiles.at(linkName) != realFile) {
+                    BOOST_LOG_TRIVIAL(warning)<<"Library name conflict: "<<linkName<<" is provided by "<<linkedFiles.at(linkName)<<" and "<<realFile<<" - using "<<linkedFiles.at(linkName);
+                }
+                continue;
+            }
+            ElfUtils::DynamicInfo info;
+            if (ElfUtils::readDynamicInfo(realFile, info) && !info.soname.empty()) {
+                if (!mapContains(sonameProviders, info.soname)) {
+                    sonameProviders[info.soname] = realFile;
+                }
+                else if (sonameProviders.at(info.soname) != realFile) {
+                    BOOST_LOG_TRIVIAL(warning)<<"SONAME conflict: "<<info.soname<<" is provided by "<<sonameProviders.at(info.soname)<<" and "<<realFile<<" - using "<<sonameProviders.at(info.soname);
+                }
+            }
+            if (linkLibrary(realFile, folderPath / linkName, linkMode)) {
+                linkedFiles[linkName] = realFile;
+            }
+        }
+    }
+    // the loader searches DT_NEEDED entries by SONAME : ensure each SONAME is available
+    for (auto & [soname, providerPath] : sonameProviders) {
+        if (!mapContains(linkedFiles, soname)) {
+            if (linkLibrary(providerPath, folderPath / soname, linkMode)) {
+                linkedFiles[soname] = providerPath;
+            }
+        }
+    }
+    std::set<fs::path> sourceFiles;
+    for (auto & [linkName, sourceFile] : linkedFiles) {
+        sourceFiles.insert(sourceFile);
+    }
+    ofstream fos((folderPath / RUNENV_LIBS_STAMP).generic_string(utf8),ios::out);
+    fos<<linkMode<<'\n';
+    for (auto & sourceFile : sourceFiles) {
+        fos<<OsUtils::fileIdentity(sourceFile)<<'\t'<<sourceFile.generic_string(utf8)<<'\n';
+    }
+    fos.close();
+    publishLinkedLibraries(folderPath, libsFolderPath);
+    return libsFolderPath;
+}
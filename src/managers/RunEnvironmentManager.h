@@ -0,0 +1,78 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @date 2026-10-19
+ */
+
+#ifndef RUNENVIRONMENTMANAGER_H
+#define RUNENVIRONMENTMANAGER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <boost/filesystem.hpp>
+#include "Dependency.h"
+#include "CmdOptions.h"
+
+namespace fs = boost::filesystem;
+
+class RunEnvironmentManager
+{
+public:
+    RunEnvironmentManager(const CmdOptions & options);
+    // returns the ordered and deduplicated runtime library paths for an application.
+    // Paths are cached per (application, build configuration, xpcf file, dependencies file) under the remaken root,
+    // and the cache entry is reused as long as every input file (xpcf xml, packagedependencies files) is unchanged :
+    // same size and modification time, or same content when the modification time changed or is too recent to be trusted.
+    const std::vector<fs::path> & libPaths(const fs::path & applicationFile, const fs::path & xpcfXmlFile, const fs::path & depsFile);
+    // gathers links ("symlink" or "hardlink" linkMode) to every shared library found in the resolved paths into a single folder.
+    // Must be called after libPaths(). The folder is rebuilt when the cached paths were recomputed or when a linked library changed.
+    // Returns the folder path.
+    fs::path linkLibraries(const std::string & linkMode);
+
+private:
+    typedef struct {
+        fs::path path;
+        std::time_t lastWriteTime;
+        int64_t size; // -1 when the file doesn't exist
+        uint64_t contentHash;
+    } InputFileInfo;
+
+    void resolve(const fs::path & xpcfXmlFile, const fs::path & depsFile);
+    void addInputFile(const fs::path & filePath);
+    void addLibPath(const fs::path & libPath);
+    std::string computeCacheKey(const fs::path & applicationFile, const fs::path & xpcfXmlFile, const fs::path & depsFile) const;
+    fs::path computeCacheFilePath(const std::string & cacheKey) const;
+    bool loadCache(const fs::path & cacheFilePath, const std::string & cacheKey);
+    void writeCache(const fs::path & cacheFilePath, const std::string & cacheKey);
+    static InputFileInfo computeInputFileInfo(const fs::path & filePath);
+    static uint64_t computeContentHash(const fs::path & filePath);
+    bool linkLibrary(const fs::path & sourceFile, const fs::path & linkPath, const std::string & linkMode);
+    bool linkedLibrariesUpToDate(const fs::path & stampPath, const std::string & linkMode);
+    void publishLinkedLibraries(const fs::path & folderPath, const fs::path & libsFolderPath);
+
+    std::vector<InputFileInfo> m_inputFiles;
+    std::set<std::string> m_inputFilesSet;
+    std::vector<fs::path> m_libPaths;
+    std::set<std::string> m_libPathsSet;
+    fs::path m_cacheFilePath;
+    bool m_cacheHit = false;
+    const CmdOptions & m_options;
+};
+
+#endif // RUNENVIRONMENTMANAGER_H
@@ -20,15 +20,14 @@ XpcfXmlManager::XpcfXmlManager(const CmdOptions & options):m_options(options)
 fs::path XpcfXmlManager::findPackageRoot(const fs::path & moduleLibPath, bool verbose)
 {
     fs::detail::utf8_codecvt_facet utf8;
-    std::string versionRegex = "[0-9]+\\.[0-9]+\\.[0-9]+";
+    static const std::regex versionRegex("[0-9]+\\.[0-9]+\\.[0-9]+", std::regex_constants::extended);
     fs::path currentFilename = moduleLibPath.filename();
     fs::path currentModulePath = moduleLibPath;
     bool bFoundVersion = false;
     std::smatch sm;
     while (!bFoundVersion && !currentModulePath.empty()) {
-        std::regex tmplRegex(versionRegex, std::regex_constants::extended);
         std::string currentFilenameStr = currentFilename.string(utf8);
-        if (std::regex_search(currentFilenameStr, sm, tmplRegex, std::regex_constants::match_any)) {
+        if (std::regex_search(currentFilenameStr, sm, versionRegex, std::regex_constants::match_any)) {
             std::string matchStr = sm.str(0);
             if (verbose) {
                 BOOST_LOG_TRIVIAL(warning)<<"Found "<< matchStr<<" version for modulepath "<<currentModulePath;
@@ -45,6 +44,25 @@ fs::path XpcfXmlManager::findPackageRoot(const fs::path & moduleLibPath, bool ve
     return fs::path();
 }
 
+std::vector<std::pair<fs::path, std::vector<std::string>>> XpcfXmlManager::resolvePackageRoots(const std::map<std::string, fs::path> & modulesPathMap, bool verbose)
+{
+    std::vector<std::pair<fs::path, std::vector<std::string>>> packageRoots;
+    std::map<fs::path, std::size_t> rootIndices;
+    for (auto & [name,modulePath] : modulesPathMap) {
+        fs::path packageRootPath = findPackageRoot(modulePath, verbose);
+        if (packageRootPath.empty()) {
+            BOOST_LOG_TRIVIAL(warning)<<"Unable to find root package path for module '"<<name<<"' path="<<modulePath;
+            continue;
+        }
+        if (!mapContains(rootIndices, packageRootPath)) {
+            rootIndices[packageRootPath] = packageRoots.size();
+            packageRoots.push_back({packageRootPath, {}});
+        }
+        packageRoots[rootIndices.at(packageRootPath)].second.push_back(name);
+    }
+    return packageRoots;
+}
+
 void XpcfXmlManager::updateModuleNode(tinyxml2::XMLElement * xmlModuleElt)
 {
     fs::detail::utf8_codecvt_facet utf8;
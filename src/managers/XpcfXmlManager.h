@@ -40,6 +40,8 @@ public:
     const std::map<std::string, fs::path> & parseXpcfModulesConfiguration(const fs::path & configurationFilePath);
     int updateXpcfModulesPath(const fs::path & configurationFilePath);
     static fs::path findPackageRoot(const fs::path & moduleLibPath, bool verbose);
+    // package root paths in modules order, with the names of the modules they provide : each module path is resolved once
+    static std::vector<std::pair<fs::path, std::vector<std::string>>> resolvePackageRoots(const std::map<std::string, fs::path> & modulesPathMap, bool verbose);
 
 private:
     void updateModuleNode(tinyxml2::XMLElement * xmlModuleElt);
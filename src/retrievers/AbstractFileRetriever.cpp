@@ -1,11 +1,70 @@
 #include "AbstractFileRetriever.h"
 #include "utils/DepUtils.h"
 #include "utils/OsUtils.h"
+#include "utils/PackageManifest.h"
 #include "tools/PkgConfigTool.h"
 #include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <fstream>
+
+namespace {
+
+// advisory lock shared by remaken processes (it doesn't serialize threads of the same process)
+class InstallLock {
+public:
+    InstallLock(const fs::path & lockFilePath)
+    {
+        fs::detail::utf8_codecvt_facet utf8;
+        fs::create_directories(lockFilePath.parent_path());
+        std::ofstream(lockFilePath.generic_string(utf8), std::ios::out | std::ios::app).close();
+        m_lock = boost::interprocess::file_lock(lockFilePath.generic_string(utf8).c_str());
+    }
+
+    ~InstallLock()
+    {
+        if (m_locked) {
+            m_lock.unlock();
+        }
+    }
+
+    bool tryLock()
+    {
+        m_locked = m_lock.try_lock();
+        return m_locked;
+    }
+
+    void lock()
+    {
+        m_lock.lock();
+        m_locked = true;
+    }
+
+private:
+    boost::interprocess::file_lock m_lock;
+    bool m_locked = false;
+};
+
+// the archive identified by installKey was installed and none of its files was removed since
+bool isInstalled(const fs::path & packageRoot, const std::string & installKey)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    PackageManifest manifest;
+    if (!manifest.load(packageRoot) || manifest.installKeys().count(installKey) == 0) {
+        return false;
+    }
+    boost::system::error_code ec;
+    for (auto & entry : manifest.files()) {
+        if (entry.installKeys.count(installKey) > 0 && !fs::exists(packageRoot / fs::path(entry.relativePath, utf8), ec)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
 
 AbstractFileRetriever::AbstractFileRetriever(const CmdOptions & options):m_options(options)
 {
@@ -114,26 +173,61 @@ void AbstractFileRetriever::write_pkg_file([[maybe_unused]] std::vector<Dependen
 fs::path AbstractFileRetriever::installArtefactImpl(const Dependency & dependency)
 {
     fs::detail::utf8_codecvt_facet utf8;
-    fs::path compressedDependency = retrieveArtefact(dependency);
-    // zipper::Unzipper unzipper(compressedDependency.generic_string(utf8));
-    fs::path outputDirectory = OsUtils::computeRemakenRootPackageDir(m_options);
+    fs::path packagesRootDirectory = OsUtils::computeRemakenRootPackageDir(m_options);
+    fs::path extractDirectory = packagesRootDirectory;
+    std::string lockName = dependency.getPackageName() + "_" + dependency.getVersion() + ".lock";
     if (dependency.hasIdentifier()) {
-        outputDirectory /= dependency.getIdentifier();
+        extractDirectory /= dependency.getIdentifier();
+        lockName = dependency.getIdentifier() + "_" + lockName;
     }
-    if (!fs::exists(outputDirectory)) {
-        fs::create_directories(outputDirectory);
+    fs::path outputDirectory = computeLocalDependencyRootDir(dependency);
+    std::string installKey = PackageManifest::installKey(m_options, dependency.getMode());
+
+    // one install of a package version at a time for a toolchain : a concurrent install is awaited, not duplicated
+    InstallLock installLock(packagesRootDirectory / Constants::REMAKEN_LOCKS_FOLDER / lockName);
+    if (!installLock.tryLock()) {
+        std::cout<<"==> Waiting for another remaken process installing "<<dependency.getName()<<":"<<dependency.getVersion()<<std::endl;
+        installLock.lock();
     }
-    int result = m_zipTool->uncompressArtefact(compressedDependency,outputDirectory);
-    if (result != 0) {
-        throw std::runtime_error("Error uncompressing dependency " + dependency.getName());
+    // another process may have installed the package since it was found missing, even when the lock was free
+    if (!m_options.force() && isInstalled(outputDirectory, installKey)) {
+        std::cout<<"==> "<<dependency.getName()<<":"<<dependency.getVersion()<<" is already installed"<<std::endl;
+        return outputDirectory;
+    }
+
+    fs::path compressedDependency = retrieveArtefact(dependency);
+    // the archive is extracted in a staging folder on the same filesystem, then moved in place :
+    // an interrupted install never leaves a partial package folder
+    fs::path stagingDirectory = packagesRootDirectory / Constants::REMAKEN_STAGING_FOLDER / boost::uuids::to_string(boost::uuids::random_generator()());
+    fs::create_directories(stagingDirectory);
+    std::vector<std::string> archiveFiles;
+    try {
+        int result = m_zipTool->uncompressArtefact(compressedDependency, stagingDirectory);
+        if (result != 0) {
+            throw std::runtime_error("Error uncompressing dependency " + dependency.getName());
+        }
+        fs::remove(compressedDependency);
+        fs::path stagedPackageDirectory = stagingDirectory / outputDirectory.lexically_relative(extractDirectory);
+        if (fs::exists(stagedPackageDirectory)) {
+            archiveFiles = PackageManifest::listFiles(stagedPackageDirectory);
+        }
+        OsUtils::moveFolderContent(stagingDirectory, extractDirectory);
+        fs::remove_all(stagingDirectory);
+    }
+    catch (const std::exception & e) {
+        boost::system::error_code ec;
+        fs::remove_all(stagingDirectory, ec);
+        throw std::runtime_error(e.what());
     }
-    // unzipper.extract(outputDirectory.generic_string(utf8));
-    // unzipper.close();
-    fs::remove(compressedDependency);
-    outputDirectory = computeLocalDependencyRootDir(dependency);
     if (!fs::exists(outputDirectory)) {
         throw std::runtime_error("Error : dependency folder " + outputDirectory.generic_string(utf8) + " doesn't exist after package unzip");
     }
+    try {
+        PackageManifest::write(outputDirectory, dependency, installKey, archiveFiles);
+    }
+    catch (const std::exception & e) {
+        BOOST_LOG_TRIVIAL(warning)<<"Unable to write the install manifest of "<<dependency.getName()<<" : "<<e.what();
+    }
     return outputDirectory;
 }
 
@@ -142,12 +236,12 @@ void AbstractFileRetriever::addArtefactRemoteImpl([[maybe_unused]] const Depende
     //TODO
 }
 
-void AbstractFileRetriever::copySharedLibraries(const fs::path & sourceRootFolder)
+void AbstractFileRetriever::copySharedLibraries(const fs::path & sourceRootFolder, BundleEngine & engine)
 {
-    OsUtils::copySharedLibraries(sourceRootFolder, m_options);
+    engine.addSharedLibraries(sourceRootFolder);
 }
 
-fs::path AbstractFileRetriever::bundleArtefact(const Dependency & dependency)
+fs::path AbstractFileRetriever::bundleArtefact(const Dependency & dependency, BundleEngine & engine)
 {
     fs::detail::utf8_codecvt_facet utf8;
     fs::path rootLibDir = computeRootLibDir(dependency);
@@ -180,7 +274,7 @@ fs::path AbstractFileRetriever::bundleArtefact(const Dependency & dependency)
     }
     m_options.verboseMessage("--------------- Remaken bundle ---------------");
     m_options.verboseMessage("===> bundling: " + dependency.getName() + "/"+ dependency.getVersion() + " from " + rootLibDir.generic_string(utf8));
-    copySharedLibraries(rootLibDir);
+    copySharedLibraries(rootLibDir, engine);
     fs::path outputDirectory = computeLocalDependencyRootDir(dependency);
     return outputDirectory;
 }
@@ -33,7 +33,7 @@ public:
     AbstractFileRetriever(const CmdOptions & options);
     virtual ~AbstractFileRetriever() override;
     virtual fs::path installArtefact(const Dependency & dependency) override final;
-    virtual fs::path bundleArtefact(const Dependency & dependency) override;
+    virtual fs::path bundleArtefact(const Dependency & dependency, BundleEngine & engine) override;
     virtual std::vector<fs::path> binPaths(const Dependency & dependency) override;
     virtual std::vector<fs::path> libPaths(const Dependency & dependency) override;
     virtual std::vector<fs::path> includePaths(const Dependency & dependency) override;
@@ -50,7 +50,7 @@ public:
 protected:
     virtual fs::path installArtefactImpl(const Dependency & dependency);
     virtual void addArtefactRemoteImpl(const Dependency & dependency);
-    void copySharedLibraries(const fs::path & sourceRootFolder);
+    void copySharedLibraries(const fs::path & sourceRootFolder, BundleEngine & engine);
     fs::path m_workingDirectory;
     const CmdOptions & m_options;
     std::shared_ptr<ZipTool> m_zipTool;
@@ -9,11 +9,11 @@ ConanFileRetriever::ConanFileRetriever(const CmdOptions & options):SystemFileRet
 }
 
 // bundle command
-fs::path ConanFileRetriever::bundleArtefact(const Dependency & dependency)
+fs::path ConanFileRetriever::bundleArtefact(const Dependency & dependency, BundleEngine & engine)
 {
     m_options.verboseMessage("--------------- Conan bundle ---------------");
     m_options.verboseMessage("===> bundling: " + dependency.getName() + "/"+ dependency.getVersion());
-    m_tool->bundle(dependency);
+    m_tool->bundle(dependency, engine);
     return fs::path();
 }
 
@@ -30,7 +30,7 @@ class ConanFileRetriever : public SystemFileRetriever
 public:
     ConanFileRetriever(const CmdOptions & options);
     ~ConanFileRetriever() override = default;
-    fs::path bundleArtefact(const Dependency & dependency) override;
+    fs::path bundleArtefact(const Dependency & dependency, BundleEngine & engine) override;
     std::pair<std::string, fs::path> invokeGenerator(std::vector<Dependency> & deps) override;
     void write_pkg_file(std::vector<Dependency> & deps) override;    
 };
@@ -11,6 +11,8 @@
 #include <fstream>
 #include <iostream>
 #include "HttpHandlerFactory.h"
+#include "utils/Stats.h"
+#include "utils/Trace.h"
 
 using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 namespace http = boost::beast::http;
@@ -32,6 +34,7 @@ http::status CredentialsFileRetriever::downloadArtefact (const std::string & sou
 {
     //auto const host = "www.github.com";
     //auto const port = "443";
+    Trace::Span span("download", source);
     boost::asio::io_context ioc;
     auto httpWrapper = HttpHandlerFactory::instance()->getHttpHandler(ioc,source);
 
@@ -43,7 +46,10 @@ http::status CredentialsFileRetriever::downloadArtefact (const std::string & sou
     req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
     req.insert("X-JFrog-Art-Api", m_apiKey.c_str());
     // Send the HTTP request to the remote host
-    httpWrapper->write(req);
+    {
+        Trace::Span requestSpan("download", "request");
+        httpWrapper->write(req);
+    }
 
     // This buffer is used for reading and must be persisted
     boost::beast::flat_buffer buffer;
@@ -57,8 +63,16 @@ http::status CredentialsFileRetriever::downloadArtefact (const std::string & sou
     res.get().body().open(dest.generic_string().c_str(), boost::beast::file_mode::write, ec);
 
     // Receive the HTTP response
-    httpWrapper->read(buffer, res);
-    res.get().body().close();
+    {
+        Trace::Span transferSpan("download", "transfer");
+        httpWrapper->read(buffer, res);
+        res.get().body().close();
+    }
+    span.setArg("status", static_cast<uint64_t>(res.get().result_int()));
+    boost::system::error_code sizeError;
+    uint64_t bytes = fs::file_size(dest, sizeError);
+    span.setArg("bytes", sizeError ? 0 : bytes);
+    Stats::addDownload(httpWrapper->getHost(), sizeError ? 0 : bytes);
 
     // Gracefully close the socket
     httpWrapper->shutdown();
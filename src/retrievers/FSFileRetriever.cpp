@@ -1,4 +1,7 @@
 #include "FSFileRetriever.h"
+#include "utils/OsUtils.h"
+#include "utils/Stats.h"
+#include "utils/Trace.h"
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/filesystem.hpp>
@@ -18,8 +21,14 @@ fs::path FSFileRetriever::retrieveArtefact(const Dependency & dependency)
     boost::uuids::uuid uuid = boost::uuids::random_generator()();
     fs::path output = this->m_workingDirectory / boost::uuids::to_string(uuid);
     output += sourcePath.extension();
+    Trace::Span span("download", source);
     try {
-        fs::copy(sourcePath,output);
+        OsUtils::CopyMethod method = OsUtils::copyFile(sourcePath, output);
+        boost::system::error_code ec;
+        uint64_t bytes = fs::file_size(output, ec);
+        span.setArg("bytes", ec ? 0 : bytes);
+        Stats::addDownload(dependency.getBaseRepository(), ec ? 0 : bytes);
+        m_options.verboseMessage("===> " + sourcePath.generic_string(utf8) + " copied (" + std::string(OsUtils::copyMethodName(method)) + ")");
     }
     catch (const fs::filesystem_error & e) {
         throw std::runtime_error(e.what());
@@ -8,6 +8,8 @@
 #include <fstream>
 #include <iostream>
 #include "HttpHandlerFactory.h"
+#include "utils/Stats.h"
+#include "utils/Trace.h"
 #include <boost/process.hpp>
 
 namespace bp = boost::process;
@@ -21,6 +23,7 @@ http::status HttpFileRetriever::downloadArtefact (const std::string & source,con
 {
     //auto const host = "www.github.com";
     //auto const port = "443";
+    Trace::Span span("download", source);
     boost::asio::io_context ioc;
     auto httpWrapper = HttpHandlerFactory::instance()->getHttpHandler(ioc,source);
 
@@ -31,7 +34,10 @@ http::status HttpFileRetriever::downloadArtefact (const std::string & source,con
     req.set(http::field::host, httpWrapper->getHost());
     req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
     // Send the HTTP request to the remote host
-    httpWrapper->write(req);
+    {
+        Trace::Span requestSpan("download", "request");
+        httpWrapper->write(req);
+    }
 
     // This buffer is used for reading and must be persisted
     boost::beast::flat_buffer buffer;
@@ -45,8 +51,16 @@ http::status HttpFileRetriever::downloadArtefact (const std::string & source,con
     res.get().body().open(dest.generic_string().c_str(), boost::beast::file_mode::write, ec);
 
     // Receive the HTTP response
-    httpWrapper->read(buffer, res);
-    res.get().body().close();
+    {
+        Trace::Span transferSpan("download", "transfer");
+        httpWrapper->read(buffer, res);
+        res.get().body().close();
+    }
+    span.setArg("status", static_cast<uint64_t>(res.get().result_int()));
+    boost::system::error_code sizeError;
+    uint64_t bytes = fs::file_size(dest, sizeError);
+    span.setArg("bytes", sizeError ? 0 : bytes);
+    Stats::addDownload(httpWrapper->getHost(), sizeError ? 0 : bytes);
 
     // Gracefully close the socket
     httpWrapper->shutdown();
@@ -73,8 +87,10 @@ http::status HttpFileRetriever::downloadArtefact (const std::string & source,con
 #else
 http::status HttpFileRetriever::downloadArtefact (const std::string & source,const fs::path & dest, [[maybe_unused]] std::string & newLocation)
 {
+    Trace::Span span("download", source);
     boost::filesystem::path tool = bp::search_path("curl");
     if (!tool.empty()) {
+        Trace::Span processSpan("process", "curl");
         int result = bp::system(tool, "-L", "-f", source, "-o", dest);
         if (result != 0) {
             std::cout << source<<std::endl;
@@ -86,6 +102,17 @@ http::status HttpFileRetriever::downloadArtefact (const std::string & source,con
     else {
         throw std::runtime_error("Curl not installed : check your installation !!!");
     }
+    boost::system::error_code sizeError;
+    uint64_t bytes = fs::file_size(dest, sizeError);
+    span.setArg("bytes", sizeError ? 0 : bytes);
+    // the repository is the host part of the url
+    static const std::regex hostRegex("^[a-zA-Z]+://([^/]+)");
+    std::string repository = source;
+    std::smatch match;
+    if (std::regex_search(source, match, hostRegex)) {
+        repository = match.str(1);
+    }
+    Stats::addDownload(repository, sizeError ? 0 : bytes);
     return http::status::ok;
 }
 
@@ -26,6 +26,7 @@
 #include <exception>
 #include "Dependency.h"
 #include "Constants.h"
+#include "utils/BundleEngine.h"
 
 namespace fs = boost::filesystem;
 
@@ -34,7 +35,7 @@ class IFileRetriever
 public:
     virtual ~IFileRetriever() = default;
     virtual fs::path installArtefact(const Dependency & dependency) = 0;
-    virtual fs::path bundleArtefact(const Dependency & dependency) = 0;
+    virtual fs::path bundleArtefact(const Dependency & dependency, BundleEngine & engine) = 0;
     virtual fs::path retrieveArtefact(const Dependency & dependency) = 0;
     virtual std::vector<fs::path> binPaths(const Dependency & dependency) = 0;
     virtual std::vector<fs::path> libPaths(const Dependency & dependency) = 0;
@@ -29,9 +29,9 @@ SystemFileRetriever::SystemFileRetriever(const CmdOptions & options, Dependency:
 #endif
 }
 
-fs::path SystemFileRetriever::bundleArtefact(const Dependency & dependency)
+fs::path SystemFileRetriever::bundleArtefact(const Dependency & dependency, BundleEngine & engine)
 {
-    m_tool->bundle(dependency);
+    m_tool->bundle(dependency, engine);
     fs::path outputDirectory = computeLocalDependencyRootDir(dependency);
     if (m_tool->bundleScripted()) {
         m_tool->bundleScript(dependency, m_scriptFilePath);
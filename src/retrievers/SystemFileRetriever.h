@@ -36,7 +36,7 @@ public:
     ~SystemFileRetriever() override = default;
 
 
-    fs::path bundleArtefact(const Dependency & dependency) override;
+    fs::path bundleArtefact(const Dependency & dependency, BundleEngine & engine) override;
     fs::path installArtefactImpl(const Dependency & dependency) override;
     fs::path retrieveArtefact(const Dependency & dependency) override;
     void addArtefactRemoteImpl(const Dependency & dependency) override;
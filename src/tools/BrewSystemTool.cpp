@@ -1,4 +1,5 @@
 #include "BrewSystemTool.h"
+#include "utils/Trace.h"
 #include "utils/OsUtils.h"
 #include "tools/PkgConfigTool.h"
 #include <boost/process.hpp>
@@ -23,6 +24,7 @@ std::string BrewSystemTool::computeToolRef (const Dependency &  dependency)
 
 void BrewSystemTool::update ()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system (m_systemInstallerPath, "update");
     if (result != 0) {
         throw std::runtime_error("Error updating brew repositories");
@@ -83,7 +85,7 @@ void BrewSystemTool::search(const std::string & pkgName, const std::string & ver
     }
 }
 
-void BrewSystemTool::bundleLib(const std::string & lib)
+void BrewSystemTool::bundleLib(const std::string & lib, BundleEngine & engine)
 {
     fs::detail::utf8_codecvt_facet utf8;
     std::vector<std::string> libPaths = split( run ("list", {}, lib) );
@@ -102,19 +104,19 @@ void BrewSystemTool::bundleLib(const std::string & lib)
     }
     for (auto & [path,val]: libPathsMap) {
         m_options.verboseMessage("=====> adding libraries from " + path.generic_string(utf8));
-        OsUtils::copySharedLibraries(path,m_options);
+        engine.addSharedLibraries(path);
     }
 }
 
-void BrewSystemTool::bundle (const Dependency & dependency)
+void BrewSystemTool::bundle (const Dependency & dependency, BundleEngine & engine)
 {
     std::string source = computeToolRef (dependency);
     m_options.verboseMessage("--------------- Brew bundle ---------------");
     m_options.verboseMessage("===> bundling: " + dependency.getName() + "/"+ dependency.getVersion());
-    bundleLib(source);
+    bundleLib(source, engine);
     std::vector<std::string> deps = split( run ("deps", {}, source) );
     for (auto & dep : deps) {
-        bundleLib(dep);
+        bundleLib(dep, engine);
     }
 }
 
@@ -125,6 +127,7 @@ void BrewSystemTool::install (const Dependency & dependency)
     }
     addRemote(dependency.getBaseRepository());
     std::string source = computeToolRef (dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "install", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing brew dependency : " + source);
@@ -227,6 +230,7 @@ std::pair<std::string, fs::path> BrewSystemTool::invokeGenerator(std::vector<Dep
 bool BrewSystemTool::installed (const Dependency & dependency)
 {
     std::string source = computeToolRef (dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "ls","--versions", source.c_str());
     return (result == 0);
 }
@@ -31,7 +31,7 @@ public:
     BrewSystemTool(const CmdOptions & options):BaseSystemTool(options, "brew") {}
     ~BrewSystemTool() override = default;
     void update() override;    
-    void bundle(const Dependency & dependency) override;
+    void bundle(const Dependency & dependency, BundleEngine & engine) override;
     void bundleScript ([[maybe_unused]] const Dependency & dependency, [[maybe_unused]] const fs::path & scriptFile) override {}
     void install(const Dependency & dependency) override;
     bool installed(const Dependency & dependency) override;
@@ -48,7 +48,7 @@ public:
 private:
     std::string retrieveInstallCommand(const Dependency & dependency) override;
     void tap(const std::string & repositoryUrl);
-    void bundleLib(const std::string & libPath);
+    void bundleLib(const std::string & libPath, BundleEngine & engine);
     std::string computeToolRef( const Dependency &  dependency) override;
 };
 
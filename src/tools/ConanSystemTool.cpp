@@ -1,6 +1,7 @@
 #include "ConanSystemTool.h"
 #include "Dependency.h"
 #include "utils/OsUtils.h"
+#include "utils/Trace.h"
 #include "PkgConfigTool.h"
 #include <boost/process.hpp>
 #include <boost/predef.h>
@@ -11,6 +12,7 @@
 #include <map>
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <sstream>
 
 namespace bp = boost::process;
 namespace nj = nlohmann;
@@ -58,7 +60,7 @@ void ConanSystemTool::update()
 {
 }
 
-void ConanSystemTool::bundle(const Dependency & dependency)
+void ConanSystemTool::bundle(const Dependency & dependency, BundleEngine & engine)
 {
     fs::path destination = m_options.getDestinationRoot();
     destination /= ".conan";
@@ -79,7 +81,7 @@ void ConanSystemTool::bundle(const Dependency & dependency)
     std::vector<fs::path> libPaths = retrievePaths(dependency, libPathNode, destination);
     for (auto & libPath : libPaths) {
         if (boost::filesystem::exists(libPath)) {
-            OsUtils::copySharedLibraries(libPath, m_options);
+            engine.addSharedLibraries(libPath);
         }
     }
 }
@@ -223,6 +225,7 @@ void ConanSystemTool::install(const Dependency & dependency)
         if (m_options.getVerbose())  {
             std::cout << command.c_str() << std::endl;
         }
+        Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
         result = bp::system(command.c_str());
     }
     else {
@@ -238,6 +241,7 @@ void ConanSystemTool::install(const Dependency & dependency)
         // replace old lign command by a string pre-formatted in order to manage args with space and quotes. for instance cuda_arch_bin="75 80 86".
         // with old mgnt : quotes are repeated in conan options logs (cuda_arch_bin="75 80 86" not good mgnt - it builds but it's not functional after)
         // with new mgnt : quotes are deleted in conan options logs (cuda_arch_bin=75 80 86)
+        Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
         result = bp::system(command.c_str());
     }
     if (result != 0) {
@@ -426,7 +430,7 @@ fs::path ConanSystemTool::createConanFile(const std::vector<Dependency> & deps)
     if (!m_options.getDestinationRoot().empty()){
         conanFilePath = m_options.getDestinationRoot()/ "conanfile.txt";
     }
-    std::ofstream fos(conanFilePath.generic_string(utf8),std::ios::out);
+    std::ostringstream fos;
     fos<<"[requires]"<<'\n';
     std::vector<std::string> urlDeps;
     for (auto & dependency : deps) {
@@ -461,7 +465,7 @@ fs::path ConanSystemTool::createConanFile(const std::vector<Dependency> & deps)
     for (const auto & option: options) {
         fos<<option<<'\n';
     }
-    fos.close();
+    OsUtils::writeFileIfChanged(conanFilePath, fos.str());
     return conanFilePath;
 }
 
@@ -624,6 +628,7 @@ std::pair<std::string, fs::path> ConanSystemTool::invokeGenerator(std::vector<De
         if (m_options.getVerbose()) {
             std::cout << command.c_str() << std::endl;
         }
+        Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
         result = bp::system(command.c_str());
     } else {
         std::string dest_param = "-of";
@@ -709,6 +714,7 @@ std::vector<fs::path> ConanSystemTool::retrievePaths(const Dependency & dependen
         if (dependency.getMode() == "na") {
             std::string command = m_systemInstallerPath.generic_string(utf8) + " install " + boost::algorithm::join(settingsArgs, " ") + " -s " + buildType + " -s " + cppStd + " -pr " + profileName + " " + dest_param + " " + destination.generic_string(utf8) + " " + boost::algorithm::join(optionsArgs, " ") + " " + generator_param + " json " + source;
 
+            Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
             if (m_options.getVerbose()) {
                 std::cout << command.c_str() << std::endl;
                 result = bp::system(command.c_str());
@@ -725,6 +731,7 @@ std::vector<fs::path> ConanSystemTool::retrievePaths(const Dependency & dependen
                 buildMode += "shared=True";
             }
             std::string command = m_systemInstallerPath.generic_string(utf8) + " install " + "-o " + buildMode + " " + boost::algorithm::join(settingsArgs, " ") + " -s " + buildType + " -s " + cppStd + " -pr " + profileName + " " + dest_param + " " + destination.generic_string(utf8) + " " + boost::algorithm::join(optionsArgs, " ") + " " + generator_param + " json " + source;
+            Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
             if (m_options.getVerbose()) {
                 std::cout << command.c_str() << std::endl;
                 result = bp::system(command.c_str());
@@ -919,6 +926,7 @@ int ConanSystemTool::conanVersion()
     if (m_options.getVerbose()) {
         std::cout << m_systemInstallerPath.generic_string(utf8) << " --version" << std::endl;
     }
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string(utf8));
     int result = bp::system(m_systemInstallerPath, "--version", bp::std_out > listOutputFut, ios);
     if (result != 0) {
         throw std::runtime_error("Error running conan --version");
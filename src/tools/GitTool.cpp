@@ -1,4 +1,5 @@
 #include "src/tools/SystemTools.h"
+#include "utils/Trace.h"
 
 #include <boost/process.hpp>
 #include <boost/predef.h>
@@ -30,6 +31,8 @@ int GitTool::clone(const std::string & url, const fs::path & destinationRootFold
         settingsArgs.push_back("-o");
     }
 
+    Trace::Span span("process", "git");
+    span.setArg("command", "clone");
     result = bp::system(m_gitToolPath, "clone", bp::args(settingsArgs), url.c_str(), destinationRootFolder.generic_string(utf8).c_str());
     return result;
 }
@@ -56,6 +59,8 @@ int GitTool::clone(const std::string & url, const fs::path & destinationRootFold
         settingsArgs.push_back("-o");
     }
 
+    Trace::Span span("process", "git");
+    span.setArg("command", "clone");
     result = bp::system(m_gitToolPath, "clone", bp::args(settingsArgs), url.c_str(), destinationRootFolder.generic_string(utf8).c_str());
     return result;
 }
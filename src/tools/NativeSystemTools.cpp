@@ -1,4 +1,5 @@
 #include "NativeSystemTools.h"
+#include "utils/Trace.h"
 //#include "utils/OsUtils.h"
 
 #include <boost/process.hpp>
@@ -25,6 +26,7 @@ void NativeSystemTool::bundleScript ([[maybe_unused]] const Dependency & depende
 
 void AptSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(),m_systemInstallerPath, "update");
     if (result != 0) {
         throw std::runtime_error("Error updating apt repositories");
@@ -82,6 +84,7 @@ void AptSystemTool::install(const Dependency & dependency)
 
     addRemote(dependency.getBaseRepository());
 
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "install","-y", source.c_str());
 
     if (result != 0) {
@@ -93,6 +96,7 @@ bool AptSystemTool::installed(const Dependency & dependency)
 {
     fs::path dpkg = bp::search_path("dpkg-query");
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", dpkg.filename().generic_string());
     int result = bp::system(dpkg, "-W","-f='${Status}'", source.c_str(),"|","grep -q \"ok installed\"");
     return result == 0;
 }
@@ -120,6 +124,7 @@ void AptSystemTool::search(const std::string & pkgName, [[maybe_unused]] const s
 
 void YumSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "update","-y");
     if (result != 0) {
         throw std::runtime_error("Error updating yum repositories");
@@ -129,6 +134,7 @@ void YumSystemTool::update()
 void YumSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "install","-y", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing yum dependency : " + source);
@@ -139,6 +145,7 @@ bool YumSystemTool::installed(const Dependency & dependency)
 {
     fs::path rpm = bp::search_path("rpm");
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", rpm.filename().generic_string());
     int result = bp::system(rpm, "-q",source.c_str());
     return result == 0;
 }
@@ -155,6 +162,7 @@ std::string YumSystemTool::retrieveInstallCommand(const Dependency & dependency)
 
 void PacManSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "-Syyu","--noconfirm");
     if (result != 0) {
         throw std::runtime_error("Error updating pacman repositories");
@@ -164,6 +172,7 @@ void PacManSystemTool::update()
 void PacManSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "-S","--noconfirm", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing pacman dependency : " + source);
@@ -187,6 +196,7 @@ std::string PacManSystemTool::retrieveInstallCommand(const Dependency & dependen
 
 void PkgToolSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "update");
     if (result != 0) {
         throw std::runtime_error("Error updating pacman repositories");
@@ -196,6 +206,7 @@ void PkgToolSystemTool::update()
 void PkgToolSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "install", "-y", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing vcpkg dependency : " + source);
@@ -205,6 +216,7 @@ void PkgToolSystemTool::install(const Dependency & dependency)
 bool PkgToolSystemTool::installed(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "info", source.c_str());
     return result == 0;
 }
@@ -221,6 +233,7 @@ std::string PkgToolSystemTool::retrieveInstallCommand(const Dependency & depende
 
 void PkgUtilSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "--catalog");
     if (result != 0) {
         throw std::runtime_error("Error updating pacman repositories");
@@ -230,6 +243,7 @@ void PkgUtilSystemTool::update()
 void PkgUtilSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "--install","--yes", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing pacman dependency : " + source);
@@ -253,6 +267,7 @@ std::string PkgUtilSystemTool::retrieveInstallCommand(const Dependency & depende
 
 void ChocoSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "outdated");
     if (result != 0) {
         throw std::runtime_error("Error updating choco repositories");
@@ -262,6 +277,7 @@ void ChocoSystemTool::update()
 void ChocoSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "install","--yes", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing choco dependency : " + source);
@@ -298,6 +314,7 @@ void ChocoSystemTool::search(const std::string & pkgName, [[maybe_unused]] const
 
 void ScoopSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "update");
     if (result != 0) {
         throw std::runtime_error("Error updating scoop repositories");
@@ -340,6 +357,7 @@ void ScoopSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
     addRemote(dependency.getBaseRepository());
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "install","--yes", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing scoop dependency : " + source);
@@ -379,6 +397,7 @@ void ScoopSystemTool::search(const std::string & pkgName, [[maybe_unused]] const
 
 void ZypperSystemTool::update()
 {
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "--non-interactive","ref");
     if (result != 0) {
         throw std::runtime_error("Error updating zypper repositories");
@@ -388,6 +407,7 @@ void ZypperSystemTool::update()
 void ZypperSystemTool::install(const Dependency & dependency)
 {
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(sudo(), m_systemInstallerPath, "--non-interactive","in", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing zypper dependency : " + source);
@@ -398,6 +418,7 @@ bool ZypperSystemTool::installed(const Dependency & dependency)
 {
     fs::path rpm = bp::search_path("rpm");
     std::string source = computeToolRef(dependency);
+    Trace::Span span("process", rpm.filename().generic_string());
     int result = bp::system(rpm, "-q",source.c_str());
     return result == 0;
 }
@@ -30,7 +30,7 @@ class NativeSystemTool : public BaseSystemTool
 public:
     NativeSystemTool(const CmdOptions & options, const std::string & installer):BaseSystemTool(options, installer) { m_bundleScripted = true;}
     virtual ~NativeSystemTool() = default;
-    virtual void bundle ([[maybe_unused]] const Dependency & dependency) override {
+    virtual void bundle ([[maybe_unused]] const Dependency & dependency, [[maybe_unused]] BundleEngine & engine) override {
         BOOST_LOG_TRIVIAL(info)<<"bundle() for tool "<<m_systemInstallerPath<<" generates a shell install script";
     }
     virtual void search ([[maybe_unused]] const std::string & pkgName, [[maybe_unused]] const std::string & version) override {
@@ -6,6 +6,7 @@
 #include <string>
 #include "PkgConfigTool.h"
 #include "backends/BackendGeneratorFactory.h"
+#include "utils/Trace.h"
 
 namespace bp = boost::process;
 
@@ -65,6 +66,7 @@ void PkgConfigTool::libs(Dependency & dep, const std::vector<std::string> & opti
     if (dep.getType() == Dependency::Type::REMAKEN) {
         pkgconfigFileName = deduceRemakenPkgConfigFilename(dep);
     }
+    Trace::Span span("process", m_pkgConfigToolPath.filename().generic_string(utf8));
     int result = bp::system(m_pkgConfigToolPath.generic_string(utf8), "--libs", bp::args(options), env,  pkgconfigFileName, bp::std_out > listOutputFut, ios);
     if (result != 0) {
         throw std::runtime_error("Error running pkg-config --libs on '" + pkgconfigFileName + "'");
@@ -89,6 +91,7 @@ void PkgConfigTool::cflags(Dependency & dep, const std::vector<std::string> & op
     if (dep.getType() == Dependency::Type::REMAKEN) {
         pkgconfigFileName = deduceRemakenPkgConfigFilename(dep);
     }
+    Trace::Span span("process", m_pkgConfigToolPath.filename().generic_string(utf8));
     int result = bp::system(m_pkgConfigToolPath.generic_string(utf8), "--cflags", bp::args(options), env,  pkgconfigFileName, bp::std_out > listOutputFut, ios);
     if (result != 0) {
         throw std::runtime_error("Error running pkg-config --cflags on '" + pkgconfigFileName + "'");
@@ -117,6 +120,8 @@ static const std::map<Dependency::Type,std::string> type2prefixMap = {
 std::pair<std::string, fs::path> PkgConfigTool::generate(const std::vector<Dependency> & deps, Dependency::Type depType)
 {
     std::shared_ptr<IGeneratorBackend> generator = BackendGeneratorFactory::getGenerator(m_options);
+    Trace::Span span("generator", m_options.getGenerator() + " " + (mapContains(type2prefixMap, depType) ? type2prefixMap.at(depType) : std::string("")));
+    span.setArg("dependencies", static_cast<uint64_t>(deps.size()));
     return generator->generate(deps, depType);
 }
 
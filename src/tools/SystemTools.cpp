@@ -4,6 +4,7 @@
 #include "ConanSystemTool.h"
 #include "PkgConfigTool.h"
 #include "utils/OsUtils.h"
+#include "utils/Trace.h"
 
 #include <boost/process.hpp>
 #include <boost/predef.h>
@@ -168,6 +169,8 @@ std::string SystemTools::run(const fs::path & tool, const std::string & command,
     boost::asio::io_context ios;
     std::future<std::string> listOutputFut;
     int result = -1;
+    Trace::Span span("process", tool.filename().generic_string(utf8));
+    span.setArg("command", command + " " + subCommand);
     if (cmdValue.empty()) {
         result = bp::system(tool, command, subCommand, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -192,6 +195,8 @@ std::string SystemTools::run(const fs::path & tool, const std::string & command,
     boost::asio::io_context ios;
     std::future<std::string> listOutputFut;
     int result = -1;
+    Trace::Span span("process", tool.filename().generic_string(utf8));
+    span.setArg("command", command);
     if (cmdValue.empty()) {
         result = bp::system(tool, command, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -216,6 +221,8 @@ std::string SystemTools::runAsRoot(const fs::path & sudoTool, const fs::path & t
     boost::asio::io_context ios;
     std::future<std::string> listOutputFut;
     int result = -1;
+    Trace::Span span("process", tool.filename().generic_string(utf8));
+    span.setArg("command", command + " " + subCommand);
     if (cmdValue.empty()) {
         result = bp::system(sudoTool, tool, command, subCommand, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -241,6 +248,8 @@ std::string SystemTools::runAsRoot(const fs::path & sudoTool, const fs::path & t
     boost::asio::io_context ios;
     std::future<std::string> listOutputFut;
     int result = -1;
+    Trace::Span span("process", tool.filename().generic_string(utf8));
+    span.setArg("command", command);
     if (cmdValue.empty()) {
         result = bp::system(sudoTool, tool, command, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -267,6 +276,7 @@ std::string SystemTools::runShellCommand(const std::string & builtinCommand, con
     std::future<std::string> listOutputFut;
     fs::path builtinPath = bp::search_path(builtinCommand);
     int result = -1;
+    Trace::Span span("process", builtinCommand);
     if (cmdValue.empty()) {
         result = bp::system(builtinPath, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -287,6 +297,7 @@ std::string SystemTools::runShellCommand(const std::string & builtinCommand, con
     std::future<std::string> listOutputFut;
     fs::path builtinPath = bp::search_path(builtinCommand);
     int result = -1;
+    Trace::Span span("process", builtinCommand);
     if (cmdValue.empty()) {
         result = bp::system(builtinPath, command, bp::args(options), bp::std_out > listOutputFut, ios);
     }
@@ -30,6 +30,7 @@
 #include <optional>
 #include <boost/log/trivial.hpp>
 #include "utils/DepUtils.h"
+#include "utils/BundleEngine.h"
 
 class BaseSystemTool
 {
@@ -42,7 +43,7 @@ public:
     BaseSystemTool(const CmdOptions & options, const std::string & installer);
     virtual ~BaseSystemTool() = default;
     virtual void update() = 0;
-    virtual void bundle ([[maybe_unused]] const Dependency & dependency) = 0;
+    virtual void bundle ([[maybe_unused]] const Dependency & dependency, [[maybe_unused]] BundleEngine & engine) = 0;
     virtual void bundleScript ([[maybe_unused]] const Dependency & dependency, [[maybe_unused]] const fs::path & scriptFile) = 0;
     virtual void install (const Dependency & dependency) = 0;
     virtual void search (const std::string & pkgName, [[maybe_unused]] const std::string & version = "") = 0;
@@ -1,4 +1,5 @@
 #include "VCPKGSystemTool.h"
+#include "utils/Trace.h"
 #include "utils/OsUtils.h"
 
 #include <boost/process.hpp>
@@ -32,17 +33,18 @@ void VCPKGSystemTool::update()
 {
 }
 
-void VCPKGSystemTool::bundle (const Dependency & dependency)
+void VCPKGSystemTool::bundle (const Dependency & dependency, BundleEngine & engine)
 {
     std::vector<fs::path> libs = libPaths(dependency);
     for (auto & libPath : libs) {
-        OsUtils::copySharedLibraries(libPath,m_options);
+        engine.addSharedLibraries(libPath);
     }
     // missing sub deps : depend-info must be filtered to use only the package: entry
 
     std::string source = computeToolRef (dependency);
     std::future<std::string> depsOutputFut;
     boost::asio::io_context ios;
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     /*int result =*/ bp::system(m_systemInstallerPath, "depend-info", source.c_str(), bp::std_out > depsOutputFut, ios);
     auto depsString  = depsOutputFut.get();
     std::vector<std::string> deps;
@@ -60,6 +62,7 @@ void VCPKGSystemTool::bundleLib(const std::string & libPath)
     fs::detail::utf8_codecvt_facet utf8;
     boost::asio::io_context ios;
     std::future<std::string> listOutputFut;
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     /*int result =*/ bp::system(m_systemInstallerPath, "list", libPath.c_str(), bp::std_out > listOutputFut, ios);
     auto libsString = listOutputFut.get();
     std::vector<std::string> libsPath;
@@ -75,6 +78,7 @@ void VCPKGSystemTool::bundleLib(const std::string & libPath)
 void VCPKGSystemTool::install(const Dependency & dependency)
 {
     std::string source = this->computeToolRef(dependency);
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     int result = bp::system(m_systemInstallerPath, "install", source.c_str());
     if (result != 0) {
         throw std::runtime_error("Error installing vcpkg dependency : " + source);
@@ -90,6 +94,7 @@ void VCPKGSystemTool::search(const std::string & pkgName, [[maybe_unused]] const
 {
     std::string package = pkgName;
     std::cout<<"Vcpkg::search results:"<<std::endl;
+    Trace::Span span("process", m_systemInstallerPath.filename().generic_string());
     bp::system(m_systemInstallerPath, "search", pkgName);
 }
 
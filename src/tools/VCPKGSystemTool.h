@@ -32,7 +32,7 @@ public:
     VCPKGSystemTool(const CmdOptions & options):BaseSystemTool(options, "vcpkg") {}
     ~VCPKGSystemTool() override = default;
     void update() override;
-    void bundle(const Dependency & dependency) override;
+    void bundle(const Dependency & dependency, BundleEngine & engine) override;
     void bundleScript ([[maybe_unused]] const Dependency & dependency, [[maybe_unused]] const fs::path & scriptFile) override {}
     void install(const Dependency & dependency) override;
     bool installed(const Dependency & dependency) override;
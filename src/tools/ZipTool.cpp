@@ -4,6 +4,7 @@
 #include <boost/predef.h>
 #include <string>
 #include "ZipTool.h"
+#include "utils/Trace.h"
 
 namespace bp = boost::process;
 
@@ -30,6 +31,8 @@ int unzipTool::uncompressArtefact(const fs::path & compressedDependency, const f
         settingsArgs.push_back("-u");
     }
 
+    Trace::Span span("zip", "uncompress " + compressedDependency.filename().generic_string(utf8));
+    Trace::Span processSpan("process", "unzip");
     result = bp::system(m_zipToolPath, bp::args(settingsArgs), compressedDependency.generic_string(utf8).c_str(), "-d", destinationRootFolder.generic_string(utf8).c_str());
     return result;
 }
@@ -48,6 +51,8 @@ int sevenZTool::uncompressArtefact(const fs::path & compressedDependency, const
     std::string outputDirOption = "-o";
     outputDirOption += destinationRootFolder.generic_string(utf8).c_str();
     int result = -1;
+    Trace::Span span("zip", "uncompress " + compressedDependency.filename().generic_string(utf8));
+    Trace::Span processSpan("process", "7z");
     if (m_quiet) {
         result = bp::system(m_zipToolPath,"x", compressedDependency.generic_string(utf8).c_str(), outputDirOption, "-y", bp::std_out > bp::null);
     }
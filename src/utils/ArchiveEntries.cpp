@@ -0,0 +1,75 @@
+#include "ArchiveEntries.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+}
+
+void ArchiveEntries::addParentDirectories(const std::string & entryName)
+{
+    for (std::size_t pos = entryName.find('/'); pos != std::string::npos; pos = entryName.find('/', pos + 1)) {
+        if (pos > 0) {
+            m_entries.insert({entryName.substr(0, pos), Entry{Type::Directory, fs::path(), {}}});
+        }
+    }
+}
+
+void ArchiveEntries::addFile(const std::string & entryName, const fs::path & sourcePath, const ElfUtils::Patches & patches)
+{
+    Type type = fs::is_symlink(sourcePath) ? Type::Symlink : Type::File;
+    m_entries[entryName] = Entry{type, sourcePath, patches};
+    addParentDirectories(entryName);
+}
+
+void ArchiveEntries::addEmptyFile(const std::string & entryName)
+{
+    m_entries[entryName] = Entry{Type::EmptyFile, fs::path(), {}};
+    addParentDirectories(entryName);
+}
+
+void ArchiveEntries::addDirectory(const std::string & entryName)
+{
+    m_entries[entryName] = Entry{Type::Directory, fs::path(), {}};
+    addParentDirectories(entryName);
+}
+
+bool ArchiveEntries::isExecutable(const Entry & entry)
+{
+    return (fs::status(entry.sourcePath).permissions() & (fs::owner_exe | fs::group_exe | fs::others_exe)) != 0;
+}
+
+uint64_t ArchiveEntries::fileSize(const Entry & entry)
+{
+    return ElfUtils::patchedSize(fs::file_size(entry.sourcePath), entry.patches);
+}
+
+void ArchiveEntries::readFile(const Entry & entry, uint64_t size, const std::function<void(const char *, std::size_t)> & consumer)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::ifstream source(entry.sourcePath.generic_string(utf8), std::ios::in | std::ios::binary);
+    if (!source.is_open()) {
+        throw std::runtime_error("Unable to read " + entry.sourcePath.generic_string(utf8));
+    }
+    uint64_t sourceSize = fs::file_size(entry.sourcePath);
+    if (ElfUtils::patchedSize(sourceSize, entry.patches) != size) {
+        throw std::runtime_error("Unable to read " + entry.sourcePath.generic_string(utf8) + " : file modified while archived");
+    }
+    // patches can extend the file : the content past the source end is zero filled before they are applied
+    std::vector<char> buffer(CHUNK_SIZE);
+    for (uint64_t offset = 0; offset < size; offset += buffer.size()) {
+        std::size_t chunkSize = static_cast<std::size_t>(std::min<uint64_t>(size - offset, buffer.size()));
+        std::size_t readSize = static_cast<std::size_t>(std::min<uint64_t>(chunkSize, sourceSize > offset ? sourceSize - offset : 0));
+        source.read(buffer.data(), static_cast<std::streamsize>(readSize));
+        if (static_cast<std::size_t>(source.gcount()) != readSize) {
+            throw std::runtime_error("Unable to read " + entry.sourcePath.generic_string(utf8) + " : file modified while archived");
+        }
+        std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(readSize), buffer.begin() + static_cast<std::ptrdiff_t>(chunkSize), '\0');
+        ElfUtils::applyPatches(entry.patches, offset, buffer.data(), chunkSize);
+        consumer(buffer.data(), chunkSize);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief sorted entries and patched file content shared by the archive writers
+ * @date 2026-10-19
+ */
+
+#ifndef ARCHIVEENTRIES_H
+#define ARCHIVEENTRIES_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "ElfUtils.h"
+
+namespace fs = boost::filesystem;
+
+// Entries of a ZipWriter or TarWriter archive, sorted by name : every parent folder gets its own entry.
+class ArchiveEntries
+{
+public:
+    enum class Type {
+        File,
+        EmptyFile,
+        Symlink,
+        Directory
+    };
+    typedef struct {
+        Type type;
+        fs::path sourcePath;
+        ElfUtils::Patches patches;
+    } Entry;
+
+    // entryName is the generic path of the entry in the archive, patches are applied to the archived content
+    void addFile(const std::string & entryName, const fs::path & sourcePath, const ElfUtils::Patches & patches = {});
+    void addEmptyFile(const std::string & entryName);
+    void addDirectory(const std::string & entryName);
+    const std::map<std::string, Entry> & entries() const { return m_entries; }
+
+    static bool isExecutable(const Entry & entry);
+    // archived size of a File entry, with its patches
+    static uint64_t fileSize(const Entry & entry);
+    // reads the archived content of a File entry by chunks : throws std::runtime_error when its size is no longer size
+    static void readFile(const Entry & entry, uint64_t size, const std::function<void(const char *, std::size_t)> & consumer);
+
+private:
+    void addParentDirectories(const std::string & entryName);
+
+    std::map<std::string, Entry> m_entries;
+};
+
+#endif // ARCHIVEENTRIES_H
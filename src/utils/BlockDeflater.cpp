@@ -0,0 +1,145 @@
+#include "BlockDeflater.h"
+#include "HashUtils.h"
+#include <boost/asio/post.hpp>
+#include <zlib.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t COMPRESSION_BLOCK_SIZE = 1 << 20;
+constexpr std::size_t DICTIONARY_SIZE = 1 << 15;
+
+}
+
+BlockDeflater::BlockDeflater(int level, std::function<void(const char *, std::size_t)> output):m_level(level),m_output(output),
+    m_jobs(HashUtils::defaultJobs()),m_pool(m_jobs)
+{
+    m_crc = crc32(0L, Z_NULL, 0);
+}
+
+void BlockDeflater::write(const char * data, std::size_t size)
+{
+    while (size > 0) {
+        // a full block is only pushed when more data comes : the last block of a stream is never empty
+        if (!m_hasCurrent || m_current.size() == COMPRESSION_BLOCK_SIZE) {
+            if (m_hasCurrent) {
+                pushBlock(false);
+            }
+            m_current.reserve(COMPRESSION_BLOCK_SIZE);
+            m_hasCurrent = true;
+        }
+        std::size_t copySize = std::min(size, COMPRESSION_BLOCK_SIZE - m_current.size());
+        m_current.insert(m_current.end(), data, data + copySize);
+        data += copySize;
+        size -= copySize;
+    }
+}
+
+void BlockDeflater::endStream(std::function<void(uint32_t, uint64_t)> onEnd)
+{
+    // the final deflate block is mandatory, even for an empty stream
+    m_hasCurrent = true;
+    pushBlock(true, onEnd);
+}
+
+void BlockDeflater::enqueue(std::function<void()> action)
+{
+    if (m_hasCurrent) {
+        pushBlock(false);
+    }
+    m_items.push_back(Item{{}, false, nullptr, action, {}, 0, {}});
+}
+
+void BlockDeflater::pushBlock(bool last, std::function<void(uint32_t, uint64_t)> onEnd)
+{
+    m_items.push_back(Item{std::move(m_current), last, onEnd, nullptr, {}, 0, {}});
+    m_current = std::vector<char>();
+    m_hasCurrent = false;
+    if (++m_pendingBlocks == m_jobs * 4) {
+        flush();
+    }
+}
+
+void BlockDeflater::compressBlock(int level, const std::vector<char> & dictionary, Item & item)
+{
+    item.crc = static_cast<uint32_t>(crc32(0L, reinterpret_cast<const Bytef *>(item.input.data()), static_cast<uInt>(item.input.size())));
+    z_stream zs{};
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        item.error = "Unable to initialize deflate";
+        return;
+    }
+    if (!dictionary.empty()) {
+        deflateSetDictionary(&zs, reinterpret_cast<const Bytef *>(dictionary.data()), static_cast<uInt>(dictionary.size()));
+    }
+    std::vector<char> buffer(deflateBound(&zs, static_cast<uLong>(item.input.size())) + 16);
+    zs.next_in = reinterpret_cast<Bytef *>(item.input.data());
+    zs.avail_in = static_cast<uInt>(item.input.size());
+    int result = Z_OK;
+    do {
+        zs.next_out = reinterpret_cast<Bytef *>(buffer.data());
+        zs.avail_out = static_cast<uInt>(buffer.size());
+        result = deflate(&zs, item.last ? Z_FINISH : Z_SYNC_FLUSH);
+        item.output.append(buffer.data(), buffer.size() - zs.avail_out);
+    } while (zs.avail_out == 0 || (item.last && result != Z_STREAM_END));
+    deflateEnd(&zs);
+}
+
+void BlockDeflater::flush()
+{
+    // each block is primed with the end of the previous block of its stream
+    std::vector<std::vector<char>> dictionaries(m_items.size());
+    const std::vector<char> * previous = m_streamContinues ? &m_dictionary : nullptr;
+    for (std::size_t index = 0; index < m_items.size(); index++) {
+        if (m_items[index].action) {
+            continue;
+        }
+        if (previous != nullptr) {
+            std::size_t dictionarySize = std::min(previous->size(), DICTIONARY_SIZE);
+            dictionaries[index].assign(previous->end() - static_cast<std::ptrdiff_t>(dictionarySize), previous->end());
+        }
+        previous = m_items[index].last ? nullptr : &m_items[index].input;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (std::size_t index = 0; index < m_items.size(); index++) {
+            if (!m_items[index].action) {
+                m_compressingBlocks++;
+                boost::asio::post(m_pool, [this, index, &dictionaries]() {
+                    compressBlock(m_level, dictionaries[index], m_items[index]);
+                    std::lock_guard<std::mutex> blockLock(m_mutex);
+                    if (--m_compressingBlocks == 0) {
+                        m_compressed.notify_one();
+                    }
+                });
+            }
+        }
+        m_compressed.wait(lock, [this]() { return m_compressingBlocks == 0; });
+    }
+    m_streamContinues = (previous != nullptr);
+    if (m_streamContinues) {
+        m_dictionary = *previous;
+    }
+    std::vector<Item> items = std::move(m_items);
+    m_items.clear();
+    m_pendingBlocks = 0;
+    for (auto & item : items) {
+        if (item.action) {
+            item.action();
+            continue;
+        }
+        if (!item.error.empty()) {
+            throw std::runtime_error(item.error);
+        }
+        m_output(item.output.data(), item.output.size());
+        m_crc = static_cast<uint32_t>(crc32_combine(m_crc, item.crc, static_cast<z_off_t>(item.input.size())));
+        m_size += item.input.size();
+        if (item.last) {
+            if (item.onEnd) {
+                item.onEnd(m_crc, m_size);
+            }
+            m_crc = static_cast<uint32_t>(crc32(0L, Z_NULL, 0));
+            m_size = 0;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief multithreaded deflate compression by blocks
+ * @date 2026-10-19
+ */
+
+#ifndef BLOCKDEFLATER_H
+#define BLOCKDEFLATER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/asio/thread_pool.hpp>
+
+// Compresses raw deflate streams by blocks on a thread pool (pigz like) : each block of a stream is primed with the last 32KB
+// of the previous block and flushed on a byte boundary, so the concatenation of the compressed blocks of a stream is a single deflate stream.
+// Block boundaries only depend on the written data : the output doesn't depend on the number of threads.
+// Blocks of successive streams are compressed together : small streams (archive entries) are also compressed in parallel.
+// The thread pool lives as long as the deflater : it is shared by every batch of blocks.
+class BlockDeflater
+{
+public:
+    // output receives the compressed data, in order
+    BlockDeflater(int level, std::function<void(const char *, std::size_t)> output);
+    BlockDeflater(const BlockDeflater &) = delete;
+    BlockDeflater & operator=(const BlockDeflater &) = delete;
+    // appends data to the current stream
+    void write(const char * data, std::size_t size);
+    // ends the current stream : onEnd receives its crc32 and uncompressed size once its last block is output
+    void endStream(std::function<void(uint32_t, uint64_t)> onEnd);
+    // calls action once the data written before is output (archive headers between streams ...)
+    void enqueue(std::function<void()> action);
+    // compresses and outputs the pending blocks : throws std::runtime_error on failure
+    void flush();
+
+private:
+    typedef struct {
+        std::vector<char> input;
+        bool last;
+        std::function<void(uint32_t, uint64_t)> onEnd;
+        std::function<void()> action;
+        std::string output;
+        uint32_t crc;
+        std::string error;
+    } Item;
+
+    void pushBlock(bool last, std::function<void(uint32_t, uint64_t)> onEnd = nullptr);
+    static void compressBlock(int level, const std::vector<char> & dictionary, Item & item);
+
+    int m_level;
+    std::function<void(const char *, std::size_t)> m_output;
+    unsigned int m_jobs = 1;
+    std::vector<Item> m_items;
+    std::size_t m_pendingBlocks = 0;
+    std::vector<char> m_current;
+    bool m_hasCurrent = false;
+    // last block of the previous batch, when its stream continues
+    std::vector<char> m_dictionary;
+    bool m_streamContinues = false;
+    uint32_t m_crc = 0;
+    uint64_t m_size = 0;
+    // blocks of the current batch still being compressed
+    std::size_t m_compressingBlocks = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_compressed;
+    // last member : its threads are joined before the other members are destroyed
+    boost::asio::thread_pool m_pool;
+};
+
+#endif // BLOCKDEFLATER_H
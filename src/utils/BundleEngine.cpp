@@ -0,0 +1,681 @@
+#include "BundleEngine.h"
+#include "Constants.h"
+#include "ElfUtils.h"
+#include "HashUtils.h"
+#include "OsUtils.h"
+#include "TarWriter.h"
+#include "ZipWriter.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/predef.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#ifdef BOOST_OS_LINUX_AVAILABLE
+#include <sys/stat.h>
+#endif
+
+static constexpr const char * BUNDLE_MANIFEST_HEADER = "#remaken-bundle-manifest 3";
+
+// size, modification and status change times and file id of a destination file : any write changes the status change time
+static std::string destinationFileState(const fs::path & filePath)
+{
+#ifdef BOOST_OS_LINUX_AVAILABLE
+    struct stat fileStat;
+    if (lstat(filePath.c_str(), &fileStat) != 0) {
+        return "";
+    }
+    return std::to_string(fileStat.st_size) + ":" + std::to_string(fileStat.st_mtim.tv_sec) + "." + std::to_string(fileStat.st_mtim.tv_nsec)
+            + ":" + std::to_string(fileStat.st_ctim.tv_sec) + "." + std::to_string(fileStat.st_ctim.tv_nsec) + ":" + std::to_string(fileStat.st_ino);
+#else
+    return OsUtils::fileIdentity(filePath);
+#endif
+}
+
+BundleEngine::BundleEngine(const CmdOptions & options):m_options(options)
+{
+    if (m_options.getBundleLinkMode() == "symlink") {
+        m_linkMode = LinkMode::Symlink;
+    }
+    else if (m_options.getBundleLinkMode() == "hardlink") {
+        m_linkMode = LinkMode::Hardlink;
+    }
+    // the archive gets the destination files written by the bundle command : the existing ones are listed first
+    boost::system::error_code ec;
+    fs::path destinationRoot = m_options.getDestinationRoot();
+    if (!m_options.getBundleArchive().empty() && fs::is_directory(destinationRoot, ec)) {
+        for (fs::recursive_directory_iterator it(destinationRoot), end; it != end; ++it) {
+            if (!fs::is_directory(it->symlink_status())) {
+                m_previousDestinationFiles[it->path()] = destinationFileState(it->path());
+            }
+        }
+    }
+}
+
+void BundleEngine::addSharedLibraries(const fs::path & sourceFolder)
+{
+    fs::path destinationFolder = m_options.getDestinationRoot();
+    if (m_options.isXpcfBundle()) {
+        destinationFolder /= m_options.getModulesSubfolder();
+    }
+    addLibraries(sourceFolder, destinationFolder, OsUtils::sharedSuffix(m_options.getOS()));
+}
+
+void BundleEngine::addLibraries(const fs::path & sourceFolder, const fs::path & destinationFolder, const std::string_view & suffix)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    fs::path canonicalFolder = fs::canonical(sourceFolder, ec);
+    if (ec) {
+        canonicalFolder = sourceFolder;
+    }
+    std::string folderKey = canonicalFolder.generic_string(utf8) + "|" + destinationFolder.generic_string(utf8) + "|" + std::string(suffix);
+    if (!m_walkedFolders.insert(folderKey).second) {
+        return;
+    }
+    // concrete libraries first : symbolic links are recreated once their targets are copied
+    std::vector<fs::path> libraries, symlinks;
+    for (fs::directory_entry & x : fs::directory_iterator(sourceFolder)) {
+        fs::file_status status = x.symlink_status();
+        if (fs::is_directory(status) || !OsUtils::hasLibrarySuffix(x.path(), suffix)) {
+            continue;
+        }
+        if (fs::is_symlink(status)) {
+            symlinks.push_back(x.path());
+        }
+        else if (fs::is_regular_file(status)) {
+            libraries.push_back(x.path());
+        }
+    }
+    std::sort(libraries.begin(), libraries.end());
+    std::sort(symlinks.begin(), symlinks.end());
+    for (auto & library : libraries) {
+        addLibrary(library, destinationFolder);
+    }
+    for (auto & symlink : symlinks) {
+        addLibrary(symlink, destinationFolder);
+    }
+}
+
+void BundleEngine::addLibrary(const fs::path & sourcePath, const fs::path & destinationFolder)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    fs::path destinationPath = destinationFolder / sourcePath.filename();
+    bool symlink = fs::is_symlink(sourcePath, ec);
+    if (mapContains(m_destinations, destinationPath)) {
+        const Entry & entry = m_entries[m_destinations.at(destinationPath)];
+        if (entry.sourcePath != sourcePath && !fs::equivalent(entry.sourcePath, sourcePath, ec)) {
+            m_options.verboseMessage("===> " + destinationPath.filename().generic_string(utf8) + " from " + sourcePath.generic_string(utf8)
+                                     + " skipped : already bundled from " + entry.sourcePath.generic_string(utf8));
+        }
+        return;
+    }
+    // the ELF dynamic sections are read at once on the thread pool when the engine runs
+    m_destinations[destinationPath] = m_entries.size();
+    m_entries.push_back({sourcePath, destinationPath, m_origin, symlink, 0, 0, 0, ElfUtils::DynamicInfo(), ""});
+}
+
+void BundleEngine::readDynamicInfos()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    {
+        boost::asio::thread_pool pool(HashUtils::defaultJobs());
+        for (auto & entry : m_entries) {
+            if (!entry.symlink) {
+                boost::asio::post(pool, [&entry]() {
+                    ElfUtils::readDynamicInfo(entry.sourcePath, entry.dynamicInfo);
+                });
+            }
+        }
+        pool.join();
+    }
+    // the loader searches libraries by SONAME : another version of a library with the same SONAME would never be loaded.
+    // Entries are checked in their adding order : the first provider wins, as with sequential copies
+    std::map<std::string, fs::path> sonameProviders;
+    std::vector<Entry> entries;
+    m_destinations.clear();
+    for (auto & entry : m_entries) {
+        const std::string & soname = entry.dynamicInfo.soname;
+        if (!entry.symlink && !soname.empty() && boost::starts_with(entry.sourcePath.filename().generic_string(utf8), soname)) {
+            boost::system::error_code ec;
+            if (!mapContains(sonameProviders, soname)) {
+                sonameProviders[soname] = entry.sourcePath;
+            }
+            else if (!fs::equivalent(sonameProviders.at(soname), entry.sourcePath, ec)) {
+                BOOST_LOG_TRIVIAL(warning)<<"SONAME conflict: "<<soname<<" is provided by "<<sonameProviders.at(soname)<<" and "<<entry.sourcePath<<" - bundling "<<sonameProviders.at(soname);
+                continue;
+            }
+        }
+        m_destinations[entry.destinationPath] = entries.size();
+        entries.push_back(std::move(entry));
+    }
+    m_entries = std::move(entries);
+}
+
+void BundleEngine::addTarget(const fs::path & filePath)
+{
+    m_targets.push_back(filePath);
+}
+
+namespace {
+
+// folders searched by the loader for the libraries that are not bundled
+const std::vector<fs::path> & systemLibraryFolders()
+{
+    static const std::vector<fs::path> folders = []() {
+        std::vector<fs::path> result;
+        for (const char * folder : {"/lib", "/lib64", "/usr/lib", "/usr/lib64", "/usr/local/lib"}) {
+            boost::system::error_code ec;
+            if (!fs::is_directory(folder, ec)) {
+                continue;
+            }
+            result.push_back(folder);
+            // multiarch folders (x86_64-linux-gnu ...)
+            for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+                if (it->path().filename().string().find("-linux-") != std::string::npos && fs::is_directory(it->path(), ec)) {
+                    result.push_back(it->path());
+                }
+            }
+        }
+        return result;
+    }();
+    return folders;
+}
+
+bool isSystemLibrary(const std::string & name)
+{
+    boost::system::error_code ec;
+    for (auto & folder : systemLibraryFolders()) {
+        if (fs::exists(folder / name, ec)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+std::multimap<std::string, std::size_t> BundleEngine::neededProviders() const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    // a needed name is either a bundled file name or the SONAME of a bundled library
+    std::multimap<std::string, std::size_t> providers;
+    for (std::size_t index = 0; index < m_entries.size(); index++) {
+        const Entry & entry = m_entries[index];
+        std::string fileName = entry.destinationPath.filename().generic_string(utf8);
+        providers.insert({fileName, index});
+        if (!entry.dynamicInfo.soname.empty() && entry.dynamicInfo.soname != fileName) {
+            providers.insert({entry.dynamicInfo.soname, index});
+        }
+    }
+    return providers;
+}
+
+void BundleEngine::computeRunpaths()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::multimap<std::string, std::size_t> providers = neededProviders();
+    for (auto & entry : m_entries) {
+        const ElfUtils::DynamicInfo & info = entry.dynamicInfo;
+        if (entry.symlink) {
+            continue;
+        }
+        // DT_RUNPATH only applies to the direct needs of a file : each file gets the folders of its own needed libraries
+        std::set<std::string> folders;
+        fs::path folder = entry.destinationPath.parent_path();
+        for (auto & name : info.needed) {
+            auto range = providers.equal_range(name);
+            for (auto it = range.first; it != range.second; ++it) {
+                fs::path relativeFolder = m_entries[it->second].destinationPath.parent_path().lexically_relative(folder);
+                if (relativeFolder.empty() || relativeFolder == ".") {
+                    folders.insert("$ORIGIN");
+                }
+                else {
+                    folders.insert("$ORIGIN/" + relativeFolder.generic_string(utf8));
+                }
+            }
+        }
+        // build folders of the original search path are not kept
+        if (folders.empty() && (!info.rpath.empty() || !info.runpath.empty())) {
+            folders.insert("$ORIGIN");
+        }
+        entry.runpath = boost::join(folders, ":");
+    }
+}
+
+std::size_t BundleEngine::removeUnneededEntries()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::multimap<std::string, std::size_t> providers = neededProviders();
+    std::vector<bool> needed(m_entries.size(), false);
+    std::vector<std::size_t> pendingEntries;
+    std::map<std::string, std::set<std::string>> unresolvedNames;
+    std::function<void(std::size_t)> keepEntry = [&](std::size_t index) {
+        if (needed[index]) {
+            return;
+        }
+        needed[index] = true;
+        const Entry & entry = m_entries[index];
+        if (!entry.symlink) {
+            pendingEntries.push_back(index);
+            return;
+        }
+        // the link target is bundled in the same folder
+        boost::system::error_code ec;
+        fs::path target = entry.destinationPath.parent_path() / fs::read_symlink(entry.sourcePath, ec).filename();
+        if (!ec && mapContains(m_destinations, target)) {
+            keepEntry(m_destinations.at(target));
+        }
+    };
+    auto resolve = [&](const std::vector<std::string> & names, const std::string & requester) {
+        for (auto & name : names) {
+            auto range = providers.equal_range(name);
+            if (range.first != range.second) {
+                for (auto it = range.first; it != range.second; ++it) {
+                    keepEntry(it->second);
+                }
+            }
+            else if (!isSystemLibrary(name)) {
+                unresolvedNames[name].insert(requester);
+            }
+        }
+    };
+
+    for (auto & target : m_targets) {
+        bool bundled = false;
+        for (std::size_t index = 0; index < m_entries.size(); index++) {
+            boost::system::error_code ec;
+            if (!m_entries[index].symlink && fs::equivalent(m_entries[index].sourcePath, target, ec)) {
+                keepEntry(index);
+                bundled = true;
+            }
+        }
+        if (!bundled) {
+            ElfUtils::DynamicInfo info;
+            if (!ElfUtils::readDynamicInfo(target, info)) {
+                throw std::runtime_error("Error : " + target.generic_string(utf8) + " is not an ELF file with a dynamic section : its needed libraries can't be resolved");
+            }
+            resolve(info.needed, target.filename().generic_string(utf8));
+        }
+    }
+    while (!pendingEntries.empty()) {
+        const Entry & entry = m_entries[pendingEntries.back()];
+        pendingEntries.pop_back();
+        resolve(entry.dynamicInfo.needed, entry.destinationPath.filename().generic_string(utf8));
+    }
+    for (auto & [name, requesters] : unresolvedNames) {
+        BOOST_LOG_TRIVIAL(warning)<<"Unresolved needed library "<<name<<" (needed by "<<boost::join(requesters, ", ")<<") : neither bundled nor found in the system library folders";
+    }
+
+    std::vector<Entry> neededEntries;
+    for (std::size_t index = 0; index < m_entries.size(); index++) {
+        if (needed[index]) {
+            neededEntries.push_back(std::move(m_entries[index]));
+        }
+        else {
+            m_options.verboseMessage("===> " + m_entries[index].sourcePath.generic_string(utf8) + " skipped : not needed");
+        }
+    }
+    std::size_t removedCount = m_entries.size() - neededEntries.size();
+    m_entries = std::move(neededEntries);
+    m_destinations.clear();
+    for (std::size_t index = 0; index < m_entries.size(); index++) {
+        m_destinations[m_entries[index].destinationPath] = index;
+    }
+    return removedCount;
+}
+
+void BundleEngine::checkHardLinks() const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::set<std::pair<fs::path, fs::path>> checkedFolders;
+    for (auto & entry : m_entries) {
+        auto folders = std::make_pair(entry.sourcePath.parent_path(), entry.destinationPath.parent_path());
+        if (!entry.symlink && checkedFolders.insert(folders).second && !OsUtils::sameFileSystem(folders.first, folders.second)) {
+            throw std::runtime_error("Error : --link=hardlink needs " + folders.first.generic_string(utf8) + " and "
+                                     + folders.second.generic_string(utf8) + " on the same file system : use --link=symlink instead");
+        }
+    }
+}
+
+bool BundleEngine::isSharedFile(const fs::path & filePath)
+{
+    boost::system::error_code ec;
+    if (fs::is_symlink(filePath, ec)) {
+        return true;
+    }
+    uintmax_t linkCount = fs::hard_link_count(filePath, ec);
+    return !ec && linkCount > 1;
+}
+
+bool BundleEngine::isLinked(const Entry & entry) const
+{
+    boost::system::error_code ec;
+    if (fs::is_symlink(entry.destinationPath, ec)) {
+        return fs::read_symlink(entry.destinationPath, ec) == fs::absolute(entry.sourcePath) && !ec;
+    }
+    return fs::equivalent(entry.sourcePath, entry.destinationPath, ec) && !ec;
+}
+
+void BundleEngine::run()
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    bool incremental = m_options.incrementalBundle();
+    fs::path destinationRoot = m_options.getDestinationRoot();
+    readDynamicInfos();
+    std::size_t unneededCount = m_options.bundleNeededOnly() ? removeUnneededEntries() : 0;
+    // linked files belong to the packages : they are never rewritten
+    if (m_linkMode == LinkMode::Copy) {
+        computeRunpaths();
+    }
+    if (!m_options.getBundleArchive().empty()) {
+        writeArchive(fs::absolute(fs::path(m_options.getBundleArchive(), utf8)));
+        return;
+    }
+    std::map<std::string, ManifestEntry> previousEntries;
+    if (incremental) {
+        previousEntries = loadManifest();
+    }
+    // destination folders are listed once instead of testing each destination file
+    std::set<fs::path> existingFiles;
+    std::set<fs::path> destinationFolders;
+    for (auto & entry : m_entries) {
+        destinationFolders.insert(entry.destinationPath.parent_path());
+    }
+    for (auto & folder : destinationFolders) {
+        fs::create_directories(folder);
+        for (fs::directory_entry & x : fs::directory_iterator(folder)) {
+            existingFiles.insert(x.path());
+        }
+    }
+    if (m_linkMode == LinkMode::Hardlink) {
+        checkHardLinks();
+    }
+
+    std::mutex errorsMutex;
+    std::vector<std::string> errors;
+    std::atomic<std::size_t> copiedCount = 0, linkedCount = 0, unchangedCount = 0, rewrittenCount = 0;
+    std::atomic<uint64_t> copiedBytes = 0, savedBytes = 0;
+    std::array<std::atomic<std::size_t>, 4> methodCounts{};
+    // an unchanged library has the same source, size and modification time as in the previous bundle
+    auto isUnchanged = [&](const Entry & entry) {
+        std::string relativePath = entry.destinationPath.lexically_relative(destinationRoot).generic_string(utf8);
+        auto it = previousEntries.find(relativePath);
+        boost::system::error_code ec;
+        return it != previousEntries.end() && existingFiles.count(entry.destinationPath) > 0
+                && it->second.sourcePath == entry.sourcePath.generic_string(utf8)
+                && it->second.size == entry.size && it->second.lastWriteTime == entry.lastWriteTime
+                && fs::file_size(entry.destinationPath, ec) == it->second.bundledSize && !ec;
+    };
+    // only called on files copied by this run : an existing file may share its content with a package file
+    auto rewriteRunpath = [&](Entry & entry) {
+        if (!entry.runpath.empty() && ElfUtils::setRunpath(entry.destinationPath, entry.runpath)) {
+            rewrittenCount++;
+        }
+        entry.bundledSize = fs::file_size(entry.destinationPath);
+    };
+    auto hasExpectedRunpath = [](const Entry & entry) {
+        ElfUtils::DynamicInfo info;
+        return entry.runpath.empty() || (ElfUtils::readDynamicInfo(entry.destinationPath, info) && info.runpath == entry.runpath && info.rpath.empty());
+    };
+    auto copyEntry = [&](Entry & entry) {
+        try {
+            if (entry.symlink) {
+                fs::path target = fs::read_symlink(entry.sourcePath);
+                if (incremental && fs::is_symlink(entry.destinationPath) && fs::read_symlink(entry.destinationPath) == target) {
+                    unchangedCount++;
+                    return;
+                }
+                if (fs::is_symlink(entry.destinationPath) || (incremental && fs::is_regular_file(entry.destinationPath))) {
+                    fs::remove(entry.destinationPath);
+                }
+                fs::copy_symlink(entry.sourcePath, entry.destinationPath);
+                copiedCount++;
+                return;
+            }
+            entry.size = fs::file_size(entry.sourcePath);
+            entry.bundledSize = entry.size;
+            entry.lastWriteTime = static_cast<int64_t>(fs::last_write_time(entry.sourcePath));
+            bool exists = existingFiles.count(entry.destinationPath) > 0;
+            bool linked = exists && isLinked(entry);
+            bool unchanged = false;
+            if (m_linkMode == LinkMode::Copy) {
+                // a link, left by a previous link mode bundle or pointing to any other file, is replaced with a copy
+                linked = linked || (exists && isSharedFile(entry.destinationPath));
+                unchanged = !linked && (incremental ? isUnchanged(entry) : (exists && !m_options.override())) && hasExpectedRunpath(entry);
+            }
+            else {
+                unchanged = linked && (fs::is_symlink(entry.destinationPath) == (m_linkMode == LinkMode::Symlink));
+            }
+            if (unchanged) {
+                unchangedCount++;
+                savedBytes += entry.size;
+                entry.bundledSize = fs::file_size(entry.destinationPath);
+                return;
+            }
+            if (exists && (linked || m_linkMode != LinkMode::Copy)) {
+                fs::remove(entry.destinationPath);
+            }
+            if (m_linkMode == LinkMode::Symlink) {
+                fs::create_symlink(fs::absolute(entry.sourcePath), entry.destinationPath);
+                linkedCount++;
+                return;
+            }
+            if (m_linkMode == LinkMode::Hardlink) {
+                fs::create_hard_link(entry.sourcePath, entry.destinationPath);
+                linkedCount++;
+                return;
+            }
+            methodCounts[static_cast<std::size_t>(OsUtils::copyFile(entry.sourcePath, entry.destinationPath))]++;
+            rewriteRunpath(entry);
+            copiedCount++;
+            copiedBytes += entry.size;
+        }
+        catch (const std::exception & e) {
+            std::lock_guard<std::mutex> lock(errorsMutex);
+            errors.push_back(e.what());
+        }
+    };
+    {
+        boost::asio::thread_pool pool(HashUtils::defaultJobs());
+        for (auto & entry : m_entries) {
+            if (!entry.symlink) {
+                boost::asio::post(pool, [&]() { copyEntry(entry); });
+            }
+        }
+        pool.join();
+    }
+    for (auto & entry : m_entries) {
+        if (entry.symlink) {
+            copyEntry(entry);
+        }
+    }
+    std::size_t removedCount = incremental ? removeObsoleteFiles(previousEntries) : 0;
+    writeManifest();
+    std::ostringstream summary;
+    summary<<"===> bundle : "<<copiedCount<<" files copied ("<<copiedBytes<<" bytes), ";
+    if (m_linkMode != LinkMode::Copy) {
+        summary<<linkedCount<<" "<<m_options.getBundleLinkMode()<<"s created, ";
+    }
+    summary<<unchangedCount<<" unchanged ("<<savedBytes<<" bytes saved)";
+    if (m_options.bundleNeededOnly()) {
+        summary<<", "<<unneededCount<<" unneeded files skipped";
+    }
+    if (rewrittenCount > 0) {
+        summary<<", "<<rewrittenCount<<" runpaths rewritten";
+    }
+    std::string separator = " - ";
+    for (std::size_t method = 0; method < methodCounts.size(); method++) {
+        if (methodCounts[method] > 0) {
+            summary<<separator<<OsUtils::copyMethodName(static_cast<OsUtils::CopyMethod>(method))<<": "<<methodCounts[method];
+            separator = ", ";
+        }
+    }
+    if (incremental) {
+        summary<<", "<<removedCount<<" obsolete files removed";
+        std::cout<<summary.str()<<std::endl;
+    }
+    else {
+        m_options.verboseMessage(summary.str());
+    }
+    if (!errors.empty()) {
+        throw std::runtime_error("Error : bundle copy failed (" + std::to_string(errors.size()) + " errors) : " + errors.front());
+    }
+}
+
+void BundleEngine::writeArchive(const fs::path & archivePath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path destinationRoot = m_options.getDestinationRoot();
+    // archive entry name -> archived file and the patches applied to its content
+    std::map<std::string, std::pair<fs::path, ElfUtils::Patches>> archivedFiles;
+    // files written by the bundle commands in the destination folder (xpcf configuration, install scripts ...) :
+    // the files left by previous commands are not archived
+    boost::system::error_code ec;
+    if (fs::is_directory(destinationRoot, ec)) {
+        for (fs::recursive_directory_iterator it(destinationRoot), end; it != end; ++it) {
+            if (fs::is_directory(it->symlink_status()) || fs::equivalent(it->path(), archivePath, ec)) {
+                continue;
+            }
+            auto previousFile = m_previousDestinationFiles.find(it->path());
+            if (previousFile == m_previousDestinationFiles.end() || previousFile->second != destinationFileState(it->path())) {
+                archivedFiles[it->path().lexically_relative(destinationRoot).generic_string(utf8)] = {it->path(), {}};
+            }
+        }
+    }
+
+    // libraries are archived from their source : rewritten runpaths are patched while the files are archived
+    std::mutex archiveMutex;
+    std::vector<std::string> errors;
+    std::atomic<std::size_t> rewrittenCount = 0;
+    auto prepareEntry = [&](Entry & entry) {
+        try {
+            std::string entryName = entry.destinationPath.lexically_relative(destinationRoot).generic_string(utf8);
+            ElfUtils::Patches patches;
+            if (!entry.symlink) {
+                entry.size = fs::file_size(entry.sourcePath);
+                entry.lastWriteTime = static_cast<int64_t>(fs::last_write_time(entry.sourcePath));
+                entry.bundledSize = entry.size;
+                if (!entry.runpath.empty() && ElfUtils::runpathPatches(entry.sourcePath, entry.runpath, patches)) {
+                    rewrittenCount++;
+                    entry.bundledSize = ElfUtils::patchedSize(entry.size, patches);
+                }
+            }
+            std::lock_guard<std::mutex> lock(archiveMutex);
+            archivedFiles[entryName] = {entry.sourcePath, std::move(patches)};
+        }
+        catch (const std::exception & e) {
+            std::lock_guard<std::mutex> lock(archiveMutex);
+            errors.push_back(e.what());
+        }
+    };
+    {
+        boost::asio::thread_pool pool(HashUtils::defaultJobs());
+        for (auto & entry : m_entries) {
+            boost::asio::post(pool, [&]() { prepareEntry(entry); });
+        }
+        pool.join();
+    }
+    if (!errors.empty()) {
+        throw std::runtime_error("Error : bundle archive failed (" + std::to_string(errors.size()) + " errors) : " + errors.front());
+    }
+    writeManifest();
+    archivedFiles[Constants::BUNDLE_MANIFEST_FILE] = {destinationRoot / Constants::BUNDLE_MANIFEST_FILE, {}};
+
+    if (boost::ends_with(archivePath.filename().generic_string(utf8), ".zip")) {
+        ZipWriter writer;
+        for (auto & [entryName, file] : archivedFiles) {
+            writer.addFile(entryName, file.first, file.second);
+        }
+        writer.write(archivePath);
+    }
+    else {
+        TarWriter writer;
+        for (auto & [entryName, file] : archivedFiles) {
+            writer.addFile(entryName, file.first, file.second);
+        }
+        writer.write(archivePath);
+    }
+    std::cout<<"===> bundle : "<<archivedFiles.size()<<" files archived in "<<archivePath.generic_string(utf8)
+             <<", "<<rewrittenCount<<" runpaths rewritten"<<std::endl;
+}
+
+std::map<std::string, BundleEngine::ManifestEntry> BundleEngine::loadManifest() const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::map<std::string, ManifestEntry> entries;
+    std::ifstream fis((m_options.getDestinationRoot() / Constants::BUNDLE_MANIFEST_FILE).generic_string(utf8), std::ios::in);
+    std::string line;
+    if (!std::getline(fis, line) || line != BUNDLE_MANIFEST_HEADER) {
+        return entries;
+    }
+    while (std::getline(fis, line)) {
+        // relative path|origin|source path|size|modification time|bundled size
+        std::vector<std::string> fields;
+        boost::split(fields, line, [](char c){return c == '|';});
+        if (fields.size() < 6) {
+            continue;
+        }
+        try {
+            ManifestEntry entry;
+            entry.size = std::stoull(fields[fields.size() - 3]);
+            entry.lastWriteTime = std::stoll(fields[fields.size() - 2]);
+            entry.bundledSize = std::stoull(fields[fields.size() - 1]);
+            entry.sourcePath = boost::join(std::vector<std::string>(fields.begin() + 2, fields.end() - 3), "|");
+            entries[fields[0]] = entry;
+        }
+        catch (const std::exception &) {
+            continue;
+        }
+    }
+    return entries;
+}
+
+std::size_t BundleEngine::removeObsoleteFiles(const std::map<std::string, ManifestEntry> & previousEntries) const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path destinationRoot = m_options.getDestinationRoot();
+    std::set<std::string> bundledFiles;
+    for (auto & entry : m_entries) {
+        bundledFiles.insert(entry.destinationPath.lexically_relative(destinationRoot).generic_string(utf8));
+    }
+    std::size_t removedCount = 0;
+    for (auto & [relativePath, entry] : previousEntries) {
+        fs::path filePath = destinationRoot / fs::path(relativePath, utf8);
+        boost::system::error_code ec;
+        if (bundledFiles.count(relativePath) == 0 && !fs::is_directory(filePath, ec) && fs::remove(filePath, ec)) {
+            m_options.verboseMessage("===> removing obsolete " + filePath.generic_string(utf8));
+            removedCount++;
+        }
+    }
+    return removedCount;
+}
+
+void BundleEngine::writeManifest() const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path destinationRoot = m_options.getDestinationRoot();
+    std::vector<const Entry *> entries;
+    for (auto & entry : m_entries) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry * a, const Entry * b) {
+        return a->destinationPath < b->destinationPath;
+    });
+    // relative path|origin|source path|size|modification time|bundled size
+    std::ostringstream manifest;
+    manifest << BUNDLE_MANIFEST_HEADER << std::endl;
+    for (auto & entry : entries) {
+        manifest << entry->destinationPath.lexically_relative(destinationRoot).generic_string(utf8) << "|" << entry->origin
+                 << "|" << entry->sourcePath.generic_string(utf8) << "|" << entry->size << "|" << entry->lastWriteTime << "|" << entry->bundledSize << std::endl;
+    }
+    OsUtils::writeFileIfChanged(destinationRoot / Constants::BUNDLE_MANIFEST_FILE, manifest.str());
+}
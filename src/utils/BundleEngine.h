@@ -0,0 +1,131 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief resolves then copies the files of a bundle
+ * @date 2026-10-19
+ */
+
+#ifndef BUNDLEENGINE_H
+#define BUNDLEENGINE_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "CmdOptions.h"
+#include "ElfUtils.h"
+
+namespace fs = boost::filesystem;
+
+// Collects the libraries bundled by the bundle commands, then copies them at once.
+// The bundle command passes its engine down to the file retrievers and system tools, which add the libraries to it instead of copying them :
+// - a source folder is only walked once
+// - each destination file is copied once : the first source wins, as with sequential copies
+// - another version of a library whose SONAME is already provided by a bundled file is skipped
+// - the libraries ELF dynamic sections are read on a thread pool, files are copied on a thread pool, then symbolic links are recreated
+// run() also writes the bundle manifest (each bundled file with its origin package, size and modification time) in the destination root folder.
+// In incremental mode, the previous manifest is used to only copy the changed libraries and to remove the obsolete ones.
+// In link mode, libraries are symbolic or hard links to the source files instead of copies (local test deployments).
+// In needed only mode, only the libraries reached from the targets through their DT_NEEDED entries are bundled.
+// The DT_RUNPATH of copied ELF files is rewritten to the $ORIGIN relative folders of their bundled needed libraries.
+// In archive mode, the files are written in a tar.gz or zip archive instead of being copied to the destination folder.
+class BundleEngine
+{
+public:
+    BundleEngine(const CmdOptions & options);
+    BundleEngine(const BundleEngine &) = delete;
+    BundleEngine & operator=(const BundleEngine &) = delete;
+
+    // origin (package, module ...) of the libraries added next
+    void setOrigin(const std::string & origin) { m_origin = origin; }
+    void addLibraries(const fs::path & sourceFolder, const fs::path & destinationFolder, const std::string_view & suffix);
+    // shared libraries of sourceFolder, bundled in the destination root folder (or its modules subfolder for xpcf bundles)
+    void addSharedLibraries(const fs::path & sourceFolder);
+    // executable or library whose needed libraries are bundled in needed only mode (a bundled library is also bundled)
+    void addTarget(const fs::path & filePath);
+    // throws std::runtime_error when a file can't be copied
+    void run();
+
+private:
+    enum class LinkMode {
+        Copy,
+        Symlink,
+        Hardlink
+    };
+
+    typedef struct {
+        fs::path sourcePath;
+        fs::path destinationPath;
+        std::string origin;
+        bool symlink;
+        // source file state, filled when the file is copied
+        uint64_t size;
+        int64_t lastWriteTime;
+        // bundled file size : the runpath rewriting can grow the file
+        uint64_t bundledSize;
+        // ELF dynamic section of a library
+        ElfUtils::DynamicInfo dynamicInfo;
+        // $ORIGIN relative folders of the bundled needed libraries, written in the bundled file
+        std::string runpath;
+    } Entry;
+
+    typedef struct {
+        std::string sourcePath;
+        uint64_t size;
+        int64_t lastWriteTime;
+        uint64_t bundledSize;
+    } ManifestEntry;
+
+    void addLibrary(const fs::path & sourcePath, const fs::path & destinationFolder);
+    // reads the ELF dynamic sections of the libraries in parallel, then skips the SONAME conflicts
+    void readDynamicInfos();
+    // needed name (file name or SONAME) -> indices of the entries providing it
+    std::multimap<std::string, std::size_t> neededProviders() const;
+    void computeRunpaths();
+    // archives the bundled files with the files already written in the destination folder
+    void writeArchive(const fs::path & archivePath);
+    // removes the entries that are not reached from the targets : returns the removed entries count
+    std::size_t removeUnneededEntries();
+    // throws std::runtime_error when a hard link can't be created from a source folder to its destination folder
+    void checkHardLinks() const;
+    // true when the destination file is a link to the source file
+    bool isLinked(const Entry & entry) const;
+    // true when filePath is a symbolic link or has several hard links : writing it would modify another file
+    static bool isSharedFile(const fs::path & filePath);
+    // relative destination path -> entry of the previous bundle
+    std::map<std::string, ManifestEntry> loadManifest() const;
+    void writeManifest() const;
+    // removes the files of the previous bundle that are no longer bundled : returns the removed files count
+    std::size_t removeObsoleteFiles(const std::map<std::string, ManifestEntry> & previousEntries) const;
+
+    std::vector<Entry> m_entries;
+    // destination path -> index in m_entries
+    std::map<fs::path, std::size_t> m_destinations;
+    std::set<std::string> m_walkedFolders;
+    std::vector<fs::path> m_targets;
+    std::string m_origin;
+    // destination files and their state when the engine was created, in archive mode : files left by previous commands are not archived
+    std::map<fs::path, std::string> m_previousDestinationFiles;
+    LinkMode m_linkMode = LinkMode::Copy;
+    const CmdOptions & m_options;
+};
+
+#endif // BUNDLEENGINE_H
@@ -1,10 +1,14 @@
 #include "DepUtils.h"
+#include "DependencyFileCache.h"
 #include "OsUtils.h"
 #include "Constants.h"
 #include "FileHandlerFactory.h"
+#include "HashUtils.h"
 #include "retrievers/HttpFileRetriever.h"
 #include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
 #include <regex>
 #include <boost/algorithm/string.hpp>
 
@@ -81,30 +85,6 @@ fs::path DepUtils::getProjectBuildSubFolder(const CmdOptions & options)
     return targetPath;
 }
 
-std::vector<Dependency> removeRedundantDependencies(const std::multimap<std::string,Dependency> & dependencies)
-{
-    std::multimap<std::string,std::pair<std::size_t,Dependency>> dependencyMap;
-    std::vector<Dependency> depVector;
-    for (auto const & node : dependencies) {
-        if (!node.second.isSystemDependency()) {
-            depVector.push_back(std::move(node.second));
-        }
-        else {// System dependency
-            if (dependencies.count(node.first) == 1) {
-                // only one system dependency was found : generic or dedicated tool dependency is added to the dependencies vector
-                depVector.push_back(std::move(node.second));
-            }
-            else {
-                if (node.second.isSpecificSystemToolDependency()) {
-                    // there must be one dedicated tool when the dependency appears twice : add only the dedicated dependency
-                    depVector.push_back(std::move(node.second));
-                }
-            }
-        }
-    }
-    return depVector;
-}
-
 std::vector<Dependency> DepUtils::filterConditionDependencies(const std::map<std::string,bool> & conditions, const std::vector<Dependency> & depCollection)
 {
     std::vector<Dependency> filteredDepCollection;
@@ -138,70 +118,27 @@ std::vector<Dependency> DepUtils::filterConditionDependencies(const std::map<std
 
 std::vector<Dependency> DepUtils::parse(const fs::path &  dependenciesPath, const std::string & linkMode)
 {
-    std::multimap<std::string,Dependency> libraries;
-    if (fs::exists(dependenciesPath)) {
-        ifstream fis(dependenciesPath.generic_string(),ios::in);
-        while (!fis.eof()) {
-            string curStr;
-            getline(fis,curStr);
-            if (!curStr.empty()) {
-                std::string commentRegexStr = "^[ \t]*//";
-                std::regex commentRegex(commentRegexStr, std::regex_constants::extended);
-                std::smatch sm;
-                // parsing finds commented lines
-                if (!std::regex_search(curStr, sm, commentRegex, std::regex_constants::match_any)) {
-                    // checks that the dependency respects the format
-                    std::vector<std::string> results;
-                    boost::split(results, curStr, [](char c){return c == '|';});
-                    if (results.size() >=4) {
-                        // Dependency line is not commented: parsing the dependency
-                        Dependency dep(curStr, linkMode);
-
-                        if (!dep.validate()) {
-                            throw std::runtime_error("Error parsing dependency file : invalid format ");
-                        }
-
-                        if (dep.isGenericSystemDependency()
-                                ||dep.isSpecificSystemToolDependency()
-                                ||!dep.isSystemDependency()) {
-                            // only add "generic" system or tool@system or other deps
-                            bool bFoundSame = false;
-                            if (libraries.find(dep.getName()) != libraries.end()) {
-                                auto range =  libraries.equal_range(dep.getName());
-                                for (auto i = range.first; i != range.second; ++i) {
-                                    if (i->second == dep) {
-                                        bFoundSame = true;
-                                    }
-                                }
-                            }
-                            if (!bFoundSame) {
-                                libraries.insert(std::make_pair(dep.getName(), std::move(dep)));
-                            }
-                        }
-                    }
-                    else {
-                        std::cout<<"[IGNORED]: Dependency line '"<<curStr<<"' with invalid format !"<<std::endl;
-                    }
-                }
-                else {
-                    std::cout<<"[IGNORED]: Dependency line '"<<curStr<<"' is commented !"<<std::endl;
-                }
-            }
-        }
-        fis.close();
-    }
-    return removeRedundantDependencies(libraries);
+    return DependencyFileCache::parse(dependenciesPath, linkMode);
 }
 
-void DepUtils::parseRecurse(const fs::path &  dependenciesPath, const CmdOptions & options, std::vector<Dependency> & deps)
+void DepUtils::parseRecurse(const fs::path &  dependenciesPath, const CmdOptions & options, std::vector<Dependency> & deps, std::vector<fs::path> * inputFiles,
+                            std::set<std::string> * visitedFiles)
 {
     fs::detail::utf8_codecvt_facet utf8;
+    if (visitedFiles != nullptr && !visitedFiles->insert(fs::absolute(dependenciesPath).lexically_normal().generic_string(utf8)).second) {
+        return;
+    }
+    if (inputFiles != nullptr) {
+        std::string filePrefix = dependenciesPath.stem().generic_string(utf8);
+        inputFiles->push_back(fs::absolute(dependenciesPath.parent_path() / (filePrefix + ".txt")));
+        inputFiles->push_back(fs::absolute(dependenciesPath.parent_path() / (filePrefix + "-" + options.getOS() + ".txt")));
+    }
     std::vector<fs::path> dependenciesFileList = getChildrenDependencies(dependenciesPath.parent_path(), options.getOS(), dependenciesPath.stem().generic_string(utf8));
     for (fs::path & depsFile : dependenciesFileList) {
         if (fs::exists(depsFile)) {
             std::vector<Dependency> dependencies = parse(depsFile, options.getMode());
             deps.insert(std::end(deps), std::begin(dependencies), std::end(dependencies));
-            for (auto dep : dependencies) {
+            for (const auto & dep : dependencies) {
                 if (!dep.validate()) {
                     throw std::runtime_error("Error parsing dependency file : invalid format ");
                 }
@@ -209,16 +146,56 @@ void DepUtils::parseRecurse(const fs::path &  dependenciesPath, const CmdOptions
                 shared_ptr<IFileRetriever> fileRetriever = FileHandlerFactory::instance()->getFileHandler(dep, options);
                 fs::path outputDirectory = fileRetriever->computeLocalDependencyRootDir(dep);
                 if (dep.getMode()== "shared") {
-                    parseRecurse(outputDirectory/"packagedependencies.txt", options,deps);
+                    parseRecurse(outputDirectory/"packagedependencies.txt", options, deps, inputFiles, visitedFiles);
                 }
                 else {
-                    parseRecurse(outputDirectory/"packagedependencies-static.txt", options,deps);
+                    parseRecurse(outputDirectory/"packagedependencies-static.txt", options, deps, inputFiles, visitedFiles);
                 }
             }
         }
     }
 }
 
+void DepUtils::parseRecurse(const std::vector<fs::path> & dependenciesPaths, const CmdOptions & options, std::vector<Dependency> & deps, std::vector<fs::path> * inputFiles)
+{
+    // each file has its own results : the merge order doesn't depend on the walks durations
+    std::vector<std::vector<Dependency>> filesDeps(dependenciesPaths.size());
+    std::vector<std::vector<fs::path>> filesInputs(dependenciesPaths.size());
+    std::vector<std::string> errors(dependenciesPaths.size());
+    {
+        boost::asio::thread_pool pool(HashUtils::defaultJobs());
+        for (std::size_t i = 0; i < dependenciesPaths.size(); i++) {
+            boost::asio::post(pool, [&, i]() {
+                try {
+                    // the subgraphs shared inside a walk are only parsed once
+                    std::set<std::string> visitedFiles;
+                    parseRecurse(dependenciesPaths[i], options, filesDeps[i], inputFiles != nullptr ? &filesInputs[i] : nullptr, &visitedFiles);
+                }
+                catch (const std::exception & e) {
+                    errors[i] = e.what();
+                }
+            });
+        }
+        pool.join();
+    }
+    for (auto & error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+    std::set<std::string> mergedDeps;
+    for (std::size_t i = 0; i < dependenciesPaths.size(); i++) {
+        for (auto & dep : filesDeps[i]) {
+            if (mergedDeps.insert(dep.toString()).second) {
+                deps.push_back(dep);
+            }
+        }
+        if (inputFiles != nullptr) {
+            inputFiles->insert(std::end(*inputFiles), std::begin(filesInputs[i]), std::end(filesInputs[i]));
+        }
+    }
+}
+
 std::vector<fs::path> DepUtils::getChildrenDependencies(const fs::path &  outputDirectory, const std::string & osPlatform, const std::string & filePrefix)
 {
     auto platformFiles = list<std::string>{filePrefix + ".txt"};
@@ -257,7 +234,7 @@ void DepUtils::readInfos(const fs::path &  dependenciesFile, const CmdOptions &
     for (fs::path depsFile : dependenciesFileList) {
         if (fs::exists(depsFile)) {
             std::vector<Dependency> dependencies = DepUtils::parse(depsFile, options.getMode());
-            for (auto dep : dependencies) {
+            for (const auto & dep : dependencies) {
                 if (!dep.validate()) {
                     throw std::runtime_error("Error parsing dependency file : invalid format ");
                     indentLevel --;
@@ -283,10 +260,7 @@ fs::path DepUtils::downloadFile(const CmdOptions & options, const std::string &
     if (!fs::exists(outputDirectory)) {
         fs::create_directories(outputDirectory);
     }
-    bool result = fs::copy_file(compressedDependency,outputDirectory/name,fs::copy_option::overwrite_if_exists);
-    if (!result) {
-        throw std::runtime_error("Error copying file " + source);
-    }
+    OsUtils::copyFile(compressedDependency, outputDirectory/name);
     fs::remove(compressedDependency);
     return outputDirectory/name;
 }
@@ -23,6 +23,7 @@
 #ifndef DEPUTILS_H
 #define DEPUTILS_H
 
+#include <set>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -47,7 +48,12 @@ public:
     static std::vector<fs::path> getChildrenDependencies(const fs::path & outputDirectory, const std::string & osPlatform, const std::string & filePrefix = "packagedependencies");
     static std::vector<Dependency> parse(const fs::path & dependenciesPath, const std::string & linkMode);
     // parseRecurse appends found dependencies to the deps vector - even duplicates.
-    static void parseRecurse(const fs::path & dependenciesPath, const CmdOptions & options, std::vector<Dependency> & deps);
+    // when inputFiles is provided, every candidate dependencies file path (found or not) is appended to it
+    // when visitedFiles is provided, a dependencies file already walked is skipped with its children
+    static void parseRecurse(const fs::path & dependenciesPath, const CmdOptions & options, std::vector<Dependency> & deps, std::vector<fs::path> * inputFiles = nullptr,
+                             std::set<std::string> * visitedFiles = nullptr);
+    // walks the dependencies files on a thread pool : the found dependencies are merged in files order without duplicates
+    static void parseRecurse(const std::vector<fs::path> & dependenciesPaths, const CmdOptions & options, std::vector<Dependency> & deps, std::vector<fs::path> * inputFiles = nullptr);
     static void readInfos(const fs::path &  dependenciesFile, const CmdOptions & options, uint32_t indentLevel = 0);
     static std::vector<Dependency> filterConditionDependencies(const std::map<std::string,bool> & conditions, const std::vector<Dependency> & depCollection);
     static fs::path downloadFile(const CmdOptions & options, const std::string & source, const fs::path & outputDirectory, const std::string & name = "");
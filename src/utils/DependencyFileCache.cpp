@@ -0,0 +1,220 @@
+#include "DependencyFileCache.h"
+#include "DependencyFileParser.h"
+#include "HashUtils.h"
+#include "MappedFile.h"
+#include "OsUtils.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "tools/SystemTools.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/log/trivial.hpp>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+fs::path DependencyFileCache::m_cacheFolder;
+
+namespace {
+
+// "RMKDEPS2" : also detects entries written with another endianness
+constexpr uint64_t CACHE_ENTRY_MAGIC = 0x524d4b4445505332ULL;
+
+template <typename T>
+void writeValue(std::string & buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void writeString(std::string & buffer, const std::string_view & str)
+{
+    writeValue<uint32_t>(buffer, static_cast<uint32_t>(str.size()));
+    buffer.append(str.data(), str.size());
+}
+
+// bounds checked reader over a cache entry : strings are views on the entry content
+class EntryReader {
+public:
+    EntryReader(const std::string_view & content):m_content(content) {}
+
+    template <typename T>
+    T readValue()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view readString()
+    {
+        return take(readValue<uint32_t>());
+    }
+
+private:
+    std::string_view take(std::size_t size)
+    {
+        if (size > m_content.size() - m_offset) {
+            throw std::runtime_error("truncated dependency cache entry");
+        }
+        std::string_view data = m_content.substr(m_offset, size);
+        m_offset += size;
+        return data;
+    }
+
+    std::string_view m_content;
+    std::size_t m_offset = 0;
+};
+
+void writeDependency(std::string & buffer, const Dependency & dependency)
+{
+    Dependency::Fields fields = dependency.fields();
+    for (auto & field : {fields.packageName, fields.channel, fields.name, fields.version, fields.baseRepository,
+                         fields.identifier, fields.repositoryType, fields.mode, fields.toolOptions}) {
+        writeString(buffer, field);
+    }
+    writeValue<uint32_t>(buffer, static_cast<uint32_t>(fields.conditions.size()));
+    for (auto & condition : fields.conditions) {
+        writeString(buffer, condition);
+    }
+    writeValue<uint8_t>(buffer, static_cast<uint8_t>(fields.type));
+    writeValue<uint8_t>(buffer, fields.hasIdentifier ? 1 : 0);
+}
+
+// the fields are views on the entry content : Dependency interns them without tokenizing the source line again
+Dependency readDependency(EntryReader & reader, Dependency::Fields & fields)
+{
+    for (auto field : {&fields.packageName, &fields.channel, &fields.name, &fields.version, &fields.baseRepository,
+                       &fields.identifier, &fields.repositoryType, &fields.mode, &fields.toolOptions}) {
+        *field = reader.readString();
+    }
+    fields.conditions.resize(reader.readValue<uint32_t>());
+    for (auto & condition : fields.conditions) {
+        condition = reader.readString();
+    }
+    uint8_t type = reader.readValue<uint8_t>();
+    if (type > static_cast<uint8_t>(Dependency::Type::SYSTEM)) {
+        throw std::runtime_error("invalid dependency type in dependency cache entry");
+    }
+    fields.type = static_cast<Dependency::Type>(type);
+    fields.hasIdentifier = reader.readValue<uint8_t>() != 0;
+    return Dependency(fields);
+}
+
+}
+
+void DependencyFileCache::setCacheFolder(const fs::path & cacheFolder)
+{
+    m_cacheFolder = cacheFolder;
+}
+
+std::vector<Dependency> DependencyFileCache::parse(const fs::path & dependenciesPath, const std::string & linkMode)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    Trace::Span span("parse", dependenciesPath.filename().generic_string(utf8));
+    span.setArg("file", dependenciesPath.generic_string(utf8));
+    if (m_cacheFolder.empty() || !fs::is_regular_file(dependenciesPath, ec)) {
+        span.setArg("cache", "none");
+        return DependencyFileParser::parse(dependenciesPath, linkMode);
+    }
+    uint64_t size = fs::file_size(dependenciesPath, ec);
+    int64_t lastWriteTime = static_cast<int64_t>(fs::last_write_time(dependenciesPath, ec));
+    if (ec) {
+        span.setArg("cache", "none");
+        return DependencyFileParser::parse(dependenciesPath, linkMode);
+    }
+    // parsing depends on the link mode and on the system tool (system dependencies filtering)
+    static const std::string toolIdentifier = SystemTools::getToolIdentifier();
+    std::string dependenciesPathStr = fs::absolute(dependenciesPath).lexically_normal().generic_string(utf8);
+    std::string entryKey = dependenciesPathStr + "|" + linkMode + "|" + toolIdentifier;
+    std::ostringstream entryName;
+    entryName<<std::hex<<std::setw(16)<<std::setfill('0')<<HashUtils::fnv1a(entryKey)<<".bin";
+    fs::path entryPath = m_cacheFolder / entryName.str();
+
+    std::vector<Dependency> dependencies;
+    try {
+        if (load(entryPath, entryKey, size, lastWriteTime, dependenciesPath, dependencies)) {
+            span.setArg("cache", "hit");
+            Stats::addCacheLookup("dependency files", true);
+            return dependencies;
+        }
+    }
+    catch (const std::runtime_error & e) {
+        BOOST_LOG_TRIVIAL(debug)<<"Ignoring dependency cache entry "<<entryPath.generic_string(utf8)<<" : "<<e.what();
+    }
+
+    span.setArg("cache", "miss");
+    Stats::addCacheLookup("dependency files", false);
+    MappedFile file(dependenciesPath);
+    dependencies = DependencyFileParser::parse(file.content(), linkMode, dependenciesPathStr);
+    try {
+        store(entryPath, entryKey, size, lastWriteTime, HashUtils::fnv1a(file.content()), dependencies);
+    }
+    catch (const std::exception & e) {
+        BOOST_LOG_TRIVIAL(warning)<<"Unable to write dependency cache entry "<<entryPath.generic_string(utf8)<<" : "<<e.what();
+    }
+    return dependencies;
+}
+
+bool DependencyFileCache::load(const fs::path & entryPath, const std::string & entryKey, uint64_t size, int64_t lastWriteTime,
+                               const fs::path & dependenciesPath, std::vector<Dependency> & dependencies)
+{
+    boost::system::error_code ec;
+    if (!fs::is_regular_file(entryPath, ec)) {
+        return false;
+    }
+    uint64_t contentHash = 0;
+    {
+        MappedFile entry(entryPath);
+        EntryReader reader(entry.content());
+        if (reader.readValue<uint64_t>() != CACHE_ENTRY_MAGIC) {
+            return false;
+        }
+        uint64_t entrySize = reader.readValue<uint64_t>();
+        int64_t entryLastWriteTime = reader.readValue<int64_t>();
+        int64_t entryCreationTime = reader.readValue<int64_t>();
+        contentHash = reader.readValue<uint64_t>();
+        if (reader.readString() != entryKey || entrySize != size) {
+            return false;
+        }
+        // modification times have a one second resolution : a file modified in the second the entry was written
+        // may have changed without a new modification time, its content is checked instead
+        bool refreshed = entryLastWriteTime != lastWriteTime || lastWriteTime + 1 >= entryCreationTime;
+        if (refreshed) {
+            MappedFile file(dependenciesPath);
+            if (HashUtils::fnv1a(file.content()) != contentHash) {
+                return false;
+            }
+        }
+        uint32_t dependencyCount = reader.readValue<uint32_t>();
+        dependencies.clear();
+        dependencies.reserve(dependencyCount);
+        Dependency::Fields fields;
+        for (uint32_t i = 0; i < dependencyCount; i++) {
+            dependencies.push_back(readDependency(reader, fields));
+        }
+        if (!refreshed) {
+            return true;
+        }
+    }
+    // same content with a new modification time : the entry is rewritten once the mapping is released
+    store(entryPath, entryKey, size, lastWriteTime, contentHash, dependencies);
+    return true;
+}
+
+void DependencyFileCache::store(const fs::path & entryPath, const std::string & entryKey, uint64_t size, int64_t lastWriteTime,
+                                uint64_t contentHash, const std::vector<Dependency> & dependencies)
+{
+    std::string buffer;
+    writeValue<uint64_t>(buffer, CACHE_ENTRY_MAGIC);
+    writeValue<uint64_t>(buffer, size);
+    writeValue<int64_t>(buffer, lastWriteTime);
+    writeValue<int64_t>(buffer, static_cast<int64_t>(std::time(nullptr)));
+    writeValue<uint64_t>(buffer, contentHash);
+    writeString(buffer, entryKey);
+    writeValue<uint32_t>(buffer, static_cast<uint32_t>(dependencies.size()));
+    for (auto & dependency : dependencies) {
+        writeDependency(buffer, dependency);
+    }
+    OsUtils::writeFileIfChanged(entryPath, buffer);
+}
@@ -0,0 +1,55 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief binary cache of parsed packagedependencies files
+ * @date 2026-10-19
+ */
+
+#ifndef DEPENDENCYFILECACHE_H
+#define DEPENDENCYFILECACHE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "Dependency.h"
+
+namespace fs = boost::filesystem;
+
+// Each parsed packagedependencies file is stored in one cache entry holding the fields of its dependencies.
+// An entry is valid while the source file size and modification time are unchanged,
+// or when its content hash is unchanged.
+class DependencyFileCache
+{
+public:
+    DependencyFileCache() = delete;
+    ~DependencyFileCache() = delete;
+    // enables the cache : entries are stored in cacheFolder
+    static void setCacheFolder(const fs::path & cacheFolder);
+    // same result as DependencyFileParser::parse(dependenciesPath, linkMode)
+    static std::vector<Dependency> parse(const fs::path & dependenciesPath, const std::string & linkMode);
+
+private:
+    static bool load(const fs::path & entryPath, const std::string & entryKey, uint64_t size, int64_t lastWriteTime,
+                     const fs::path & dependenciesPath, std::vector<Dependency> & dependencies);
+    static void store(const fs::path & entryPath, const std::string & entryKey, uint64_t size, int64_t lastWriteTime,
+                      uint64_t contentHash, const std::vector<Dependency> & dependencies);
+    static fs::path m_cacheFolder;
+};
+
+#endif // DEPENDENCYFILECACHE_H
@@ -0,0 +1,135 @@
+#include "DependencyFileParser.h"
+#include "MappedFile.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <iostream>
+#include <map>
+
+bool DependencyFileParser::isCommentLine(const std::string_view & line)
+{
+    std::size_t pos = line.find_first_not_of(" \t");
+    return pos != std::string_view::npos && line.compare(pos, 2, "//") == 0;
+}
+
+std::string_view DependencyFileParser::trim(const std::string_view & str)
+{
+    constexpr std::string_view spaces = " \t\n\v\f\r";
+    std::size_t first = str.find_first_not_of(spaces);
+    if (first == std::string_view::npos) {
+        return std::string_view();
+    }
+    std::size_t last = str.find_last_not_of(spaces);
+    return str.substr(first, last - first + 1);
+}
+
+void DependencyFileParser::split(const std::string_view & str, char separator, std::vector<std::string_view> & tokens)
+{
+    tokens.clear();
+    std::size_t start = 0;
+    std::size_t pos = str.find(separator);
+    while (pos != std::string_view::npos) {
+        tokens.push_back(str.substr(start, pos - start));
+        start = pos + 1;
+        pos = str.find(separator, start);
+    }
+    tokens.push_back(str.substr(start));
+}
+
+std::vector<Dependency> DependencyFileParser::parse(const std::string_view & content, const std::string & linkMode, const std::string & sourceName,
+                                                    std::vector<std::string_view> * dependencyLines)
+{
+    // dependencies in appearance order, indexed by name : the name map gives the former multimap order
+    std::vector<Dependency> dependencies;
+    std::vector<std::string_view> lines;
+    std::map<std::string, std::vector<std::size_t>, std::less<>> nameIndex;
+    std::vector<std::string_view> fields;
+    forEachLine(content, [&](std::size_t lineNumber, const std::string_view & line) {
+        if (line.empty()) {
+            return;
+        }
+        if (isCommentLine(line)) {
+            std::cout<<"[IGNORED]: Dependency line '"<<line<<"' is commented !"<<std::endl;
+            return;
+        }
+        split(line, '|', fields);
+        if (fields.size() < 4) {
+            std::cout<<"[IGNORED]: Dependency line '"<<line<<"' with invalid format at "<<sourceName<<":"<<lineNumber<<" !"<<std::endl;
+            return;
+        }
+        Dependency dep(fields, linkMode);
+        int invalidField = dep.invalidField();
+        if (invalidField >= 0) {
+            if (static_cast<std::size_t>(invalidField) >= fields.size()) {
+                // link mode inherited from the command line : the repository type rejects it
+                invalidField = 3;
+            }
+            // 1 based column of the rejected field first non blank character
+            std::string_view field = fields[invalidField];
+            std::size_t column = static_cast<std::size_t>(field.data() - line.data()) + 1;
+            std::size_t firstChar = field.find_first_not_of(" \t");
+            if (firstChar != std::string_view::npos) {
+                column += firstChar;
+            }
+            throw std::runtime_error("Error parsing dependency file : invalid format at " + sourceName + ":" + std::to_string(lineNumber) + ":" + std::to_string(column));
+        }
+        if (dep.isGenericSystemDependency()
+                ||dep.isSpecificSystemToolDependency()
+                ||!dep.isSystemDependency()) {
+            // only add "generic" system or tool@system or other deps
+            auto & indexes = nameIndex[dep.getName()];
+            for (auto index : indexes) {
+                if (dependencies[index] == dep) {
+                    return;
+                }
+            }
+            indexes.push_back(dependencies.size());
+            dependencies.push_back(std::move(dep));
+            lines.push_back(line);
+        }
+    });
+
+    std::vector<Dependency> depVector;
+    depVector.reserve(dependencies.size());
+    for (auto & [name, indexes] : nameIndex) {
+        for (auto index : indexes) {
+            Dependency & dep = dependencies[index];
+            // a system dependency found twice must have one dedicated tool : only the dedicated dependency is added
+            if (!dep.isSystemDependency() || indexes.size() == 1 || dep.isSpecificSystemToolDependency()) {
+                depVector.push_back(std::move(dep));
+                if (dependencyLines != nullptr) {
+                    dependencyLines->push_back(lines[index]);
+                }
+            }
+        }
+    }
+    return depVector;
+}
+
+std::vector<Dependency> DependencyFileParser::parse(const fs::path & dependenciesPath, const std::string & linkMode)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    if (!fs::exists(dependenciesPath)) {
+        return std::vector<Dependency>();
+    }
+    MappedFile file(dependenciesPath);
+    return parse(file.content(), linkMode, dependenciesPath.generic_string(utf8));
+}
+
+std::vector<std::string> DependencyFileParser::parsePackageList(const fs::path & filePath)
+{
+    std::vector<std::string> packages;
+    if (!fs::exists(filePath)) {
+        return packages;
+    }
+    MappedFile file(filePath);
+    forEachLine(file.content(), [&packages](std::size_t, const std::string_view & line) {
+        if (line.empty()) {
+            return;
+        }
+        if (isCommentLine(line)) {
+            std::cout<<"[IGNORED]: line '"<<line<<"' is commented !"<<std::endl;
+            return;
+        }
+        packages.push_back(std::string(trim(line)));
+    });
+    return packages;
+}
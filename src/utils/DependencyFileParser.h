@@ -0,0 +1,75 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief single pass dependency files tokenizer
+ * @date 2026-10-19
+ */
+
+#ifndef DEPENDENCYFILEPARSER_H
+#define DEPENDENCYFILEPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "Dependency.h"
+
+namespace fs = boost::filesystem;
+
+class DependencyFileParser
+{
+public:
+    DependencyFileParser() = delete;
+    ~DependencyFileParser() = delete;
+
+    // calls lineFunc(lineNumber, line) for each '\n' terminated line of content (same lines as std::getline).
+    // lineNumber starts at 1
+    template <typename LineFunc>
+    static void forEachLine(const std::string_view & content, LineFunc && lineFunc)
+    {
+        std::size_t lineNumber = 1;
+        std::size_t start = 0;
+        while (start < content.size()) {
+            std::size_t end = content.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = content.size();
+            }
+            lineFunc(lineNumber, content.substr(start, end - start));
+            start = end + 1;
+            lineNumber++;
+        }
+    }
+
+    // true when the line starts with "//" after spaces and tabs
+    static bool isCommentLine(const std::string_view & line);
+    // same semantic as boost::trim with the classic locale
+    static std::string_view trim(const std::string_view & str);
+    // same semantic as boost::split : empty tokens are kept. tokens is cleared first
+    static void split(const std::string_view & str, char separator, std::vector<std::string_view> & tokens);
+
+    // parses a packagedependencies file content : sourceName is only used in error messages.
+    // Returns the dependencies in the DepUtils::parse order (sorted by name, then by appearance).
+    // When dependencyLines is provided, it receives the source line of each returned dependency
+    static std::vector<Dependency> parse(const std::string_view & content, const std::string & linkMode, const std::string & sourceName,
+                                         std::vector<std::string_view> * dependencyLines = nullptr);
+    static std::vector<Dependency> parse(const fs::path & dependenciesPath, const std::string & linkMode);
+    // parses a package list file (one package name per line) such as packageignoreinstall.txt
+    static std::vector<std::string> parsePackageList(const fs::path & filePath);
+};
+
+#endif // DEPENDENCYFILEPARSER_H
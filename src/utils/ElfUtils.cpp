@@ -0,0 +1,589 @@
+#include "ElfUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t SHT_DYNAMIC_TYPE = 6;
+constexpr uint32_t PT_LOAD_TYPE = 1;
+constexpr uint32_t PT_DYNAMIC_TYPE = 2;
+constexpr uint32_t PT_PHDR_TYPE = 6;
+constexpr uint32_t PF_W_FLAG = 2;
+constexpr uint32_t PF_R_FLAG = 4;
+constexpr uint64_t DT_NULL_TAG = 0;
+constexpr uint64_t DT_NEEDED_TAG = 1;
+constexpr uint64_t DT_STRTAB_TAG = 5;
+constexpr uint64_t DT_STRSZ_TAG = 10;
+constexpr uint64_t DT_SONAME_TAG = 14;
+constexpr uint64_t DT_RPATH_TAG = 15;
+constexpr uint64_t DT_RUNPATH_TAG = 29;
+constexpr uint64_t MIN_PAGE_SIZE = 0x1000;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// ELF file accessor : handles 32/64 bits classes and both endiannesses
+class ElfReader {
+public:
+    ElfReader(const fs::path & filePath, bool writable = false);
+    bool valid() const { return m_valid; }
+    // writes are recorded in patches instead of being applied to the file
+    void recordWrites(ElfUtils::Patches & patches) { m_patches = &patches; }
+    bool readDynamicInfo(ElfUtils::DynamicInfo & info);
+    bool setRunpath(const std::string & runpath);
+
+private:
+    typedef struct {
+        uint32_t type;
+        uint64_t address;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+    } Section;
+
+    typedef struct {
+        uint32_t type;
+        uint32_t flags;
+        uint64_t offset;
+        uint64_t address;
+        uint64_t fileSize;
+        uint64_t memorySize;
+        uint64_t alignment;
+    } Segment;
+
+    typedef struct {
+        uint64_t tag;
+        uint64_t value;
+    } DynamicEntry;
+
+    uint64_t read(const std::vector<char> & buffer, std::size_t offset, std::size_t size) const;
+    void write(std::vector<char> & buffer, std::size_t offset, std::size_t size, uint64_t value) const;
+    bool readBlock(uint64_t offset, uint64_t size, std::vector<char> & buffer);
+    void writeBlock(uint64_t offset, const std::vector<char> & buffer);
+    bool readSection(uint32_t index, Section & section);
+    void writeSection(uint32_t index, const Section & section);
+    std::vector<Segment> readSegments();
+    std::vector<char> encodeSegment(const Segment & segment) const;
+    std::vector<DynamicEntry> readDynamicEntries(const Segment & dynamicSegment);
+    std::vector<char> encodeDynamicEntries(const std::vector<DynamicEntry> & entries) const;
+    // file offset of a loaded address
+    bool addressToOffset(const std::vector<Segment> & segments, uint64_t address, uint64_t & offset) const;
+    // moves the dynamic section and the dynamic string table to a new loaded segment appended to the file
+    void appendDynamicSegment(std::vector<Segment> & segments, std::vector<DynamicEntry> & entries,
+                              uint64_t stringTableOffset, const std::vector<char> & strings);
+
+    std::fstream m_stream;
+    ElfUtils::Patches * m_patches = nullptr;
+    bool m_valid = false;
+    bool m_is64 = false;
+    bool m_isLittleEndian = true;
+    uint64_t m_fileSize = 0;
+    uint64_t m_phOffset = 0;
+    uint32_t m_phEntrySize = 0;
+    uint32_t m_phNum = 0;
+    uint64_t m_shOffset = 0;
+    uint32_t m_shEntrySize = 0;
+    uint32_t m_shNum = 0;
+};
+
+ElfReader::ElfReader(const fs::path & filePath, bool writable)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    m_fileSize = fs::file_size(filePath, ec);
+    if (ec || m_fileSize < 64) {
+        return;
+    }
+    std::ios::openmode mode = std::ios::in | std::ios::binary;
+    if (writable) {
+        mode |= std::ios::out;
+    }
+    m_stream.open(filePath.string(utf8), mode);
+    std::vector<char> header;
+    if (!readBlock(0, 64, header)) {
+        return;
+    }
+    if (header[0] != 0x7f || header[1] != 'E' || header[2] != 'L' || header[3] != 'F') {
+        return;
+    }
+    m_is64 = (header[4] == 2);
+    m_isLittleEndian = (header[5] == 1);
+    if ((header[4] != 1 && header[4] != 2) || (header[5] != 1 && header[5] != 2)) {
+        return;
+    }
+    if (m_is64) {
+        m_phOffset = read(header, 0x20, 8);
+        m_shOffset = read(header, 0x28, 8);
+        m_phEntrySize = static_cast<uint32_t>(read(header, 0x36, 2));
+        m_phNum = static_cast<uint32_t>(read(header, 0x38, 2));
+        m_shEntrySize = static_cast<uint32_t>(read(header, 0x3A, 2));
+        m_shNum = static_cast<uint32_t>(read(header, 0x3C, 2));
+    }
+    else {
+        m_phOffset = read(header, 0x1C, 4);
+        m_shOffset = read(header, 0x20, 4);
+        m_phEntrySize = static_cast<uint32_t>(read(header, 0x2A, 2));
+        m_phNum = static_cast<uint32_t>(read(header, 0x2C, 2));
+        m_shEntrySize = static_cast<uint32_t>(read(header, 0x2E, 2));
+        m_shNum = static_cast<uint32_t>(read(header, 0x30, 2));
+    }
+    m_valid = true;
+}
+
+uint64_t ElfReader::read(const std::vector<char> & buffer, std::size_t offset, std::size_t size) const
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        std::size_t byteIndex = m_isLittleEndian ? (offset + size - 1 - i) : (offset + i);
+        value = (value << 8) | static_cast<unsigned char>(buffer[byteIndex]);
+    }
+    return value;
+}
+
+void ElfReader::write(std::vector<char> & buffer, std::size_t offset, std::size_t size, uint64_t value) const
+{
+    for (std::size_t i = 0; i < size; i++) {
+        std::size_t byteIndex = m_isLittleEndian ? (offset + i) : (offset + size - 1 - i);
+        buffer[byteIndex] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+bool ElfReader::readBlock(uint64_t offset, uint64_t size, std::vector<char> & buffer)
+{
+    if (offset > m_fileSize || size > m_fileSize - offset) {
+        return false;
+    }
+    buffer.resize(size);
+    m_stream.seekg(static_cast<std::streamoff>(offset));
+    m_stream.read(buffer.data(), static_cast<std::streamsize>(size));
+    return static_cast<uint64_t>(m_stream.gcount()) == size;
+}
+
+void ElfReader::writeBlock(uint64_t offset, const std::vector<char> & buffer)
+{
+    if (m_patches != nullptr) {
+        (*m_patches)[offset] = std::string(buffer.begin(), buffer.end());
+        m_fileSize = std::max(m_fileSize, offset + buffer.size());
+        return;
+    }
+    m_stream.seekp(static_cast<std::streamoff>(offset));
+    m_stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!m_stream) {
+        throw std::runtime_error("write error");
+    }
+    m_fileSize = std::max(m_fileSize, offset + buffer.size());
+}
+
+bool ElfReader::readSection(uint32_t index, Section & section)
+{
+    std::vector<char> buffer;
+    if (!readBlock(m_shOffset + static_cast<uint64_t>(index) * m_shEntrySize, m_shEntrySize, buffer)) {
+        return false;
+    }
+    section.type = static_cast<uint32_t>(read(buffer, 4, 4));
+    if (m_is64) {
+        section.address = read(buffer, 16, 8);
+        section.offset = read(buffer, 24, 8);
+        section.size = read(buffer, 32, 8);
+        section.link = static_cast<uint32_t>(read(buffer, 40, 4));
+    }
+    else {
+        section.address = read(buffer, 12, 4);
+        section.offset = read(buffer, 16, 4);
+        section.size = read(buffer, 20, 4);
+        section.link = static_cast<uint32_t>(read(buffer, 24, 4));
+    }
+    return true;
+}
+
+void ElfReader::writeSection(uint32_t index, const Section & section)
+{
+    // only the location of the section is updated
+    uint64_t sectionOffset = m_shOffset + static_cast<uint64_t>(index) * m_shEntrySize;
+    std::vector<char> buffer;
+    if (!readBlock(sectionOffset, m_shEntrySize, buffer)) {
+        throw std::runtime_error("invalid section header");
+    }
+    if (m_is64) {
+        write(buffer, 16, 8, section.address);
+        write(buffer, 24, 8, section.offset);
+        write(buffer, 32, 8, section.size);
+    }
+    else {
+        write(buffer, 12, 4, section.address);
+        write(buffer, 16, 4, section.offset);
+        write(buffer, 20, 4, section.size);
+    }
+    writeBlock(sectionOffset, buffer);
+}
+
+std::vector<ElfReader::Segment> ElfReader::readSegments()
+{
+    std::vector<Segment> segments;
+    std::vector<char> buffer;
+    if (m_phEntrySize < (m_is64 ? 56u : 32u) || !readBlock(m_phOffset, static_cast<uint64_t>(m_phNum) * m_phEntrySize, buffer)) {
+        return segments;
+    }
+    for (uint32_t index = 0; index < m_phNum; index++) {
+        std::size_t offset = static_cast<std::size_t>(index) * m_phEntrySize;
+        Segment segment;
+        segment.type = static_cast<uint32_t>(read(buffer, offset, 4));
+        if (m_is64) {
+            segment.flags = static_cast<uint32_t>(read(buffer, offset + 4, 4));
+            segment.offset = read(buffer, offset + 8, 8);
+            segment.address = read(buffer, offset + 16, 8);
+            segment.fileSize = read(buffer, offset + 32, 8);
+            segment.memorySize = read(buffer, offset + 40, 8);
+            segment.alignment = read(buffer, offset + 48, 8);
+        }
+        else {
+            segment.offset = read(buffer, offset + 4, 4);
+            segment.address = read(buffer, offset + 8, 4);
+            segment.fileSize = read(buffer, offset + 16, 4);
+            segment.memorySize = read(buffer, offset + 20, 4);
+            segment.flags = static_cast<uint32_t>(read(buffer, offset + 24, 4));
+            segment.alignment = read(buffer, offset + 28, 4);
+        }
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
+std::vector<char> ElfReader::encodeSegment(const Segment & segment) const
+{
+    std::vector<char> buffer(m_phEntrySize, 0);
+    write(buffer, 0, 4, segment.type);
+    if (m_is64) {
+        write(buffer, 4, 4, segment.flags);
+        write(buffer, 8, 8, segment.offset);
+        write(buffer, 16, 8, segment.address);
+        write(buffer, 24, 8, segment.address);
+        write(buffer, 32, 8, segment.fileSize);
+        write(buffer, 40, 8, segment.memorySize);
+        write(buffer, 48, 8, segment.alignment);
+    }
+    else {
+        write(buffer, 4, 4, segment.offset);
+        write(buffer, 8, 4, segment.address);
+        write(buffer, 12, 4, segment.address);
+        write(buffer, 16, 4, segment.fileSize);
+        write(buffer, 20, 4, segment.memorySize);
+        write(buffer, 24, 4, segment.flags);
+        write(buffer, 28, 4, segment.alignment);
+    }
+    return buffer;
+}
+
+std::vector<ElfReader::DynamicEntry> ElfReader::readDynamicEntries(const Segment & dynamicSegment)
+{
+    std::vector<DynamicEntry> entries;
+    std::vector<char> buffer;
+    if (!readBlock(dynamicSegment.offset, dynamicSegment.fileSize, buffer)) {
+        return entries;
+    }
+    std::size_t entrySize = m_is64 ? 16 : 8;
+    std::size_t fieldSize = m_is64 ? 8 : 4;
+    for (std::size_t offset = 0; offset + entrySize <= buffer.size(); offset += entrySize) {
+        DynamicEntry entry {read(buffer, offset, fieldSize), read(buffer, offset + fieldSize, fieldSize)};
+        if (entry.tag == DT_NULL_TAG) {
+            break;
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+std::vector<char> ElfReader::encodeDynamicEntries(const std::vector<DynamicEntry> & entries) const
+{
+    // the DT_NULL terminator is added
+    std::size_t fieldSize = m_is64 ? 8 : 4;
+    std::vector<char> buffer((entries.size() + 1) * 2 * fieldSize, 0);
+    for (std::size_t index = 0; index < entries.size(); index++) {
+        write(buffer, index * 2 * fieldSize, fieldSize, entries[index].tag);
+        write(buffer, (index * 2 + 1) * fieldSize, fieldSize, entries[index].value);
+    }
+    return buffer;
+}
+
+bool ElfReader::addressToOffset(const std::vector<Segment> & segments, uint64_t address, uint64_t & offset) const
+{
+    for (auto & segment : segments) {
+        if (segment.type == PT_LOAD_TYPE && address >= segment.address && address - segment.address < segment.fileSize) {
+            offset = segment.offset + address - segment.address;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ElfReader::readDynamicInfo(ElfUtils::DynamicInfo & info)
+{
+    if (!m_valid || m_shOffset == 0 || m_shNum == 0 || m_shEntrySize < (m_is64 ? 64u : 40u)) {
+        return false;
+    }
+    for (uint32_t index = 0; index < m_shNum; index++) {
+        Section dynamicSection;
+        if (!readSection(index, dynamicSection) || dynamicSection.type != SHT_DYNAMIC_TYPE) {
+            continue;
+        }
+        Section stringSection;
+        std::vector<char> dynamicBuffer, strings;
+        if (!readSection(dynamicSection.link, stringSection)
+                || !readBlock(dynamicSection.offset, dynamicSection.size, dynamicBuffer)
+                || !readBlock(stringSection.offset, stringSection.size, strings)) {
+            return false;
+        }
+        auto getString = [&strings](uint64_t offset) -> std::string {
+            if (offset >= strings.size()) {
+                return "";
+            }
+            return std::string(strings.data() + offset, strnlen(strings.data() + offset, strings.size() - offset));
+        };
+        std::size_t entrySize = m_is64 ? 16 : 8;
+        std::size_t fieldSize = m_is64 ? 8 : 4;
+        for (std::size_t offset = 0; offset + entrySize <= dynamicBuffer.size(); offset += entrySize) {
+            uint64_t tag = read(dynamicBuffer, offset, fieldSize);
+            uint64_t value = read(dynamicBuffer, offset + fieldSize, fieldSize);
+            if (tag == DT_NULL_TAG) {
+                break;
+            }
+            switch (tag) {
+            case DT_NEEDED_TAG: info.needed.push_back(getString(value));
+                break;
+            case DT_SONAME_TAG: info.soname = getString(value);
+                break;
+            case DT_RPATH_TAG: info.rpath = getString(value);
+                break;
+            case DT_RUNPATH_TAG: info.runpath = getString(value);
+                break;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool ElfReader::setRunpath(const std::string & runpath)
+{
+    // the runtime view (program headers) is patched : section headers are only kept consistent
+    std::vector<Segment> segments = m_valid ? readSegments() : std::vector<Segment>();
+    auto dynamicSegment = std::find_if(segments.begin(), segments.end(), [](const Segment & segment) { return segment.type == PT_DYNAMIC_TYPE; });
+    if (dynamicSegment == segments.end()) {
+        throw std::runtime_error("no dynamic segment");
+    }
+    std::vector<DynamicEntry> entries = readDynamicEntries(*dynamicSegment);
+    uint64_t stringTableAddress = 0, stringTableSize = 0;
+    for (auto & entry : entries) {
+        if (entry.tag == DT_STRTAB_TAG) {
+            stringTableAddress = entry.value;
+        }
+        else if (entry.tag == DT_STRSZ_TAG) {
+            stringTableSize = entry.value;
+        }
+    }
+    uint64_t stringTableOffset = 0;
+    std::vector<char> strings;
+    if (!addressToOffset(segments, stringTableAddress, stringTableOffset) || !readBlock(stringTableOffset, stringTableSize, strings)) {
+        throw std::runtime_error("invalid dynamic string table");
+    }
+    // DT_RPATH is ignored by the loader when DT_RUNPATH is present
+    auto pathEntry = std::find_if(entries.begin(), entries.end(), [](const DynamicEntry & entry) { return entry.tag == DT_RUNPATH_TAG; });
+    if (pathEntry == entries.end()) {
+        pathEntry = std::find_if(entries.begin(), entries.end(), [](const DynamicEntry & entry) { return entry.tag == DT_RPATH_TAG; });
+    }
+    if (pathEntry != entries.end() && pathEntry->value < strings.size()) {
+        std::size_t currentSize = strnlen(strings.data() + pathEntry->value, strings.size() - pathEntry->value);
+        std::string currentPath(strings.data() + pathEntry->value, currentSize);
+        if (currentPath == runpath && pathEntry->tag == DT_RUNPATH_TAG) {
+            return false;
+        }
+        if (runpath.size() <= currentSize) {
+            // the new path fits in the current string : both are rewritten in place
+            std::vector<char> pathBuffer(currentSize, 0);
+            std::copy(runpath.begin(), runpath.end(), pathBuffer.begin());
+            writeBlock(stringTableOffset + pathEntry->value, pathBuffer);
+            pathEntry->tag = DT_RUNPATH_TAG;
+            std::vector<char> dynamicBuffer = encodeDynamicEntries(entries);
+            dynamicBuffer.resize(std::min<uint64_t>(dynamicBuffer.size(), dynamicSegment->fileSize));
+            writeBlock(dynamicSegment->offset, dynamicBuffer);
+            return true;
+        }
+    }
+    // the string table and the dynamic section can't grow in place : they move to a new segment
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const DynamicEntry & entry) {
+        return entry.tag == DT_RPATH_TAG || entry.tag == DT_RUNPATH_TAG;
+    }), entries.end());
+    entries.push_back({DT_RUNPATH_TAG, strings.size()});
+    strings.insert(strings.end(), runpath.begin(), runpath.end());
+    strings.push_back('\0');
+    appendDynamicSegment(segments, entries, stringTableOffset, strings);
+    return true;
+}
+
+void ElfReader::appendDynamicSegment(std::vector<Segment> & segments, std::vector<DynamicEntry> & entries,
+                                     uint64_t stringTableOffset, const std::vector<char> & strings)
+{
+    std::vector<Segment> loadSegments;
+    std::copy_if(segments.begin(), segments.end(), std::back_inserter(loadSegments), [](const Segment & segment) { return segment.type == PT_LOAD_TYPE; });
+    if (loadSegments.empty() || m_phNum + 1 > 0xffff) {
+        throw std::runtime_error("unsupported program headers");
+    }
+    uint64_t pageSize = MIN_PAGE_SIZE;
+    uint64_t addressEnd = 0;
+    for (auto & segment : loadSegments) {
+        pageSize = std::max(pageSize, segment.alignment);
+        addressEnd = std::max(addressEnd, segment.address + segment.memorySize);
+    }
+    // the new segment keeps the address to offset delta of the first segment :
+    // the kernel computes the program headers address from e_phoff with this delta
+    uint64_t delta = loadSegments.front().address - loadSegments.front().offset;
+    if (delta % pageSize != 0 || addressEnd < delta) {
+        throw std::runtime_error("unsupported segments layout");
+    }
+    uint64_t segmentOffset = alignUp(std::max(m_fileSize, addressEnd - delta), pageSize);
+    uint64_t segmentAddress = segmentOffset + delta;
+
+    // new segment content : program headers, dynamic section, string table
+    uint64_t headersSize = static_cast<uint64_t>(m_phNum + 1) * m_phEntrySize;
+    uint64_t dynamicOffset = alignUp(headersSize, 8);
+    uint64_t dynamicSize = (entries.size() + 1) * (m_is64 ? 16 : 8);
+    uint64_t stringsOffset = dynamicOffset + dynamicSize;
+    uint64_t segmentSize = stringsOffset + strings.size();
+
+    for (auto & entry : entries) {
+        if (entry.tag == DT_STRTAB_TAG) {
+            entry.value = segmentAddress + stringsOffset;
+        }
+        else if (entry.tag == DT_STRSZ_TAG) {
+            entry.value = strings.size();
+        }
+    }
+    std::vector<Segment> newSegments;
+    Segment loadSegment {PT_LOAD_TYPE, PF_R_FLAG | PF_W_FLAG, segmentOffset, segmentAddress, segmentSize, segmentSize, pageSize};
+    std::size_t lastLoadIndex = 0;
+    for (std::size_t index = 0; index < segments.size(); index++) {
+        Segment segment = segments[index];
+        if (segment.type == PT_PHDR_TYPE) {
+            segment = {PT_PHDR_TYPE, segment.flags, segmentOffset, segmentAddress, headersSize, headersSize, segment.alignment};
+        }
+        else if (segment.type == PT_DYNAMIC_TYPE) {
+            segment = {PT_DYNAMIC_TYPE, segment.flags, segmentOffset + dynamicOffset, segmentAddress + dynamicOffset, dynamicSize, dynamicSize, segment.alignment};
+        }
+        else if (segment.type == PT_LOAD_TYPE) {
+            lastLoadIndex = newSegments.size();
+        }
+        newSegments.push_back(segment);
+    }
+    // loadable segments are sorted by address
+    newSegments.insert(newSegments.begin() + static_cast<std::ptrdiff_t>(lastLoadIndex + 1), loadSegment);
+
+    std::vector<char> content;
+    for (auto & segment : newSegments) {
+        std::vector<char> header = encodeSegment(segment);
+        content.insert(content.end(), header.begin(), header.end());
+    }
+    content.resize(dynamicOffset, 0);
+    std::vector<char> dynamicBuffer = encodeDynamicEntries(entries);
+    content.insert(content.end(), dynamicBuffer.begin(), dynamicBuffer.end());
+    content.insert(content.end(), strings.begin(), strings.end());
+    writeBlock(segmentOffset, content);
+
+    std::vector<char> header;
+    if (!readBlock(0, 64, header)) {
+        throw std::runtime_error("invalid header");
+    }
+    write(header, m_is64 ? 0x20 : 0x1C, m_is64 ? 8 : 4, segmentOffset);
+    write(header, m_is64 ? 0x38 : 0x2C, 2, m_phNum + 1);
+    header.resize(m_is64 ? 64 : 52);
+    writeBlock(0, header);
+    m_phOffset = segmentOffset;
+    m_phNum++;
+
+    // section headers follow the moved dynamic section and string table
+    if (m_shOffset == 0 || m_shEntrySize < (m_is64 ? 64u : 40u)) {
+        return;
+    }
+    for (uint32_t index = 0; index < m_shNum; index++) {
+        Section dynamicSection, stringSection;
+        if (!readSection(index, dynamicSection) || dynamicSection.type != SHT_DYNAMIC_TYPE) {
+            continue;
+        }
+        writeSection(index, {dynamicSection.type, segmentAddress + dynamicOffset, segmentOffset + dynamicOffset, dynamicSize, dynamicSection.link});
+        if (readSection(dynamicSection.link, stringSection) && stringSection.offset == stringTableOffset) {
+            writeSection(dynamicSection.link, {stringSection.type, segmentAddress + stringsOffset, segmentOffset + stringsOffset, strings.size(), stringSection.link});
+        }
+        break;
+    }
+}
+
+}
+
+bool ElfUtils::isElfFile(const fs::path & filePath)
+{
+    ElfReader reader(filePath);
+    return reader.valid();
+}
+
+bool ElfUtils::readDynamicInfo(const fs::path & filePath, DynamicInfo & info)
+{
+    ElfReader reader(filePath);
+    return reader.readDynamicInfo(info);
+}
+
+bool ElfUtils::setRunpath(const fs::path & filePath, const std::string & runpath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    ElfReader reader(filePath, true);
+    if (!reader.valid()) {
+        throw std::runtime_error("Error : " + filePath.generic_string(utf8) + " is not an ELF file");
+    }
+    try {
+        return reader.setRunpath(runpath);
+    }
+    catch (const std::runtime_error & e) {
+        throw std::runtime_error("Error : unable to set the runpath of " + filePath.generic_string(utf8) + " : " + e.what());
+    }
+}
+
+bool ElfUtils::runpathPatches(const fs::path & filePath, const std::string & runpath, Patches & patches)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    ElfReader reader(filePath);
+    if (!reader.valid()) {
+        throw std::runtime_error("Error : " + filePath.generic_string(utf8) + " is not an ELF file");
+    }
+    patches.clear();
+    reader.recordWrites(patches);
+    try {
+        return reader.setRunpath(runpath);
+    }
+    catch (const std::runtime_error & e) {
+        throw std::runtime_error("Error : unable to set the runpath of " + filePath.generic_string(utf8) + " : " + e.what());
+    }
+}
+
+uint64_t ElfUtils::patchedSize(uint64_t fileSize, const Patches & patches)
+{
+    for (auto & [offset, bytes] : patches) {
+        fileSize = std::max<uint64_t>(fileSize, offset + bytes.size());
+    }
+    return fileSize;
+}
+
+void ElfUtils::applyPatches(const Patches & patches, uint64_t offset, char * data, std::size_t size)
+{
+    for (auto & [patchOffset, bytes] : patches) {
+        uint64_t begin = std::max(offset, patchOffset);
+        uint64_t end = std::min<uint64_t>(offset + size, patchOffset + bytes.size());
+        if (begin < end) {
+            std::memcpy(data + (begin - offset), bytes.data() + (begin - patchOffset), static_cast<std::size_t>(end - begin));
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief minimal in-process ELF reader (dynamic section informations) and runpath editor
+ * @date 2026-10-19
+ */
+
+#ifndef ELFUTILS_H
+#define ELFUTILS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+class ElfUtils
+{
+public:
+    typedef struct {
+        std::string soname;
+        std::vector<std::string> needed;
+        std::string rpath;
+        std::string runpath;
+    } DynamicInfo;
+
+    // bytes replacing a file content : file offset -> replacement bytes.
+    // Bytes past the end of the file extend it, the gap is filled with zeros
+    typedef std::map<uint64_t, std::string> Patches;
+
+    ElfUtils() = delete;
+    ~ElfUtils() = delete;
+    static bool isElfFile(const fs::path & filePath);
+    // reads DT_SONAME, DT_NEEDED, DT_RPATH and DT_RUNPATH entries.
+    // returns false when the file is not an ELF file or has no dynamic section
+    static bool readDynamicInfo(const fs::path & filePath, DynamicInfo & info);
+    // sets the DT_RUNPATH of filePath (DT_RPATH is replaced) : the string is rewritten in place when it fits,
+    // otherwise the dynamic section and its string table move to a new loadable segment appended to the file.
+    // returns false when the runpath is unchanged, throws std::runtime_error on failure
+    static bool setRunpath(const fs::path & filePath, const std::string & runpath);
+    // computes the changes of setRunpath without modifying filePath : the patched content is written while the file is copied or archived
+    static bool runpathPatches(const fs::path & filePath, const std::string & runpath, Patches & patches);
+    static uint64_t patchedSize(uint64_t fileSize, const Patches & patches);
+    // applies the patches to data, the content of the patched file at offset (bytes past the end of the source file are zeros)
+    static void applyPatches(const Patches & patches, uint64_t offset, char * data, std::size_t size);
+};
+
+#endif // ELFUTILS_H
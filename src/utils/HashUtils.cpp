@@ -0,0 +1,104 @@
+#include "HashUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+#include <openssl/evp.h>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+class Sha256Context {
+public:
+    Sha256Context():m_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free)
+    {
+        if (!m_ctx || EVP_DigestInit_ex(m_ctx.get(), EVP_sha256(), nullptr) != 1) {
+            throw std::runtime_error("Unable to initialize SHA-256 digest");
+        }
+    }
+
+    void update(const void * data, std::size_t size)
+    {
+        EVP_DigestUpdate(m_ctx.get(), data, size);
+    }
+
+    std::string hexDigest()
+    {
+        static constexpr const char * hexChars = "0123456789abcdef";
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digestSize = 0;
+        EVP_DigestFinal_ex(m_ctx.get(), digest, &digestSize);
+        std::string hexStr;
+        hexStr.reserve(digestSize * 2);
+        for (unsigned int i = 0; i < digestSize; i++) {
+            hexStr.push_back(hexChars[digest[i] >> 4]);
+            hexStr.push_back(hexChars[digest[i] & 0x0f]);
+        }
+        return hexStr;
+    }
+
+private:
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> m_ctx;
+};
+
+}
+
+uint64_t HashUtils::fnv1a(const std::string_view & data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string HashUtils::sha256(const std::string_view & data)
+{
+    Sha256Context ctx;
+    ctx.update(data.data(), data.size());
+    return ctx.hexDigest();
+}
+
+std::string HashUtils::sha256File(const fs::path & filePath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::ifstream fis(filePath.generic_string(utf8), std::ios::in | std::ios::binary);
+    if (!fis.is_open()) {
+        return std::string();
+    }
+    Sha256Context ctx;
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    while (fis) {
+        fis.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (fis.gcount() > 0) {
+            ctx.update(buffer.data(), static_cast<std::size_t>(fis.gcount()));
+        }
+    }
+    if (fis.bad()) {
+        return std::string();
+    }
+    return ctx.hexDigest();
+}
+
+std::vector<std::string> HashUtils::sha256Files(const std::vector<fs::path> & filePaths)
+{
+    std::vector<std::string> hashes(filePaths.size());
+    boost::asio::thread_pool pool(defaultJobs());
+    for (std::size_t i = 0; i < filePaths.size(); i++) {
+        boost::asio::post(pool, [&filePaths, &hashes, i]() {
+            hashes[i] = sha256File(filePaths[i]);
+        });
+    }
+    pool.join();
+    return hashes;
+}
+
+unsigned int HashUtils::defaultJobs()
+{
+    unsigned int jobs = std::thread::hardware_concurrency();
+    return (jobs == 0) ? 4 : jobs;
+}
@@ -0,0 +1,50 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief file content hashing
+ * @date 2026-10-19
+ */
+
+#ifndef HASHUTILS_H
+#define HASHUTILS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+class HashUtils
+{
+public:
+    HashUtils() = delete;
+    ~HashUtils() = delete;
+    // hexadecimal SHA-256 digests
+    static std::string sha256(const std::string_view & data);
+    // returns an empty string when the file can't be read
+    static std::string sha256File(const fs::path & filePath);
+    // hashes the files on a thread pool : result[i] is the digest of filePaths[i]
+    static std::vector<std::string> sha256Files(const std::vector<fs::path> & filePaths);
+    // FNV-1a 64 bits : fast non cryptographic hash for cache keys and content change detection
+    static uint64_t fnv1a(const std::string_view & data);
+    static unsigned int defaultJobs();
+};
+
+#endif // HASHUTILS_H
@@ -0,0 +1,40 @@
+#include "InternedString.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+typedef struct {
+    // deque elements never move : the index keys are views on the stored strings
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, const std::string *> index;
+    std::mutex mutex;
+} InternTable;
+
+InternTable & internTable()
+{
+    static InternTable table;
+    return table;
+}
+
+}
+
+InternedString::InternedString()
+{
+    static const std::string * emptyStr = intern(std::string_view());
+    m_str = emptyStr;
+}
+
+const std::string * InternedString::intern(const std::string_view & str)
+{
+    InternTable & table = internTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.index.find(str);
+    if (it != table.index.end()) {
+        return it->second;
+    }
+    const std::string & storedStr = table.strings.emplace_back(str);
+    table.index.emplace(std::string_view(storedStr), &storedStr);
+    return &storedStr;
+}
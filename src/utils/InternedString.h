@@ -0,0 +1,61 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief process wide string interning
+ * @date 2026-10-19
+ */
+
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+
+// Handle on an immutable string stored once for the whole process.
+// Copies are pointer copies, and comparing two handles compares pointers.
+// Used for the low cardinality Dependency fields (names, versions, repositories, modes ...)
+class InternedString
+{
+public:
+    InternedString();
+    InternedString(const std::string_view & str):m_str(intern(str)) {}
+    InternedString(const std::string & str):InternedString(std::string_view(str)) {}
+    InternedString(const char * str):InternedString(std::string_view(str)) {}
+
+    const std::string & str() const { return *m_str; }
+    operator const std::string &() const { return *m_str; }
+    bool empty() const { return m_str->empty(); }
+
+    bool operator==(const InternedString & other) const { return m_str == other.m_str; }
+    bool operator!=(const InternedString & other) const { return m_str != other.m_str; }
+    friend bool operator==(const InternedString & lhs, const std::string & rhs) { return *lhs.m_str == rhs; }
+    friend bool operator==(const std::string & lhs, const InternedString & rhs) { return lhs == *rhs.m_str; }
+    friend bool operator!=(const InternedString & lhs, const std::string & rhs) { return *lhs.m_str != rhs; }
+    friend bool operator!=(const std::string & lhs, const InternedString & rhs) { return lhs != *rhs.m_str; }
+    friend bool operator==(const InternedString & lhs, const char * rhs) { return *lhs.m_str == rhs; }
+    friend bool operator!=(const InternedString & lhs, const char * rhs) { return *lhs.m_str != rhs; }
+    friend std::ostream & operator<<(std::ostream & stream, const InternedString & str) { return stream << *str.m_str; }
+
+private:
+    // thread safe : returns the unique stored copy of str, which lives until the process ends
+    static const std::string * intern(const std::string_view & str);
+    const std::string * m_str;
+};
+
+#endif // INTERNEDSTRING_H
@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/predef.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const fs::path & filePath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+    HANDLE fileHandle = CreateFileW(filePath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0) {
+            HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle != nullptr) {
+                m_mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mappingHandle);
+                if (m_mapping != nullptr) {
+                    m_data = static_cast<const char *>(m_mapping);
+                    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+                }
+            }
+        }
+        CloseHandle(fileHandle);
+    }
+#else
+    int fd = open(filePath.string(utf8).c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+            void * mapping = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                m_mapping = mapping;
+                m_data = static_cast<const char *>(mapping);
+                m_size = static_cast<std::size_t>(fileStat.st_size);
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (m_mapping != nullptr) {
+        return;
+    }
+    // empty files can't be mapped, and some filesystems don't support mappings : read the content
+    std::ifstream fis(filePath.string(utf8), std::ios::in | std::ios::binary);
+    if (!fis.is_open()) {
+        throw std::runtime_error("Unable to open file " + filePath.generic_string(utf8));
+    }
+    std::ostringstream sstr;
+    sstr << fis.rdbuf();
+    m_buffer = sstr.str();
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_mapping == nullptr) {
+        return;
+    }
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+    UnmapViewOfFile(m_mapping);
+#else
+    munmap(m_mapping, m_size);
+#endif
+}
@@ -0,0 +1,51 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief read-only memory mapped file
+ * @date 2026-10-19
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string_view>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+// Read-only view of a whole file content.
+// The file is memory mapped when possible, and read in memory otherwise.
+class MappedFile
+{
+public:
+    // throws std::runtime_error when the file can't be opened
+    explicit MappedFile(const fs::path & filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    std::string_view content() const { return std::string_view(m_data, m_size); }
+
+private:
+    const char * m_data = nullptr;
+    std::size_t m_size = 0;
+    void * m_mapping = nullptr;
+    std::string m_buffer;
+};
+
+#endif // MAPPEDFILE_H
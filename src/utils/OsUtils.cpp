@@ -4,11 +4,30 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/log/trivial.hpp>
+#include <fstream>
+#include <sstream>
 
 #ifdef BOOST_OS_WINDOWS_AVAILABLE
 #include <wbemidl.h>
 #endif
 
+#ifndef BOOST_OS_WINDOWS_AVAILABLE
+#include <sys/stat.h>
+#endif
+
+#ifdef BOOST_OS_LINUX_AVAILABLE
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
 bool OsUtils::isElevated()
 {
 #ifdef BOOST_OS_ANDROID_AVAILABLE
@@ -149,16 +168,175 @@ const std::string_view & OsUtils::PathEnvSeparator(const std::string_view & osSt
     return os2sharedPathEnvSeparator.at(osStr);
 }
 
-void OsUtils::copyLibrary(const fs::path & sourceFile, const fs::path & destinationFolderPath, const std::string_view & suffix, bool overwrite)
+#ifdef BOOST_OS_LINUX_AVAILABLE
+namespace {
+
+class FileDescriptor {
+public:
+    FileDescriptor(int fd):m_fd(fd) {}
+    ~FileDescriptor() { if (m_fd >= 0) { ::close(m_fd); } }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor & operator=(const FileDescriptor &) = delete;
+    int get() const { return m_fd; }
+
+private:
+    int m_fd;
+};
+
+// errors meaning the copy implementation isn't supported for these files : the next one is tried
+bool isUnsupportedCopy(int error)
+{
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP || error == ENOTTY || error == EBADF || error == EPERM;
+}
+
+}
+#endif
+
+std::string_view OsUtils::copyMethodName(CopyMethod method)
+{
+    switch (method) {
+    case CopyMethod::Reflink:
+        return "reflink";
+    case CopyMethod::CopyFileRange:
+        return "copy_file_range";
+    case CopyMethod::Sendfile:
+        return "sendfile";
+    default:
+        return "buffered";
+    }
+}
+
+bool OsUtils::sameFileSystem(const fs::path & first, const fs::path & second)
+{
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+    boost::system::error_code firstError, secondError;
+    fs::path firstPath = fs::canonical(first, firstError);
+    fs::path secondPath = fs::canonical(second, secondError);
+    return !firstError && !secondError && boost::iequals(firstPath.root_name().generic_string(), secondPath.root_name().generic_string());
+#else
+    struct stat firstStat, secondStat;
+    return stat(first.c_str(), &firstStat) == 0 && stat(second.c_str(), &secondStat) == 0 && firstStat.st_dev == secondStat.st_dev;
+#endif
+}
+
+std::string OsUtils::fileIdentity(const fs::path & filePath)
+{
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+    boost::system::error_code sizeError, timeError;
+    uintmax_t size = fs::file_size(filePath, sizeError);
+    std::time_t lastWriteTime = fs::last_write_time(filePath, timeError);
+    if (sizeError || timeError) {
+        return "";
+    }
+    return std::to_string(size) + ":" + std::to_string(static_cast<int64_t>(lastWriteTime));
+#else
+    struct stat fileStat;
+    if (stat(filePath.c_str(), &fileStat) != 0) {
+        return "";
+    }
+    return std::to_string(fileStat.st_size) + ":" + std::to_string(static_cast<int64_t>(fileStat.st_mtime)) + ":"
+            + std::to_string(fileStat.st_dev) + ":" + std::to_string(fileStat.st_ino);
+#endif
+}
+
+OsUtils::CopyMethod OsUtils::copyFile(const fs::path & sourceFile, const fs::path & destinationFile)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    if (fs::exists(fs::symlink_status(destinationFile, ec))) {
+        if (fs::equivalent(sourceFile, destinationFile, ec)) {
+            throw std::runtime_error("Error copying " + sourceFile.generic_string(utf8) + " : source and destination are the same file");
+        }
+        fs::remove(destinationFile);
+    }
+#ifdef BOOST_OS_LINUX_AVAILABLE
+    auto copyError = [&](const std::string & operation) {
+        return std::runtime_error("Error copying " + sourceFile.generic_string(utf8) + " to " + destinationFile.generic_string(utf8)
+                                  + " : " + operation + " failed (" + std::strerror(errno) + ")");
+    };
+    FileDescriptor source(::open(sourceFile.generic_string(utf8).c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat sourceStat;
+    if (source.get() < 0 || ::fstat(source.get(), &sourceStat) != 0) {
+        throw copyError("open");
+    }
+    FileDescriptor destination(::open(destinationFile.generic_string(utf8).c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, sourceStat.st_mode & 07777));
+    if (destination.get() < 0) {
+        throw copyError("create");
+    }
+    ::fchmod(destination.get(), sourceStat.st_mode & 07777); // ignores the umask
+    if (sourceStat.st_size == 0) {
+        return CopyMethod::Buffered;
+    }
+    if (::ioctl(destination.get(), FICLONE, source.get()) == 0) {
+        return CopyMethod::Reflink;
+    }
+
+    // in-kernel copies : the destination offset always matches the copied size
+    off_t copiedSize = 0;
+    while (copiedSize < sourceStat.st_size) {
+        ssize_t result = ::copy_file_range(source.get(), nullptr, destination.get(), nullptr, static_cast<size_t>(sourceStat.st_size - copiedSize), 0);
+        if (result <= 0) {
+            if (result < 0 && copiedSize == 0 && isUnsupportedCopy(errno)) {
+                break;
+            }
+            throw copyError("copy_file_range");
+        }
+        copiedSize += result;
+    }
+    if (copiedSize == sourceStat.st_size) {
+        return CopyMethod::CopyFileRange;
+    }
+    while (copiedSize < sourceStat.st_size) {
+        ssize_t result = ::sendfile(destination.get(), source.get(), nullptr, static_cast<size_t>(sourceStat.st_size - copiedSize));
+        if (result <= 0) {
+            if (result < 0 && copiedSize == 0 && isUnsupportedCopy(errno)) {
+                break;
+            }
+            throw copyError("sendfile");
+        }
+        copiedSize += result;
+    }
+    if (copiedSize == sourceStat.st_size) {
+        return CopyMethod::Sendfile;
+    }
+
+    std::vector<char> buffer(1 << 20);
+    ssize_t readSize;
+    while ((readSize = ::read(source.get(), buffer.data(), buffer.size())) > 0) {
+        for (ssize_t offset = 0; offset < readSize;) {
+            ssize_t written = ::write(destination.get(), buffer.data() + offset, static_cast<size_t>(readSize - offset));
+            if (written < 0) {
+                throw copyError("write");
+            }
+            offset += written;
+        }
+    }
+    if (readSize < 0) {
+        throw copyError("read");
+    }
+    return CopyMethod::Buffered;
+#else
+    fs::copy_file(sourceFile, destinationFile);
+    return CopyMethod::Buffered;
+#endif
+}
+
+bool OsUtils::hasLibrarySuffix(const fs::path & filePath, const std::string_view & suffix)
 {
+    // handles versioned libraries such as libfoo.so.1.2.3
     fs::detail::utf8_codecvt_facet utf8;
-    fs::path currentPath = sourceFile;
+    fs::path currentPath = filePath.filename();
     fs::path fileSuffix;
     while (currentPath.has_extension() && fileSuffix.string(utf8) != suffix) {
         fileSuffix = currentPath.extension();
         currentPath = currentPath.stem();
     }
-    if (fileSuffix.string(utf8) == suffix) {
+    return (fileSuffix.string(utf8) == suffix);
+}
+
+void OsUtils::copyLibrary(const fs::path & sourceFile, const fs::path & destinationFolderPath, const std::string_view & suffix, bool overwrite)
+{
+    if (hasLibrarySuffix(sourceFile, suffix)) {
         auto linkStatus = fs::symlink_status(sourceFile);
         if (linkStatus.type() == fs::symlink_file) {
             if (fs::is_symlink(destinationFolderPath/sourceFile.filename())) {
@@ -168,7 +346,7 @@ void OsUtils::copyLibrary(const fs::path & sourceFile, const fs::path & destinat
         }
         else if (is_regular_file(sourceFile)) {
             if (!fs::exists(destinationFolderPath/sourceFile.filename()) || overwrite) {
-                fs::copy_file(sourceFile , destinationFolderPath/sourceFile.filename(), fs::copy_option::overwrite_if_exists);
+                copyFile(sourceFile, destinationFolderPath/sourceFile.filename());
             }
         }
     }
@@ -201,7 +379,12 @@ template <class T> void copyFolder(const fs::path & srcFolderPath, const fs::pat
         const auto& path = x.path();
         auto relativePathStr = path.generic_string(utf8);
         boost::algorithm::replace_first(relativePathStr, srcFolderPath.generic_string(utf8), "");
-        fs::copy(path, dstFolderPath / relativePathStr,fs::copy_options::overwrite_existing);
+        if (fs::is_regular_file(fs::symlink_status(path))) {
+            OsUtils::copyFile(path, dstFolderPath / relativePathStr);
+        }
+        else {
+            fs::copy(path, dstFolderPath / relativePathStr,fs::copy_options::overwrite_existing);
+        }
     }
 }
 
@@ -228,6 +411,26 @@ void OsUtils::copyFolder(const fs::path & srcFolderPath, const fs::path & dstFol
     }
 }
 
+void OsUtils::moveFolderContent(const fs::path & srcFolderPath, const fs::path & dstFolderPath)
+{
+    fs::create_directories(dstFolderPath);
+    for (fs::directory_iterator it(srcFolderPath), end; it != end; ++it) {
+        fs::path dstPath = dstFolderPath / it->path().filename();
+        fs::file_status srcStatus = it->symlink_status();
+        fs::file_status dstStatus = fs::symlink_status(dstPath);
+        if (fs::is_directory(dstStatus) && fs::is_directory(srcStatus)) {
+            moveFolderContent(it->path(), dstPath);
+        }
+        else {
+            // a file replaces a file atomically, other replacements need the destination removal first
+            if (fs::is_directory(dstStatus) || (fs::exists(dstStatus) && fs::is_directory(srcStatus))) {
+                fs::remove_all(dstPath);
+            }
+            fs::rename(it->path(), dstPath);
+        }
+    }
+}
+
 
 void OsUtils::copyLibraries(const fs::path & sourceRootFolder, const CmdOptions & options, std::function<const std::string_view &(const std::string_view &)> suffixFunction)
 {
@@ -309,3 +512,32 @@ fs::path OsUtils::extractPath(const fs::path & first, const fs::path & second)
     boost::algorithm::replace_first(firstStr, secondStr,"");
     return fs::path(firstStr,utf8);
 }
+
+bool OsUtils::writeFileIfChanged(const fs::path & filePath, const std::string & content)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    boost::system::error_code ec;
+    if (fs::is_regular_file(filePath, ec) && fs::file_size(filePath, ec) == content.size() && !ec) {
+        std::ifstream fis(filePath.generic_string(utf8), std::ios::in | std::ios::binary);
+        std::ostringstream currentContent;
+        currentContent << fis.rdbuf();
+        if (currentContent.str() == content) {
+            return false;
+        }
+    }
+    if (!filePath.parent_path().empty()) {
+        fs::create_directories(filePath.parent_path());
+    }
+    // write to a temporary file in the same folder then rename : readers never see a partial file
+    fs::path tmpFilePath = filePath;
+    tmpFilePath += "." + fs::unique_path().generic_string(utf8);
+    std::ofstream fos(tmpFilePath.generic_string(utf8), std::ios::out | std::ios::binary | std::ios::trunc);
+    fos << content;
+    fos.close();
+    if (fos.fail()) {
+        fs::remove(tmpFilePath, ec);
+        throw std::runtime_error("Unable to write file " + filePath.generic_string(utf8));
+    }
+    fs::rename(tmpFilePath, filePath);
+    return true;
+}
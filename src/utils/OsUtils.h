@@ -25,6 +25,7 @@
 
 #include "CmdOptions.h"
 
+#include <string_view>
 #include <boost/filesystem.hpp>
 
 namespace fs = boost::filesystem;
@@ -32,9 +33,27 @@ namespace fs = boost::filesystem;
 class OsUtils
 {
 public:
+    // copy implementations used by copyFile, from the cheapest one
+    enum class CopyMethod {
+        Reflink, // FICLONE : the destination shares the source extents (btrfs, xfs ...)
+        CopyFileRange, // in-kernel copy
+        Sendfile, // in-kernel copy, older kernels
+        Buffered // userspace read/write loop
+    };
+
     OsUtils() = delete;
     ~OsUtils() = delete;
+    // copies a regular file and its permissions, replacing destinationFile (a new file is created : processes mapping the previous file are not affected).
+    // Throws std::runtime_error on failure, returns the copy implementation used
+    static CopyMethod copyFile(const fs::path & sourceFile, const fs::path & destinationFile);
+    static std::string_view copyMethodName(CopyMethod method);
+    // true when both existing paths are located on the same file system (hard links can't cross file systems)
+    static bool sameFileSystem(const fs::path & first, const fs::path & second);
+    // identifies a file version from its size, modification time and file id (inode) : a reinstalled file gets a new identity.
+    // Returns an empty string when the file can't be read
+    static std::string fileIdentity(const fs::path & filePath);
     static bool isElevated();
+    static bool hasLibrarySuffix(const fs::path & filePath, const std::string_view & suffix);
     static void copyLibrary(const fs::path & sourceFile, const fs::path & destinationFolderPath, const std::string_view & suffix, bool overwrite = false);
     static void copySharedLibraries(const fs::path & sourceRootFolder, const CmdOptions & options);
     static void copyStaticLibraries(const fs::path & sourceRootFolder, const CmdOptions & options);
@@ -48,7 +67,13 @@ public:
     static const std::string_view & PathEnvSeparator(const std::string_view & osStr);
     static fs::path computeRemakenRootPackageDir(const CmdOptions & options);
     static void copyFolder(const fs::path & srcFolderPath, const fs::path & dstFolderPath, bool bRecurse);
+    // moves srcFolderPath content in dstFolderPath (must be on the same filesystem) : entries missing from dstFolderPath are moved with a single rename,
+    // existing folders are merged and existing files are replaced
+    static void moveFolderContent(const fs::path & srcFolderPath, const fs::path & dstFolderPath);
     static fs::path extractPath(const fs::path & first, const fs::path & second);
+    // replaces filePath atomically with content, only when the current file content differs : unchanged files keep their timestamp.
+    // returns true when the file was written
+    static bool writeFileIfChanged(const fs::path & filePath, const std::string & content);
 
     static fs::path acquireTempFolderPath();
     static void releaseTempFolderPath(const fs::path & tmpDir);
@@ -0,0 +1,136 @@
+#include "PackageManifest.h"
+#include "Constants.h"
+#include "HashUtils.h"
+#include "OsUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <map>
+#include <fstream>
+#include <sstream>
+
+static constexpr const char * MANIFEST_HEADER = "#remaken-manifest 2";
+// files of version 1 manifests have no install keys : they belong to every install key
+static constexpr const char * MANIFEST_HEADER_V1 = "#remaken-manifest 1";
+static constexpr const char * MANIFEST_DEPENDENCY_TAG = "#dependency ";
+static constexpr const char * MANIFEST_INSTALL_TAG = "#install ";
+
+fs::path PackageManifest::manifestPath(const fs::path & packageRoot)
+{
+    return packageRoot / Constants::PKGMANIFEST_FILE;
+}
+
+std::string PackageManifest::installKey(const CmdOptions & options, const std::string & mode)
+{
+    return options.getArchitecture() + "_" + mode + "_" + options.getConfig();
+}
+
+// Dependency::toString() always writes "identifier@type" : the explicit identifier form is only kept when it was given
+static std::string describe(const Dependency & dependency)
+{
+    std::string repository = dependency.getRepositoryType();
+    if (dependency.hasIdentifier()) {
+        repository = dependency.getIdentifier() + "@" + repository;
+    }
+    return dependency.getPackageName() + "|" + dependency.getVersion() + "|" + dependency.getName() + "|" + repository + "|"
+            + dependency.getBaseRepository() + "|" + dependency.getMode();
+}
+
+std::vector<std::string> PackageManifest::listFiles(const fs::path & folder)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::vector<std::string> relativePaths;
+    fs::path manifestFile = manifestPath(folder);
+    for (fs::recursive_directory_iterator it(folder), end; it != end; ++it) {
+        // symbolic links are not followed nor listed
+        if (fs::is_regular_file(it->symlink_status()) && it->path() != manifestFile) {
+            relativePaths.push_back(it->path().lexically_relative(folder).generic_string(utf8));
+        }
+    }
+    std::sort(relativePaths.begin(), relativePaths.end());
+    return relativePaths;
+}
+
+void PackageManifest::write(const fs::path & packageRoot, const Dependency & dependency, const std::string & installKey, const std::vector<std::string> & archiveFiles)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    PackageManifest previousManifest;
+    previousManifest.load(packageRoot);
+    std::set<std::string> installKeys = previousManifest.installKeys();
+    installKeys.insert(installKey);
+
+    // other archives files are not hashed again : a damaged file of another install key stays reported as damaged
+    std::map<std::string, FileEntry> entries;
+    for (auto & entry : previousManifest.files()) {
+        FileEntry previousEntry = entry;
+        previousEntry.installKeys.erase(installKey);
+        if (!previousEntry.installKeys.empty()) {
+            entries.emplace(entry.relativePath, std::move(previousEntry));
+        }
+    }
+    std::vector<fs::path> filePaths;
+    for (auto & relativePath : archiveFiles) {
+        filePaths.push_back(packageRoot / fs::path(relativePath, utf8));
+    }
+    std::vector<std::string> hashes = HashUtils::sha256Files(filePaths);
+    for (std::size_t i = 0; i < filePaths.size(); i++) {
+        FileEntry & entry = entries[archiveFiles[i]];
+        entry.relativePath = archiveFiles[i];
+        entry.size = fs::file_size(filePaths[i]);
+        entry.hash = hashes[i];
+        entry.installKeys.insert(installKey);
+    }
+
+    std::ostringstream manifest;
+    manifest<<MANIFEST_HEADER<<std::endl;
+    manifest<<MANIFEST_DEPENDENCY_TAG<<describe(dependency)<<std::endl;
+    for (auto & key : installKeys) {
+        manifest<<MANIFEST_INSTALL_TAG<<key<<std::endl;
+    }
+    for (auto & [relativePath, entry] : entries) {
+        manifest<<entry.hash<<" "<<entry.size<<" "<<boost::algorithm::join(entry.installKeys, ",")<<" "<<relativePath<<std::endl;
+    }
+    OsUtils::writeFileIfChanged(manifestPath(packageRoot), manifest.str());
+}
+
+bool PackageManifest::load(const fs::path & packageRoot)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    m_dependencyDescription.clear();
+    m_installKeys.clear();
+    m_files.clear();
+    std::ifstream fis(manifestPath(packageRoot).generic_string(utf8), std::ios::in);
+    std::string line;
+    if (!fis.is_open() || !std::getline(fis, line) || (line != MANIFEST_HEADER && line != MANIFEST_HEADER_V1)) {
+        return false;
+    }
+    bool withInstallKeys = (line == MANIFEST_HEADER);
+    while (std::getline(fis, line)) {
+        if (line.rfind(MANIFEST_DEPENDENCY_TAG, 0) == 0) {
+            m_dependencyDescription = line.substr(std::char_traits<char>::length(MANIFEST_DEPENDENCY_TAG));
+        }
+        else if (line.rfind(MANIFEST_INSTALL_TAG, 0) == 0) {
+            m_installKeys.insert(line.substr(std::char_traits<char>::length(MANIFEST_INSTALL_TAG)));
+        }
+        else if (!line.empty()) {
+            // "hash size installKey1,installKey2 relative/path" : the path is last as it may contain spaces
+            std::size_t hashEnd = line.find(' ');
+            std::size_t sizeEnd = (hashEnd == std::string::npos) ? std::string::npos : line.find(' ', hashEnd + 1);
+            std::size_t keysEnd = (sizeEnd == std::string::npos || !withInstallKeys) ? sizeEnd : line.find(' ', sizeEnd + 1);
+            if (keysEnd == std::string::npos) {
+                throw std::runtime_error("Invalid manifest line '" + line + "' in " + manifestPath(packageRoot).generic_string(utf8));
+            }
+            FileEntry entry {line.substr(keysEnd + 1), std::stoull(line.substr(hashEnd + 1, sizeEnd - hashEnd - 1)), line.substr(0, hashEnd), {}};
+            if (withInstallKeys) {
+                boost::split(entry.installKeys, line.substr(sizeEnd + 1, keysEnd - sizeEnd - 1), [](char c){return c == ',';});
+            }
+            m_files.push_back(std::move(entry));
+        }
+    }
+    if (!withInstallKeys) {
+        for (auto & entry : m_files) {
+            entry.installKeys = m_installKeys;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief installed package files manifest
+ * @date 2026-10-19
+ */
+
+#ifndef PACKAGEMANIFEST_H
+#define PACKAGEMANIFEST_H
+
+#include <string>
+#include <set>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "CmdOptions.h"
+#include "Dependency.h"
+
+namespace fs = boost::filesystem;
+
+// Lists every regular file of an installed package (relative path, size and SHA-256 digest).
+// The manifest is stored in the package root folder, next to the .pkginfo folder.
+class PackageManifest
+{
+public:
+    typedef struct {
+        std::string relativePath;
+        uint64_t size;
+        std::string hash;
+        // install keys of the archives providing the file
+        std::set<std::string> installKeys;
+    } FileEntry;
+
+    static fs::path manifestPath(const fs::path & packageRoot);
+    // "architecture_mode_config" : identifies one installed archive of the package
+    static std::string installKey(const CmdOptions & options, const std::string & mode);
+    // sorted relative paths of the regular files under folder
+    static std::vector<std::string> listFiles(const fs::path & folder);
+    // hashes archiveFiles, the package files extracted from the archive identified by installKey (architecture, mode and config),
+    // and writes the manifest : files of the other install keys keep their previous entry
+    static void write(const fs::path & packageRoot, const Dependency & dependency, const std::string & installKey, const std::vector<std::string> & archiveFiles);
+    // returns false when the package has no manifest
+    bool load(const fs::path & packageRoot);
+
+    // packagedependencies line of the installed dependency
+    const std::string & dependencyDescription() const { return m_dependencyDescription; }
+    const std::set<std::string> & installKeys() const { return m_installKeys; }
+    const std::vector<FileEntry> & files() const { return m_files; }
+
+private:
+    std::string m_dependencyDescription;
+    std::set<std::string> m_installKeys;
+    std::vector<FileEntry> m_files;
+};
+
+#endif // PACKAGEMANIFEST_H
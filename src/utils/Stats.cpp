@@ -0,0 +1,248 @@
+#include "Stats.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/predef.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace nj = nlohmann;
+
+namespace {
+
+typedef struct {
+    uint64_t bytes = 0;
+    uint64_t files = 0;
+} DownloadStats;
+
+typedef struct {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+} CacheStats;
+
+typedef struct {
+    uint64_t count = 0;
+    std::chrono::steady_clock::duration time{};
+} ProcessStats;
+
+typedef std::pair<std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point> Interval;
+
+std::atomic<bool> statsEnabled = false;
+std::mutex statsMutex;
+std::chrono::steady_clock::time_point statsStart;
+std::map<std::string, DownloadStats> downloads;
+std::map<std::string, CacheStats> caches;
+std::map<std::string, ProcessStats> processes;
+// category -> spans intervals
+std::map<std::string, std::vector<Interval>> phases;
+uint64_t installedPackages = 0;
+uint64_t skippedPackages = 0;
+
+double milliseconds(const std::chrono::steady_clock::duration & duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// nested and parallel spans are only counted once
+std::chrono::steady_clock::duration wallTime(std::vector<Interval> intervals)
+{
+    std::sort(intervals.begin(), intervals.end());
+    std::chrono::steady_clock::duration total{};
+    auto current = intervals.front();
+    for (auto & interval : intervals) {
+        if (interval.first > current.second) {
+            total += current.second - current.first;
+            current = interval;
+        }
+        else {
+            current.second = std::max(current.second, interval.second);
+        }
+    }
+    return total + current.second - current.first;
+}
+
+std::string formatBytes(uint64_t bytes)
+{
+    std::ostringstream stream;
+    stream<<std::fixed<<std::setprecision(1);
+    if (bytes >= 1024 * 1024) {
+        stream<<static_cast<double>(bytes) / (1024 * 1024)<<" MB";
+    }
+    else {
+        stream<<static_cast<double>(bytes) / 1024<<" KB";
+    }
+    return stream.str();
+}
+
+std::string formatTime(double ms)
+{
+    std::ostringstream stream;
+    stream<<std::fixed<<std::setprecision(2)<<ms / 1000<<" s";
+    return stream.str();
+}
+
+}
+
+void Stats::start()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    statsStart = std::chrono::steady_clock::now();
+    downloads.clear();
+    caches.clear();
+    processes.clear();
+    phases.clear();
+    installedPackages = 0;
+    skippedPackages = 0;
+    statsEnabled = true;
+}
+
+bool Stats::enabled()
+{
+    return statsEnabled;
+}
+
+void Stats::addDownload(const std::string & repository, uint64_t bytes)
+{
+    if (!statsEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    downloads[repository].bytes += bytes;
+    downloads[repository].files++;
+}
+
+void Stats::addCacheLookup(const std::string & cache, bool hit)
+{
+    if (!statsEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    if (hit) {
+        caches[cache].hits++;
+    }
+    else {
+        caches[cache].misses++;
+    }
+}
+
+void Stats::addPackage(bool installed)
+{
+    if (!statsEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    if (installed) {
+        installedPackages++;
+    }
+    else {
+        skippedPackages++;
+    }
+}
+
+void Stats::addSpan(const std::string & category, const std::string & name,
+                    const std::chrono::steady_clock::time_point & start, const std::chrono::steady_clock::time_point & end)
+{
+    if (!statsEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(statsMutex);
+    auto spanStart = std::max(start, statsStart);
+    phases[category].push_back({spanStart, end});
+    if (category == "process") {
+        processes[name].count++;
+        processes[name].time += end - spanStart;
+    }
+}
+
+uint64_t Stats::peakResidentSetSize()
+{
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef BOOST_OS_MACOS_AVAILABLE
+    // bytes on mac, kilobytes elsewhere
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+void Stats::stop(const std::string & command, const fs::path & statsFile)
+{
+    if (!statsEnabled) {
+        return;
+    }
+    statsEnabled = false;
+    fs::detail::utf8_codecvt_facet utf8;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    double commandTime = milliseconds(std::chrono::steady_clock::now() - statsStart);
+    uint64_t peakRss = peakResidentSetSize();
+
+    nj::json stats = {{"command", command}, {"wallTimeMs", commandTime}, {"peakRssBytes", peakRss},
+                      {"packages", {{"installed", installedPackages}, {"skipped", skippedPackages}}}};
+    stats["downloads"] = nj::json::object();
+    for (auto & [repository, download] : downloads) {
+        stats["downloads"][repository] = {{"bytes", download.bytes}, {"files", download.files}};
+    }
+    stats["caches"] = nj::json::object();
+    for (auto & [cache, lookups] : caches) {
+        stats["caches"][cache] = {{"hits", lookups.hits}, {"misses", lookups.misses}};
+    }
+    stats["processes"] = nj::json::object();
+    for (auto & [tool, process] : processes) {
+        stats["processes"][tool] = {{"count", process.count}, {"timeMs", milliseconds(process.time)}};
+    }
+    stats["phases"] = nj::json::object();
+    for (auto & [category, intervals] : phases) {
+        stats["phases"][category] = {{"wallTimeMs", milliseconds(wallTime(intervals))}, {"spans", intervals.size()}};
+    }
+
+    std::cout<<"=> "<<command<<" stats : "<<formatTime(commandTime)<<", peak RSS "<<formatBytes(peakRss)<<", "
+             <<installedPackages<<" packages installed, "<<skippedPackages<<" skipped"<<std::endl;
+    for (auto & [repository, download] : downloads) {
+        std::cout<<"===> downloaded "<<formatBytes(download.bytes)<<" in "<<download.files<<" files from "<<repository<<std::endl;
+    }
+    for (auto & [cache, lookups] : caches) {
+        std::cout<<"===> "<<cache<<" cache : "<<lookups.hits<<" hits, "<<lookups.misses<<" misses"<<std::endl;
+    }
+    for (auto & [tool, process] : processes) {
+        std::cout<<"===> "<<process.count<<" "<<tool<<" processes : "<<formatTime(milliseconds(process.time))<<std::endl;
+    }
+    for (auto & [category, intervals] : phases) {
+        std::cout<<"===> "<<category<<" : "<<formatTime(milliseconds(wallTime(intervals)))<<std::endl;
+    }
+
+    std::ofstream fos(statsFile.generic_string(utf8), std::ios::out | std::ios::trunc);
+    if (!fos) {
+        BOOST_LOG_TRIVIAL(error)<<"Unable to write stats file "<<statsFile;
+        return;
+    }
+    fos<<stats.dump(2)<<'\n';
+}
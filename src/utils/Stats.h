@@ -0,0 +1,57 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief end of command metrics report
+ * @date 2026-10-19
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+// Collects the metrics of the running command for CI dashboards : downloaded bytes per repository, cache hits and misses,
+// spawned processes per tool, wall time per phase (the union of the trace spans of each category, whatever the threads),
+// peak resident set size and installed versus skipped packages.
+// stop() prints a compact summary and writes the metrics in a JSON file.
+class Stats
+{
+public:
+    Stats() = delete;
+    ~Stats() = delete;
+
+    static void start();
+    static bool enabled();
+    static void addDownload(const std::string & repository, uint64_t bytes);
+    static void addCacheLookup(const std::string & cache, bool hit);
+    static void addPackage(bool installed);
+    // called by each ending Trace::Span
+    static void addSpan(const std::string & category, const std::string & name,
+                        const std::chrono::steady_clock::time_point & start, const std::chrono::steady_clock::time_point & end);
+    // prints the summary and writes the metrics of command to statsFile
+    static void stop(const std::string & command, const fs::path & statsFile);
+    // peak resident set size of the process in bytes
+    static uint64_t peakResidentSetSize();
+};
+
+#endif // STATS_H
@@ -0,0 +1,189 @@
+#include "TarWriter.h"
+#include "BlockDeflater.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t TAR_BLOCK_SIZE = 512;
+constexpr uint32_t MODE_FILE = 0644;
+constexpr uint32_t MODE_EXECUTABLE = 0755;
+constexpr uint32_t MODE_SYMLINK = 0777;
+constexpr uint32_t MODE_DIRECTORY = 0755;
+constexpr uint64_t MAX_ENTRY_SIZE = 077777777777ULL;
+
+constexpr int DEFLATE_LEVEL = 6;
+
+// gzip stream compressed by blocks on a thread pool
+class GzipBlockStream {
+public:
+    GzipBlockStream(const fs::path & archivePath):m_archivePath(archivePath),
+        m_deflater(DEFLATE_LEVEL, [this](const char * data, std::size_t size) { writeOutput(data, size); })
+    {
+        fs::detail::utf8_codecvt_facet utf8;
+        m_stream.open(archivePath.generic_string(utf8), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_stream.is_open()) {
+            throw std::runtime_error("Unable to create archive " + archivePath.generic_string(utf8));
+        }
+        // no file name, no modification time, unix OS
+        const char header[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, 3 };
+        writeOutput(header, sizeof(header));
+    }
+
+    void write(const char * data, std::size_t size)
+    {
+        m_deflater.write(data, size);
+    }
+
+    void close()
+    {
+        uint32_t crc = 0;
+        uint64_t size = 0;
+        m_deflater.endStream([&crc, &size](uint32_t streamCrc, uint64_t streamSize) {
+            crc = streamCrc;
+            size = streamSize;
+        });
+        m_deflater.flush();
+        char trailer[8];
+        for (int i = 0; i < 4; i++) {
+            trailer[i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+            trailer[4 + i] = static_cast<char>((size >> (8 * i)) & 0xff);
+        }
+        writeOutput(trailer, sizeof(trailer));
+        m_stream.close();
+    }
+
+private:
+    void writeOutput(const char * data, std::size_t size)
+    {
+        m_stream.write(data, static_cast<std::streamsize>(size));
+        if (!m_stream) {
+            fs::detail::utf8_codecvt_facet utf8;
+            throw std::runtime_error("Unable to write archive " + m_archivePath.generic_string(utf8));
+        }
+    }
+
+    fs::path m_archivePath;
+    std::ofstream m_stream;
+    BlockDeflater m_deflater;
+};
+
+uint64_t entryModificationTime()
+{
+    const char * sourceDateEpoch = std::getenv("SOURCE_DATE_EPOCH");
+    if (sourceDateEpoch != nullptr && *sourceDateEpoch != '\0') {
+        long long epoch = std::strtoll(sourceDateEpoch, nullptr, 10);
+        return epoch > 0 ? static_cast<uint64_t>(epoch) : 0;
+    }
+    return 0;
+}
+
+void setOctal(char * field, std::size_t fieldSize, uint64_t value)
+{
+    std::snprintf(field, fieldSize, "%0*llo", static_cast<int>(fieldSize - 1), static_cast<unsigned long long>(value));
+}
+
+// ustar header : names longer than the name and prefix fields are preceded by a GNU long name entry
+void writeHeader(GzipBlockStream & stream, const std::string & name, char type, uint32_t mode, uint64_t size,
+                 uint64_t modificationTime, const std::string & linkName = "")
+{
+    std::string headerName = name;
+    std::string prefix;
+    if (name.size() > 100) {
+        std::size_t splitPos = name.rfind('/', std::min<std::size_t>(name.size() - 1, 155));
+        if (splitPos != std::string::npos && splitPos > 0 && name.size() - splitPos - 1 <= 100 && name.size() - splitPos - 1 > 0) {
+            prefix = name.substr(0, splitPos);
+            headerName = name.substr(splitPos + 1);
+        }
+        else {
+            writeHeader(stream, "././@LongLink", 'L', 0, name.size() + 1, 0);
+            std::vector<char> longName(name.begin(), name.end());
+            longName.resize((name.size() + 1 + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE, '\0');
+            stream.write(longName.data(), longName.size());
+            headerName = name.substr(0, 100);
+        }
+    }
+    if (linkName.size() > 100) {
+        writeHeader(stream, "././@LongLink", 'K', 0, linkName.size() + 1, 0);
+        std::vector<char> longLink(linkName.begin(), linkName.end());
+        longLink.resize((linkName.size() + 1 + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE, '\0');
+        stream.write(longLink.data(), longLink.size());
+    }
+    char header[TAR_BLOCK_SIZE] = {};
+    std::memcpy(header, headerName.data(), std::min<std::size_t>(headerName.size(), 100));
+    setOctal(header + 100, 8, mode);
+    setOctal(header + 108, 8, 0);
+    setOctal(header + 116, 8, 0);
+    setOctal(header + 124, 12, size);
+    setOctal(header + 136, 12, modificationTime);
+    std::memset(header + 148, ' ', 8);
+    header[156] = type;
+    std::memcpy(header + 157, linkName.data(), std::min<std::size_t>(linkName.size(), 100));
+    std::memcpy(header + 257, "ustar", 6);
+    std::memcpy(header + 263, "00", 2);
+    std::memcpy(header + 345, prefix.data(), std::min<std::size_t>(prefix.size(), 155));
+    unsigned int checksum = 0;
+    for (std::size_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+        checksum += static_cast<unsigned char>(header[i]);
+    }
+    std::snprintf(header + 148, 8, "%06o", checksum);
+    header[155] = ' ';
+    stream.write(header, TAR_BLOCK_SIZE);
+}
+
+void writeFileData(GzipBlockStream & stream, const ArchiveEntries::Entry & entry, uint64_t size)
+{
+    ArchiveEntries::readFile(entry, size, [&stream](const char * data, std::size_t chunkSize) { stream.write(data, chunkSize); });
+    std::size_t padding = static_cast<std::size_t>((TAR_BLOCK_SIZE - size % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE);
+    std::vector<char> zeros(padding, '\0');
+    stream.write(zeros.data(), zeros.size());
+}
+
+}
+
+void TarWriter::write(const fs::path & archivePath) const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    uint64_t modificationTime = entryModificationTime();
+    fs::path tmpArchivePath = archivePath.parent_path() / ("." + archivePath.filename().generic_string(utf8) + ".tmp");
+    try {
+        GzipBlockStream stream(tmpArchivePath);
+        for (auto & [entryName, entry] : m_entries.entries()) {
+            switch (entry.type) {
+            case ArchiveEntries::Type::Directory:
+                writeHeader(stream, entryName + "/", '5', MODE_DIRECTORY, 0, modificationTime);
+                break;
+            case ArchiveEntries::Type::EmptyFile:
+                writeHeader(stream, entryName, '0', MODE_FILE, 0, modificationTime);
+                break;
+            case ArchiveEntries::Type::Symlink:
+                writeHeader(stream, entryName, '2', MODE_SYMLINK, 0, modificationTime, fs::read_symlink(entry.sourcePath).generic_string(utf8));
+                break;
+            case ArchiveEntries::Type::File: {
+                uint64_t size = ArchiveEntries::fileSize(entry);
+                if (size > MAX_ENTRY_SIZE) {
+                    throw std::runtime_error(entry.sourcePath.generic_string(utf8) + " exceeds the 8GB tar entry limit");
+                }
+                writeHeader(stream, entryName, '0', ArchiveEntries::isExecutable(entry) ? MODE_EXECUTABLE : MODE_FILE, size, modificationTime);
+                writeFileData(stream, entry, size);
+                break;
+            }
+            }
+        }
+        // end of archive : two empty blocks
+        std::vector<char> zeros(2 * TAR_BLOCK_SIZE, '\0');
+        stream.write(zeros.data(), zeros.size());
+        stream.close();
+        fs::rename(tmpArchivePath, archivePath);
+    }
+    catch (...) {
+        boost::system::error_code ec;
+        fs::remove(tmpArchivePath, ec);
+        throw;
+    }
+}
@@ -0,0 +1,122 @@
+#include "Trace.h"
+#include "Stats.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/process/environment.hpp>
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace nj = nlohmann;
+
+namespace {
+
+typedef struct {
+    std::string category;
+    std::string name;
+    int64_t start;
+    int64_t duration;
+    uint32_t threadId;
+    nj::json args;
+} TraceEvent;
+
+std::atomic<bool> traceEnabled = false;
+std::mutex traceMutex;
+fs::path traceFilePath;
+std::chrono::steady_clock::time_point traceStart;
+std::vector<TraceEvent> traceEvents;
+// threads are numbered in their first span order : the main thread is 1
+std::map<std::thread::id, uint32_t> traceThreads;
+
+int64_t microseconds(const std::chrono::steady_clock::duration & duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+}
+
+Trace::Span::Span(const std::string & category, const std::string & name):m_category(category), m_name(name), m_start(std::chrono::steady_clock::now())
+{
+}
+
+Trace::Span::~Span()
+{
+    if (!traceEnabled && !Stats::enabled()) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    Stats::addSpan(m_category, m_name, m_start, end);
+    if (!traceEnabled) {
+        return;
+    }
+    nj::json args = nj::json::object();
+    for (auto & [key, value] : m_stringArgs) {
+        args[key] = value;
+    }
+    for (auto & [key, value] : m_numberArgs) {
+        args[key] = value;
+    }
+    std::lock_guard<std::mutex> lock(traceMutex);
+    auto threadIt = traceThreads.emplace(std::this_thread::get_id(), static_cast<uint32_t>(traceThreads.size() + 1)).first;
+    // spans started before the trace are clipped to its start
+    auto start = std::max(m_start, traceStart);
+    traceEvents.push_back({m_category, m_name, microseconds(start - traceStart), microseconds(end - start), threadIt->second, std::move(args)});
+}
+
+void Trace::Span::setArg(const std::string & key, const std::string & value)
+{
+    m_stringArgs.push_back({key, value});
+}
+
+void Trace::Span::setArg(const std::string & key, uint64_t value)
+{
+    m_numberArgs.push_back({key, value});
+}
+
+void Trace::start(const fs::path & traceFile)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceFilePath = traceFile;
+    traceStart = std::chrono::steady_clock::now();
+    traceEvents.clear();
+    traceThreads.clear();
+    traceThreads[std::this_thread::get_id()] = 1;
+    traceEnabled = true;
+}
+
+bool Trace::enabled()
+{
+    return traceEnabled;
+}
+
+void Trace::stop()
+{
+    if (!traceEnabled) {
+        return;
+    }
+    traceEnabled = false;
+    fs::detail::utf8_codecvt_facet utf8;
+    std::lock_guard<std::mutex> lock(traceMutex);
+    auto pid = static_cast<int64_t>(boost::this_process::get_id());
+    nj::json events = nj::json::array();
+    events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"tid", 1}, {"args", {{"name", "remaken"}}}});
+    for (auto & [id, threadId] : traceThreads) {
+        std::string threadName = threadId == 1 ? "main" : "worker " + std::to_string(threadId - 1);
+        events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", pid}, {"tid", threadId}, {"args", {{"name", threadName}}}});
+    }
+    for (auto & event : traceEvents) {
+        events.push_back({{"name", event.name}, {"cat", event.category}, {"ph", "X"}, {"ts", event.start}, {"dur", event.duration},
+                          {"pid", pid}, {"tid", event.threadId}, {"args", event.args}});
+    }
+    std::ofstream fos(traceFilePath.generic_string(utf8), std::ios::out | std::ios::trunc);
+    if (!fos) {
+        BOOST_LOG_TRIVIAL(error)<<"Unable to write trace file "<<traceFilePath;
+        return;
+    }
+    nj::json trace = {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+    fos << trace.dump() << '\n';
+}
@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief Chrome trace events recording
+ * @date 2026-10-19
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+// Records the spans of the running command in Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Each span is a complete event with its thread id : the parallel work appears on separate tracks.
+// Spans are only recorded between start() and stop(), they also feed the Stats phases when the stats are enabled.
+class Trace
+{
+public:
+    Trace() = delete;
+    ~Trace() = delete;
+
+    class Span
+    {
+    public:
+        Span(const std::string & category, const std::string & name);
+        ~Span();
+        Span(const Span &) = delete;
+        Span & operator=(const Span &) = delete;
+        // arguments displayed with the span
+        void setArg(const std::string & key, const std::string & value);
+        void setArg(const std::string & key, uint64_t value);
+
+    private:
+        std::string m_category;
+        std::string m_name;
+        std::chrono::steady_clock::time_point m_start;
+        std::vector<std::pair<std::string, std::string>> m_stringArgs;
+        std::vector<std::pair<std::string, uint64_t>> m_numberArgs;
+    };
+
+    // starts recording the spans : they are written to traceFile by stop()
+    static void start(const fs::path & traceFile);
+    // writes the recorded spans to the trace file
+    static void stop();
+    static bool enabled();
+};
+
+#endif // TRACE_H
@@ -0,0 +1,247 @@
+#include "ZipWriter.h"
+#include "BlockDeflater.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <boost/predef.h>
+#include <zlib.h>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr uint16_t VERSION_NEEDED = 20;
+constexpr uint16_t VERSION_MADE_BY = (3 << 8) | VERSION_NEEDED; // unix host : external attributes hold the file mode
+constexpr uint16_t FLAG_UTF8_NAMES = 1 << 11;
+constexpr uint16_t METHOD_STORED = 0;
+constexpr uint16_t METHOD_DEFLATED = 8;
+constexpr int DEFLATE_LEVEL = 9;
+
+constexpr uint32_t MODE_FILE = 0100644;
+constexpr uint32_t MODE_EXECUTABLE = 0100755;
+constexpr uint32_t MODE_SYMLINK = 0120777;
+constexpr uint32_t MODE_DIRECTORY = 040755;
+constexpr uint32_t DOS_DIRECTORY_ATTRIBUTE = 0x10;
+
+typedef struct {
+    std::string name;
+    uint16_t method;
+    uint32_t crc;
+    uint64_t compressedSize;
+    uint64_t size;
+    uint32_t externalAttributes;
+    uint64_t localHeaderOffset;
+} CentralEntry;
+
+class ArchiveStream {
+public:
+    ArchiveStream(const fs::path & archivePath):m_archivePath(archivePath)
+    {
+        fs::detail::utf8_codecvt_facet utf8;
+        m_stream.open(archivePath.generic_string(utf8), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_stream.is_open()) {
+            throw std::runtime_error("Unable to create archive " + archivePath.generic_string(utf8));
+        }
+    }
+
+    void write16(uint16_t value)
+    {
+        char bytes[2] = { static_cast<char>(value & 0xff), static_cast<char>(value >> 8) };
+        write(bytes, 2);
+    }
+
+    void write32(uint32_t value)
+    {
+        write16(static_cast<uint16_t>(value & 0xffff));
+        write16(static_cast<uint16_t>(value >> 16));
+    }
+
+    void write(const char * data, std::size_t size)
+    {
+        m_stream.write(data, static_cast<std::streamsize>(size));
+        if (!m_stream) {
+            fs::detail::utf8_codecvt_facet utf8;
+            throw std::runtime_error("Unable to write archive " + m_archivePath.generic_string(utf8));
+        }
+    }
+
+    uint64_t tell() { return static_cast<uint64_t>(m_stream.tellp()); }
+    void seek(uint64_t offset) { m_stream.seekp(static_cast<std::streamoff>(offset)); }
+    void close() { m_stream.close(); }
+
+private:
+    fs::path m_archivePath;
+    std::ofstream m_stream;
+};
+
+// zip fields are 32 bits : larger archives would need zip64 extensions
+uint32_t checked32(uint64_t value, const std::string & what)
+{
+    if (value > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error(what + " exceeds the 4GB zip limit");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+// MS-DOS date and time of every entry
+std::pair<uint16_t, uint16_t> entryTimestamp()
+{
+    uint16_t dosTime = 0;
+    uint16_t dosDate = (1 << 5) | 1; // 1980-01-01 00:00:00
+    const char * sourceDateEpoch = std::getenv("SOURCE_DATE_EPOCH");
+    if (sourceDateEpoch != nullptr && *sourceDateEpoch != '\0') {
+        std::time_t epoch = static_cast<std::time_t>(std::strtoll(sourceDateEpoch, nullptr, 10));
+        std::tm utcTime{};
+#ifdef BOOST_OS_WINDOWS_AVAILABLE
+        gmtime_s(&utcTime, &epoch);
+#else
+        gmtime_r(&epoch, &utcTime);
+#endif
+        if (utcTime.tm_year >= 80 && utcTime.tm_year < 80 + 128) {
+            dosTime = static_cast<uint16_t>((utcTime.tm_hour << 11) | (utcTime.tm_min << 5) | (utcTime.tm_sec / 2));
+            dosDate = static_cast<uint16_t>(((utcTime.tm_year - 80) << 9) | ((utcTime.tm_mon + 1) << 5) | utcTime.tm_mday);
+        }
+    }
+    return {dosTime, dosDate};
+}
+
+void writeLocalHeader(ArchiveStream & stream, const CentralEntry & entry, std::pair<uint16_t, uint16_t> timestamp)
+{
+    stream.write32(LOCAL_HEADER_SIGNATURE);
+    stream.write16(VERSION_NEEDED);
+    stream.write16(FLAG_UTF8_NAMES);
+    stream.write16(entry.method);
+    stream.write16(timestamp.first);
+    stream.write16(timestamp.second);
+    stream.write32(entry.crc);
+    stream.write32(checked32(entry.compressedSize, entry.name));
+    stream.write32(checked32(entry.size, entry.name));
+    stream.write16(static_cast<uint16_t>(entry.name.size()));
+    stream.write16(0); // no extra field
+    stream.write(entry.name.data(), entry.name.size());
+}
+
+void writeCentralHeader(ArchiveStream & stream, const CentralEntry & entry, std::pair<uint16_t, uint16_t> timestamp)
+{
+    stream.write32(CENTRAL_HEADER_SIGNATURE);
+    stream.write16(VERSION_MADE_BY);
+    stream.write16(VERSION_NEEDED);
+    stream.write16(FLAG_UTF8_NAMES);
+    stream.write16(entry.method);
+    stream.write16(timestamp.first);
+    stream.write16(timestamp.second);
+    stream.write32(entry.crc);
+    stream.write32(checked32(entry.compressedSize, entry.name));
+    stream.write32(checked32(entry.size, entry.name));
+    stream.write16(static_cast<uint16_t>(entry.name.size()));
+    stream.write16(0); // extra field
+    stream.write16(0); // comment
+    stream.write16(0); // disk number
+    stream.write16(0); // internal attributes
+    stream.write32(entry.externalAttributes);
+    stream.write32(checked32(entry.localHeaderOffset, entry.name));
+    stream.write(entry.name.data(), entry.name.size());
+}
+
+}
+
+void ZipWriter::write(const fs::path & archivePath) const
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    if (m_entries.entries().size() >= std::numeric_limits<uint16_t>::max()) {
+        throw std::runtime_error("Too many entries for " + archivePath.generic_string(utf8));
+    }
+    std::pair<uint16_t, uint16_t> timestamp = entryTimestamp();
+    fs::path tmpArchivePath = archivePath.parent_path() / ("." + archivePath.filename().generic_string(utf8) + ".tmp");
+    std::vector<CentralEntry> centralEntries(m_entries.entries().size());
+    std::vector<uint64_t> dataOffsets(m_entries.entries().size(), 0);
+    uint64_t archiveSize = 0;
+    try {
+        ArchiveStream stream(tmpArchivePath);
+        // files are compressed by blocks on a thread pool : headers are written once the data of the previous entries is output
+        BlockDeflater deflater(DEFLATE_LEVEL, [&stream](const char * data, std::size_t size) { stream.write(data, size); });
+        std::size_t index = 0;
+        for (auto & [entryName, entry] : m_entries.entries()) {
+            CentralEntry & centralEntry = centralEntries[index];
+            uint64_t & dataOffset = dataOffsets[index++];
+            centralEntry = CentralEntry{entryName, METHOD_STORED, 0, 0, 0, MODE_FILE << 16, 0};
+            std::string symlinkTarget;
+            switch (entry.type) {
+            case ArchiveEntries::Type::Directory:
+                centralEntry.name += "/";
+                centralEntry.externalAttributes = (MODE_DIRECTORY << 16) | DOS_DIRECTORY_ATTRIBUTE;
+                break;
+            case ArchiveEntries::Type::Symlink:
+                symlinkTarget = fs::read_symlink(entry.sourcePath).generic_string(utf8);
+                centralEntry.externalAttributes = MODE_SYMLINK << 16;
+                centralEntry.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(symlinkTarget.data()), static_cast<uInt>(symlinkTarget.size()));
+                centralEntry.size = centralEntry.compressedSize = symlinkTarget.size();
+                break;
+            case ArchiveEntries::Type::File:
+                if (ArchiveEntries::isExecutable(entry)) {
+                    centralEntry.externalAttributes = MODE_EXECUTABLE << 16;
+                }
+                break;
+            default:
+                break;
+            }
+            deflater.enqueue([&stream, &centralEntry, &dataOffset, symlinkTarget, timestamp]() {
+                centralEntry.localHeaderOffset = stream.tell();
+                writeLocalHeader(stream, centralEntry, timestamp);
+                stream.write(symlinkTarget.data(), symlinkTarget.size());
+                dataOffset = stream.tell();
+            });
+            if (entry.type != ArchiveEntries::Type::File) {
+                continue;
+            }
+            uint64_t fileSize = ArchiveEntries::fileSize(entry);
+            ArchiveEntries::readFile(entry, fileSize, [&deflater](const char * data, std::size_t size) { deflater.write(data, size); });
+            // sizes and crc of files are only known once the data is written : the local header is rewritten afterwards
+            deflater.endStream([&stream, &centralEntry, &dataOffset, &entry, timestamp](uint32_t crc, uint64_t size) {
+                centralEntry.method = METHOD_DEFLATED;
+                centralEntry.crc = crc;
+                centralEntry.size = size;
+                centralEntry.compressedSize = stream.tell() - dataOffset;
+                if (centralEntry.compressedSize >= size) {
+                    // incompressible content : rewritten as is
+                    stream.seek(dataOffset);
+                    ArchiveEntries::readFile(entry, size, [&stream](const char * data, std::size_t chunkSize) { stream.write(data, chunkSize); });
+                    centralEntry.method = METHOD_STORED;
+                    centralEntry.compressedSize = size;
+                }
+                uint64_t dataEnd = stream.tell();
+                stream.seek(centralEntry.localHeaderOffset);
+                writeLocalHeader(stream, centralEntry, timestamp);
+                stream.seek(dataEnd);
+            });
+        }
+        deflater.flush();
+        uint64_t centralDirectoryOffset = stream.tell();
+        for (auto & centralEntry : centralEntries) {
+            writeCentralHeader(stream, centralEntry, timestamp);
+        }
+        uint64_t centralDirectorySize = stream.tell() - centralDirectoryOffset;
+        stream.write32(END_OF_CENTRAL_DIRECTORY_SIGNATURE);
+        stream.write16(0); // disk number
+        stream.write16(0); // central directory disk
+        stream.write16(static_cast<uint16_t>(centralEntries.size()));
+        stream.write16(static_cast<uint16_t>(centralEntries.size()));
+        stream.write32(checked32(centralDirectorySize, archivePath.generic_string(utf8)));
+        stream.write32(checked32(centralDirectoryOffset, archivePath.generic_string(utf8)));
+        stream.write16(0); // comment
+        archiveSize = stream.tell();
+        stream.close();
+        // stored entries rewritten over their deflated data can leave trailing bytes
+        fs::resize_file(tmpArchivePath, archiveSize);
+        fs::rename(tmpArchivePath, archivePath);
+    }
+    catch (...) {
+        boost::system::error_code ec;
+        fs::remove(tmpArchivePath, ec);
+        throw;
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief deterministic zip archive writer
+ * @date 2026-10-19
+ */
+
+#ifndef ZIPWRITER_H
+#define ZIPWRITER_H
+
+#include <string>
+#include <boost/filesystem.hpp>
+#include "ArchiveEntries.h"
+
+namespace fs = boost::filesystem;
+
+// Writes reproducible zip archives : the same entries always produce the same bytes.
+// - entries are sorted by name and every parent folder gets its own entry
+// - timestamps are normalized to SOURCE_DATE_EPOCH when set, to 1980-01-01 otherwise
+// - permissions are normalized to 0644/0755 (executable files and folders), symbolic links are stored as links
+// - no uid/gid or extended timestamps are written, and compression parameters are fixed
+// Files are compressed by blocks on a thread pool (see BlockDeflater) : the output doesn't depend on the number of threads.
+class ZipWriter
+{
+public:
+    ZipWriter() = default;
+    // entryName is the generic path of the entry in the archive, patches are applied to the archived content
+    void addFile(const std::string & entryName, const fs::path & sourcePath, const ElfUtils::Patches & patches = {}) { m_entries.addFile(entryName, sourcePath, patches); }
+    void addEmptyFile(const std::string & entryName) { m_entries.addEmptyFile(entryName); }
+    void addDirectory(const std::string & entryName) { m_entries.addDirectory(entryName); }
+    // throws std::runtime_error on failure : archivePath is only replaced when the archive is complete
+    void write(const fs::path & archivePath) const;
+
+private:
+    ArchiveEntries m_entries;
+};
+
+#endif // ZIPWRITER_H
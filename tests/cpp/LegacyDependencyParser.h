@@ -0,0 +1,179 @@
+/**
+ * @copyright Copyright (c) 2019 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @author Loïc Touraine
+ *
+ * @file
+ * @brief reference copy of the getline/regex/boost::split packagedependencies parser replaced by DependencyFileParser
+ * @date 2026-10-19
+ */
+
+#ifndef LEGACYDEPENDENCYPARSER_H
+#define LEGACYDEPENDENCYPARSER_H
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include "Dependency.h"
+
+namespace fs = boost::filesystem;
+
+namespace legacy {
+
+// dependency line fields as the former Dependency constructor tokenized them (boost::split and boost::trim)
+typedef struct {
+    std::string packageName;
+    std::string channel = "stable";
+    std::string version;
+    std::string name;
+    std::string identifier;
+    std::string baseRepository;
+    std::string mode;
+    std::string toolOptions;
+    std::size_t fieldCount = 0;
+    std::vector<std::string> conditions;
+} Fields;
+
+inline std::string stripEndlineChar(const std::string & str)
+{
+    std::string strippedStr = str;
+    if (!strippedStr.empty() && strippedStr.back() == '\r') {
+        strippedStr.pop_back();
+    }
+    return strippedStr;
+}
+
+inline Fields tokenize(const std::string & line)
+{
+    Fields fields;
+    std::vector<std::string> results, pkgInformations, repositoryInformations;
+    boost::split(results, line, [](char c){return c == '|';});
+    boost::split(pkgInformations, results[0], [](char c){return c == '#';});
+    boost::split(repositoryInformations, results[3], [](char c){return c == '@';});
+    auto parseConditions = [&fields](const std::string & token) {
+        std::vector<std::string> conditions;
+        boost::split(conditions, token, [](char c){return c == '%';});
+        for (std::size_t i = 1; i < conditions.size(); i++) {
+            fields.conditions.push_back(conditions[i]);
+        }
+        return conditions[0];
+    };
+    fields.fieldCount = results.size();
+    if (pkgInformations.size() >= 2) {
+        fields.packageName = pkgInformations[0];
+        fields.channel = boost::trim_copy(parseConditions(pkgInformations[1]));
+    }
+    else {
+        fields.packageName = boost::trim_copy(parseConditions(pkgInformations[0]));
+    }
+    fields.version = boost::trim_copy(results[1]);
+    fields.name = boost::trim_copy(parseConditions(results[2]));
+    fields.identifier = boost::trim_copy(repositoryInformations[0]);
+    if (results.size() >= 5) {
+        fields.baseRepository = boost::trim_copy(stripEndlineChar(results[4]));
+    }
+    if (results.size() >= 6) {
+        fields.mode = boost::trim_copy(stripEndlineChar(results[5]));
+    }
+    if (results.size() == 7) {
+        fields.toolOptions = stripEndlineChar(results[6]);
+    }
+    return fields;
+}
+
+inline std::vector<Dependency> removeRedundantDependencies(const std::multimap<std::string,Dependency> & dependencies)
+{
+    std::vector<Dependency> depVector;
+    for (auto const & node : dependencies) {
+        if (!node.second.isSystemDependency()) {
+            depVector.push_back(node.second);
+        }
+        else if (dependencies.count(node.first) == 1 || node.second.isSpecificSystemToolDependency()) {
+            depVector.push_back(node.second);
+        }
+    }
+    return depVector;
+}
+
+// lines receives the source line of each returned dependency
+inline std::vector<Dependency> parse(const fs::path & dependenciesPath, const std::string & linkMode, std::vector<std::string> * lines = nullptr)
+{
+    std::multimap<std::string,std::pair<Dependency,std::string>> libraries;
+    std::multimap<std::string,Dependency> dependencies;
+    if (fs::exists(dependenciesPath)) {
+        std::ifstream fis(dependenciesPath.generic_string(),std::ios::in);
+        std::regex commentRegex("^[ \t]*//", std::regex_constants::extended);
+        while (!fis.eof()) {
+            std::string curStr;
+            getline(fis,curStr);
+            if (curStr.empty()) {
+                continue;
+            }
+            std::smatch sm;
+            if (std::regex_search(curStr, sm, commentRegex, std::regex_constants::match_any)) {
+                std::cout<<"[IGNORED]: Dependency line '"<<curStr<<"' is commented !"<<std::endl;
+                continue;
+            }
+            std::vector<std::string> results;
+            boost::split(results, curStr, [](char c){return c == '|';});
+            if (results.size() < 4) {
+                std::cout<<"[IGNORED]: Dependency line '"<<curStr<<"' with invalid format !"<<std::endl;
+                continue;
+            }
+            Dependency dep(curStr, linkMode);
+            if (!dep.validate()) {
+                throw std::runtime_error("Error parsing dependency file : invalid format ");
+            }
+            if (dep.isGenericSystemDependency() || dep.isSpecificSystemToolDependency() || !dep.isSystemDependency()) {
+                bool bFoundSame = false;
+                auto range = libraries.equal_range(dep.getName());
+                for (auto i = range.first; i != range.second; ++i) {
+                    if (i->second.first == dep) {
+                        bFoundSame = true;
+                    }
+                }
+                if (!bFoundSame) {
+                    libraries.insert({dep.getName(), {dep, curStr}});
+                }
+            }
+        }
+    }
+    std::multimap<std::string,std::string> sourceLines;
+    for (auto & [name, entry] : libraries) {
+        dependencies.insert({name, entry.first});
+        sourceLines.insert({name, entry.second});
+    }
+    std::vector<Dependency> depVector = removeRedundantDependencies(dependencies);
+    if (lines != nullptr) {
+        // same filtering as removeRedundantDependencies
+        auto lineIt = sourceLines.begin();
+        for (auto & [name, dep] : dependencies) {
+            if (!dep.isSystemDependency() || dependencies.count(name) == 1 || dep.isSpecificSystemToolDependency()) {
+                lines->push_back(lineIt->second);
+            }
+            ++lineIt;
+        }
+    }
+    return depVector;
+}
+
+}
+
+#endif // LEGACYDEPENDENCYPARSER_H
@@ -0,0 +1,54 @@
+#!/bin/bash
+# Builds tests/cpp programs against the remaken sources (src/main.cpp excepted).
+# usage : tests/cpp/build.sh program... (for instance : tests/cpp/build.sh parser_tests parser_benchmark)
+# Programs are written in $BUILD_DIR (default tests/cpp/build).
+# The system boost, openssl, zlib and Google Benchmark are used : set CXXFLAGS and LDFLAGS for other installations.
+# FUZZ=1 builds the *_fuzz programs with libFuzzer (clang++), they otherwise replay the files given as arguments.
+set -e
+
+ROOT_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD_DIR=${BUILD_DIR:-$ROOT_DIR/tests/cpp/build}
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:-"-O2 -DNDEBUG"}
+JOBS=${JOBS:-$(getconf _NPROCESSORS_ONLN)}
+VERSION=$(grep -E '^VERSION *=' "$ROOT_DIR/remaken.pro" | sed 's/.*= *//')
+FLAGS="-std=c++17 -DBOOST_ALL_NO_LIB -DBOOST_ALL_DYN_LINK -DMYVERSION=$VERSION -DMYVERSIONSTRING=\"$VERSION\"
+       -I$ROOT_DIR/src -I$ROOT_DIR -I$ROOT_DIR/libs/nlohmann-json/single_include -I$ROOT_DIR/libs/CLI11/include"
+LIBS="-lboost_log_setup -lboost_log -lboost_regex -lboost_filesystem -lboost_thread -lboost_system -lssl -lcrypto -lz -lpthread -ldl"
+
+if [ "$FUZZ" = "1" ]; then
+    CXX=${FUZZ_CXX:-clang++}
+    CXXFLAGS="$CXXFLAGS -g -fsanitize=fuzzer-no-link,address -DREMAKEN_LIBFUZZER"
+    BUILD_DIR=$BUILD_DIR/fuzz
+fi
+
+mkdir -p "$BUILD_DIR/obj"
+cd "$ROOT_DIR"
+SOURCES=$(grep -E '^\s+src/.*\.cpp' remaken.pro | awk '{print $1}' | grep -v '^src/main.cpp$')
+
+# an object is rebuilt when its source or any header is newer
+OBJECTS=""
+STALE=""
+for source in $SOURCES; do
+    object="$BUILD_DIR/obj/$(echo "$source" | tr '/' '_').o"
+    OBJECTS="$OBJECTS $object"
+    if [ ! -f "$object" ] || [ "$source" -nt "$object" ] || [ -n "$(find src -name '*.h' -newer "$object" | head -1)" ]; then
+        STALE="$STALE $source"
+    fi
+done
+export CXX CXXFLAGS FLAGS BUILD_DIR
+for source in $STALE; do echo "$source"; done | xargs -r -P "$JOBS" -I{} sh -c \
+    'echo "compiling {}" && $CXX $FLAGS $CXXFLAGS -c {} -o "$BUILD_DIR/obj/$(echo {} | tr / _).o"'
+
+for program in "$@"; do
+    echo "linking $program"
+    LINKFLAGS=""
+    if [ "$FUZZ" = "1" ]; then
+        LINKFLAGS="-fsanitize=fuzzer,address"
+    fi
+    # Google Benchmark suites
+    if grep -q '<benchmark/benchmark.h>' "tests/cpp/$program.cpp"; then
+        LINKFLAGS="$LINKFLAGS -lbenchmark"
+    fi
+    $CXX $FLAGS $CXXFLAGS -Itests/cpp "tests/cpp/$program.cpp" $OBJECTS -o "$BUILD_DIR/$program" $LINKFLAGS $LDFLAGS $LIBS
+done
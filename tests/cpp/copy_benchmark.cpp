@@ -0,0 +1,95 @@
+// Copies a generated bundle (2 GiB by default) with OsUtils::copyFile and with boost::filesystem::copy_file,
+// and reports the throughput and the copy methods used (reflink, copy_file_range, sendfile or buffered).
+// build : tests/cpp/build.sh copy_benchmark, usage : copy_benchmark [work folder (default temporary folder)] [bundle size in MiB (default 2048)]
+// Use a work folder on the file system to measure (btrfs, xfs ... volumes support reflinks).
+
+#include "utils/OsUtils.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace {
+
+// library sizes of the generated bundle, in MiB : the bundle repeats them up to the requested size
+const std::vector<std::size_t> librarySizes = {1, 1, 2, 4, 8, 16, 32, 64, 128};
+
+std::vector<fs::path> createBundle(const fs::path & folder, std::size_t totalSize)
+{
+    fs::create_directories(folder);
+    std::vector<fs::path> files;
+    std::vector<char> buffer(1024 * 1024);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    std::size_t writtenSize = 0;
+    for (std::size_t i = 0; writtenSize < totalSize; i++) {
+        std::size_t fileSize = std::min(librarySizes[i % librarySizes.size()] * buffer.size(), totalSize - writtenSize);
+        fs::path filePath = folder / ("libbundle" + std::to_string(i) + ".so");
+        std::ofstream fos(filePath.generic_string(), std::ios::out | std::ios::binary);
+        for (std::size_t size = 0; size < fileSize; size += buffer.size()) {
+            // xorshift content : neither sparse nor compressible
+            for (std::size_t offset = 0; offset + sizeof(uint64_t) <= buffer.size(); offset += sizeof(uint64_t)) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                std::memcpy(buffer.data() + offset, &state, sizeof(uint64_t));
+            }
+            fos.write(buffer.data(), static_cast<std::streamsize>(std::min(buffer.size(), fileSize - size)));
+        }
+        files.push_back(filePath);
+        writtenSize += fileSize;
+    }
+    return files;
+}
+
+template <typename CopyFunc>
+double copyBundle(const std::vector<fs::path> & files, const fs::path & destinationFolder, CopyFunc && copyFunc)
+{
+    fs::remove_all(destinationFolder);
+    fs::create_directories(destinationFolder);
+    auto start = std::chrono::steady_clock::now();
+    for (auto & file : files) {
+        copyFunc(file, destinationFolder / file.filename());
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    fs::path workFolder = (argc > 1 ? fs::path(argv[1]) : fs::temp_directory_path()) / fs::unique_path("remaken-copy-benchmark-%%%%-%%%%");
+    std::size_t totalSize = (argc > 2 ? std::stoul(argv[2]) : 2048) * 1024 * 1024;
+    int result = 0;
+    try {
+        std::vector<fs::path> files = createBundle(workFolder / "source", totalSize);
+        double sizeMiB = static_cast<double>(totalSize) / (1024 * 1024);
+        std::cout<<std::fixed<<std::setprecision(2);
+        std::cout<<"bundle : "<<files.size()<<" libraries, "<<sizeMiB<<" MiB in "<<workFolder.generic_string(utf8)<<std::endl;
+
+        double boostTime = copyBundle(files, workFolder / "destination", [](const fs::path & source, const fs::path & destination) {
+            fs::copy_file(source, destination, fs::copy_options::overwrite_existing);
+        });
+        std::cout<<"boost::filesystem::copy_file : "<<boostTime<<" s ("<<sizeMiB / boostTime<<" MiB/s)"<<std::endl;
+
+        std::map<OsUtils::CopyMethod, std::size_t> methodCounts;
+        double copyTime = copyBundle(files, workFolder / "destination", [&methodCounts](const fs::path & source, const fs::path & destination) {
+            methodCounts[OsUtils::copyFile(source, destination)]++;
+        });
+        std::cout<<"OsUtils::copyFile            : "<<copyTime<<" s ("<<sizeMiB / copyTime<<" MiB/s), speedup "<<boostTime / copyTime<<"x"<<std::endl;
+        for (auto & [method, count] : methodCounts) {
+            std::cout<<"    "<<OsUtils::copyMethodName(method)<<" : "<<count<<" files"<<std::endl;
+        }
+    }
+    catch (const std::exception & e) {
+        std::cerr<<"Error : "<<e.what()<<std::endl;
+        result = 1;
+    }
+    boost::system::error_code ec;
+    fs::remove_all(workFolder, ec);
+    return result;
+}
@@ -0,0 +1,191 @@
+// Memory and time of a synthetic dependency graph held with interned Dependency fields,
+// compared with the former plain std::string layout, and of by value versus by reference graph walks.
+// build : tests/cpp/build.sh interned_benchmark, usage : interned_benchmark [nodes count (default 10000)] [edges per node (default 4)]
+
+#include "Dependency.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+namespace {
+
+// live heap bytes and allocations count, tracked through the global operator new/delete below
+std::size_t liveBytes = 0;
+std::size_t allocations = 0;
+
+}
+
+void * operator new(std::size_t size)
+{
+    void * ptr = std::malloc(size + sizeof(std::max_align_t));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t *>(ptr) = size;
+    liveBytes += size;
+    allocations++;
+    return static_cast<char *>(ptr) + sizeof(std::max_align_t);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    void * block = static_cast<char *>(ptr) - sizeof(std::max_align_t);
+    liveBytes -= *static_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace {
+
+// former Dependency layout : every field is an owned std::string
+struct PlainDependency {
+    PlainDependency(const std::vector<std::string_view> & fields):packageName(fields[0]), packageChannel("stable"), name(fields[2]),
+        version(fields[1]), baseRepository(fields[4]), originalBaseRepository(fields[4]), identifier(fields[3]),
+        repositoryType("github"), mode(fields[5]) {}
+    std::string packageName;
+    std::string packageChannel;
+    std::string name;
+    std::string version;
+    std::string baseRepository;
+    std::string originalBaseRepository;
+    std::string identifier;
+    std::string repositoryType;
+    std::string mode;
+    std::string toolOptions;
+    std::vector<std::string> buildConditions;
+    std::vector<std::string> cflags;
+    std::vector<std::string> libs;
+    std::string prefix;
+    std::vector<std::string> libdirs;
+    std::vector<std::string> defines;
+    Dependency::Type type = Dependency::Type::REMAKEN;
+};
+
+struct Measure {
+    double milliseconds;
+    std::size_t bytes;
+    std::size_t allocations;
+};
+
+Measure measure(const std::function<void()> & func)
+{
+    std::size_t startBytes = liveBytes, startAllocations = allocations;
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return {std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), liveBytes - startBytes, allocations - startAllocations};
+}
+
+void report(const std::string & label, const Measure & m, bool withBytes)
+{
+    std::cout<<std::left<<std::setw(36)<<label<<std::right<<std::setw(10)<<m.milliseconds<<" ms"<<std::setw(12)<<m.allocations<<" allocations";
+    if (withBytes) {
+        std::cout<<std::setw(12)<<m.bytes / 1024<<" KiB live";
+    }
+    std::cout<<std::endl;
+}
+
+// depth first walk from every root, as the recursive retrieve/parse walkers do : each visit gets its node by value or by reference
+template <typename Node, bool byValue>
+std::size_t walk(const std::vector<Node> & nodes, const std::vector<std::vector<std::size_t>> & edges)
+{
+    std::size_t visited = 0;
+    std::vector<bool> done(nodes.size(), false);
+    std::function<void(std::size_t)> visit = [&](std::size_t index) {
+        if (done[index]) {
+            return;
+        }
+        done[index] = true;
+        if constexpr (byValue) {
+            Node node = nodes[index];
+            visited += node.name.size() > 0;
+        }
+        else {
+            const Node & node = nodes[index];
+            visited += node.name.size() > 0;
+        }
+        for (std::size_t child : edges[index]) {
+            visit(child);
+        }
+    };
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        visit(i);
+    }
+    return visited;
+}
+
+// Dependency has no public name member : adapter for walk()
+struct DependencyNode {
+    DependencyNode(const std::vector<std::string_view> & fields):dep(fields, "shared"), name(dep.getName()) {}
+    Dependency dep;
+    const std::string & name;
+};
+
+}
+
+int main(int argc, char ** argv)
+{
+    std::size_t nodeCount = argc > 1 ? std::stoul(argv[1]) : 10000;
+    std::size_t edgeCount = argc > 2 ? std::stoul(argv[2]) : 4;
+    static const std::vector<std::string> versions = {"1.0.0", "1.2.3", "2.0.0", "2.4.1", "3.4.3", "4.5.0", "0.14.0", "1.78.0"};
+    static const std::vector<std::string> repositories = {"https://github.com/b-com-software-basis/remaken/releases/download",
+                                                           "https://artifactory.b-com.com/artifactory/solar-generic-local",
+                                                           "https://github.com/SolarFramework/binaries/releases/download"};
+    static const std::vector<std::string> identifiers = {"thirdParties@github", "bcomBuild@artifactory", "SolarFramework@github"};
+
+    // a graph revisits packages through diamonds : a quarter of the nodes are distinct packages
+    std::vector<std::string> lines;
+    std::vector<std::vector<std::string_view>> fields;
+    std::size_t packageCount = std::max<std::size_t>(nodeCount / 4, 1);
+    for (std::size_t i = 0; i < nodeCount; i++) {
+        std::string package = "solar-framework-module" + std::to_string(i % packageCount);
+        lines.push_back(package + "|" + versions[i % versions.size()] + "|" + package + "|" + identifiers[i % identifiers.size()] + "|"
+                        + repositories[i % repositories.size()] + "|" + (i % 2 ? "shared" : "static"));
+    }
+    for (auto & line : lines) {
+        std::vector<std::string_view> lineFields;
+        std::size_t start = 0, end;
+        while ((end = line.find('|', start)) != std::string::npos) {
+            lineFields.push_back(std::string_view(line).substr(start, end - start));
+            start = end + 1;
+        }
+        lineFields.push_back(std::string_view(line).substr(start));
+        fields.push_back(lineFields);
+    }
+    std::mt19937 generator(42);
+    std::vector<std::vector<std::size_t>> edges(nodeCount);
+    for (std::size_t i = 1; i < nodeCount; i++) {
+        for (std::size_t e = 0; e < edgeCount; e++) {
+            edges[i].push_back(generator() % i);
+        }
+    }
+
+    std::cout<<std::fixed<<std::setprecision(2);
+    std::cout<<nodeCount<<" nodes, "<<packageCount<<" distinct packages, "<<edgeCount<<" edges per node"<<std::endl;
+    std::vector<PlainDependency> plainNodes;
+    std::vector<DependencyNode> internedNodes;
+    plainNodes.reserve(nodeCount);
+    internedNodes.reserve(nodeCount);
+    Measure plainBuild = measure([&]() { for (auto & f : fields) { plainNodes.emplace_back(f); } });
+    // the interning table is empty at this point : its storage is part of the measure
+    Measure internedBuild = measure([&]() { for (auto & f : fields) { internedNodes.emplace_back(f); } });
+    report("build, std::string fields", plainBuild, true);
+    report("build, interned fields", internedBuild, true);
+
+    std::size_t visited = 0;
+    report("walk by value, std::string fields", measure([&]() { visited += walk<PlainDependency, true>(plainNodes, edges); }), false);
+    report("walk by value, interned fields", measure([&]() { visited += walk<DependencyNode, true>(internedNodes, edges); }), false);
+    report("walk by reference", measure([&]() { visited += walk<DependencyNode, false>(internedNodes, edges); }), false);
+    std::cout<<"sizeof(Dependency) "<<sizeof(Dependency)<<" bytes, former layout "<<sizeof(PlainDependency)<<" bytes"<<std::endl;
+    return visited == 3 * nodeCount ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// Google Benchmark suite timing the former and the current packagedependencies parsers,
+// and DependencyFileCache hits, on generated files.
+// build : tests/cpp/build.sh parser_benchmark (links libbenchmark), usage : parser_benchmark [--benchmark_* options]
+
+#include "LegacyDependencyParser.h"
+#include "utils/DependencyFileCache.h"
+#include "utils/DependencyFileParser.h"
+#include <benchmark/benchmark.h>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+// generated dependency files, one per lines count, and cache entries, removed at exit
+std::map<int64_t, fs::path> dependencyFiles;
+const fs::path cacheFolder = fs::temp_directory_path() / fs::unique_path("remaken-parser-benchmark-cache-%%%%-%%%%");
+
+const fs::path & dependencyFile(int64_t lineCount)
+{
+    auto it = dependencyFiles.find(lineCount);
+    if (it != dependencyFiles.end()) {
+        return it->second;
+    }
+    static const std::vector<std::string> repositories = {"thirdParties|https://github.com/x/releases/download", "bcomBuild@artifactory|https://artifactory/x",
+                                                           "conan|conan-center|shared|-o shared=True", "apt-get@system", "github|https://github.com/y/releases/download|static"};
+    std::ostringstream content;
+    for (int64_t i = 0; i < lineCount; i++) {
+        if (i % 10 == 0) {
+            content<<"// "<<i<<" dependencies\n";
+        }
+        content<<"package"<<i<<"#stable%cond"<<i % 3<<"|"<<i % 7<<".0."<<i % 11<<"|package"<<i<<"|"<<repositories[i % repositories.size()]<<"\n";
+    }
+    fs::path filePath = fs::temp_directory_path() / fs::unique_path("remaken-parser-benchmark-%%%%-%%%%.txt");
+    std::ofstream(filePath.generic_string(), std::ios::out | std::ios::binary)<<content.str();
+    // older than the cache entries : hits don't check the file content
+    fs::last_write_time(filePath, std::time(nullptr) - 10);
+    return dependencyFiles[lineCount] = filePath;
+}
+
+template <typename ParseFunc>
+void runParse(benchmark::State & state, ParseFunc && parseFunc)
+{
+    const fs::path & filePath = dependencyFile(state.range(0));
+    // [IGNORED] messages are not part of the measure
+    std::ostringstream discarded;
+    std::streambuf * coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+    std::size_t count = 0;
+    for (auto _ : state) {
+        count = parseFunc(filePath);
+        benchmark::DoNotOptimize(count);
+    }
+    std::cout.rdbuf(coutBuffer);
+    state.counters["dependencies"] = static_cast<double>(count);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_LegacyParse(benchmark::State & state)
+{
+    runParse(state, [](const fs::path & filePath) { return legacy::parse(filePath, "shared").size(); });
+}
+
+void BM_DependencyFileParse(benchmark::State & state)
+{
+    runParse(state, [](const fs::path & filePath) { return DependencyFileParser::parse(filePath, "shared").size(); });
+}
+
+void BM_DependencyFileCacheHit(benchmark::State & state)
+{
+    // the first parse writes the cache entry
+    std::ostringstream discarded;
+    std::streambuf * coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+    DependencyFileCache::parse(dependencyFile(state.range(0)), "shared");
+    std::cout.rdbuf(coutBuffer);
+    runParse(state, [](const fs::path & filePath) { return DependencyFileCache::parse(filePath, "shared").size(); });
+}
+
+}
+
+BENCHMARK(BM_LegacyParse)->Arg(100)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DependencyFileParse)->Arg(100)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DependencyFileCacheHit)->Arg(100)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    fs::create_directories(cacheFolder);
+    DependencyFileCache::setCacheFolder(cacheFolder);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    for (auto & [lineCount, filePath] : dependencyFiles) {
+        fs::remove(filePath);
+    }
+    fs::remove_all(cacheFolder);
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Fuzz target for DependencyFileParser::parse(std::string_view, ...) : any input either parses or throws std::runtime_error.
+// Built with FUZZ=1 tests/cpp/build.sh parser_fuzz, run : parser_fuzz corpus_folder (samples/ is a good seed corpus).
+// Without libFuzzer, parser_fuzz replays the files given as arguments.
+
+#include "utils/DependencyFileParser.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+    std::string_view content(reinterpret_cast<const char *>(data), size);
+    // [IGNORED] messages
+    std::ostringstream discarded;
+    std::streambuf * coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+    try {
+        std::vector<std::string_view> lines;
+        std::vector<Dependency> dependencies = DependencyFileParser::parse(content, "shared", "fuzz", &lines);
+        if (lines.size() != dependencies.size()) {
+            std::abort();
+        }
+        // lines are views on the content
+        for (auto & line : lines) {
+            if (line.data() < content.data() || line.data() + line.size() > content.data() + content.size()) {
+                std::abort();
+            }
+        }
+    }
+    catch (const std::runtime_error &) {
+    }
+    std::cout.rdbuf(coutBuffer);
+    return 0;
+}
+
+#ifndef REMAKEN_LIBFUZZER
+int main(int argc, char ** argv)
+{
+    for (int i = 1; i < argc; i++) {
+        std::ifstream fis(argv[i], std::ios::in | std::ios::binary);
+        std::ostringstream content;
+        content<<fis.rdbuf();
+        std::string data = content.str();
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    }
+    std::cout<<"replayed "<<argc - 1<<" inputs"<<std::endl;
+    return 0;
+}
+#endif
@@ -0,0 +1,172 @@
+// Checks that DependencyFileParser returns the same dependencies, in the same order, as the former parser
+// for the files given as arguments (for instance samples/*.txt) and for built-in edge cases,
+// that DependencyFileCache entries give back the same dependencies, and that parse errors are located at the rejected field.
+// usage : parser_tests [packagedependencies files...]
+
+#include "LegacyDependencyParser.h"
+#include "utils/DependencyFileCache.h"
+#include "utils/DependencyFileParser.h"
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string & message)
+{
+    if (!condition) {
+        std::cerr<<"FAILED : "<<message<<std::endl;
+        failures++;
+    }
+}
+
+std::string readFile(const fs::path & filePath)
+{
+    std::ifstream fis(filePath.generic_string(), std::ios::in | std::ios::binary);
+    std::ostringstream content;
+    content<<fis.rdbuf();
+    return content.str();
+}
+
+void checkFields(const Dependency & dep, const std::string & line, const std::string & linkMode, const std::string & context)
+{
+    legacy::Fields fields = legacy::tokenize(line);
+    check(dep.getPackageName() == fields.packageName, context + " package name '" + dep.getPackageName() + "' != '" + fields.packageName + "'");
+    check(dep.getChannel() == fields.channel, context + " channel '" + dep.getChannel() + "' != '" + fields.channel + "'");
+    check(dep.getVersion() == fields.version, context + " version '" + dep.getVersion() + "' != '" + fields.version + "'");
+    check(dep.getName() == fields.name, context + " name '" + dep.getName() + "' != '" + fields.name + "'");
+    check(dep.getIdentifier() == fields.identifier, context + " identifier '" + dep.getIdentifier() + "' != '" + fields.identifier + "'");
+    check(dep.getConditions() == fields.conditions, context + " conditions");
+    check(dep.getToolOptions() == fields.toolOptions, context + " tool options '" + dep.getToolOptions() + "' != '" + fields.toolOptions + "'");
+    if (!fields.baseRepository.empty()) {
+        check(dep.getBaseRepository() == fields.baseRepository, context + " base repository '" + dep.getBaseRepository() + "' != '" + fields.baseRepository + "'");
+    }
+    if (fields.mode == "static" || fields.mode == "shared" || fields.mode == "na") {
+        check(dep.getMode() == fields.mode, context + " mode '" + dep.getMode() + "' != '" + fields.mode + "'");
+    }
+    else {
+        check(dep.getMode() == linkMode, context + " default mode '" + dep.getMode() + "' != '" + linkMode + "'");
+    }
+}
+
+// the first parse of a copy writes the cache entry. The copy is then blanked out with the same size and modification time :
+// only a cache hit still returns its dependencies
+void checkCache(const fs::path & sourcePath, const std::string & linkMode, const std::vector<Dependency> & parsed, const std::string & context)
+{
+    std::string content = readFile(sourcePath);
+    fs::path filePath = fs::temp_directory_path() / fs::unique_path("remaken-parser-cache-%%%%-%%%%.txt");
+    std::ofstream(filePath.generic_string(), std::ios::out | std::ios::binary)<<content;
+    std::time_t lastWriteTime = std::time(nullptr) - 10;
+    fs::last_write_time(filePath, lastWriteTime);
+    for (const std::string pass : {"miss", "hit"}) {
+        std::vector<Dependency> cached = DependencyFileCache::parse(filePath, linkMode);
+        check(cached.size() == parsed.size(), context + " cache " + pass + " : " + std::to_string(cached.size()) + " dependencies instead of " + std::to_string(parsed.size()));
+        for (std::size_t i = 0; i < cached.size() && i < parsed.size(); i++) {
+            std::string depContext = context + " cache " + pass + " dependency " + parsed[i].toString();
+            check(cached[i] == parsed[i] && cached[i].toString() == parsed[i].toString(), depContext + " differs : " + cached[i].toString());
+            check(cached[i].getType() == parsed[i].getType() && cached[i].getBaseRepository() == parsed[i].getBaseRepository(), depContext + " type or base repository differs");
+            check(cached[i].hasIdentifier() == parsed[i].hasIdentifier() && cached[i].hasOptions() == parsed[i].hasOptions()
+                  && cached[i].hasConditions() == parsed[i].hasConditions(), depContext + " flags differ");
+        }
+        std::ofstream(filePath.generic_string(), std::ios::out | std::ios::binary)<<std::string(content.size(), ' ');
+        fs::last_write_time(filePath, lastWriteTime);
+    }
+    fs::remove(filePath);
+}
+
+void checkEquivalence(const fs::path & filePath)
+{
+    fs::detail::utf8_codecvt_facet utf8;
+    std::string content = readFile(filePath);
+    for (const std::string linkMode : {"shared", "static"}) {
+        std::string context = filePath.generic_string(utf8) + " (" + linkMode + ")";
+        std::vector<Dependency> expected, parsed;
+        std::vector<std::string> expectedLines;
+        std::vector<std::string_view> parsedLines;
+        bool expectedError = false, parsedError = false;
+        try {
+            expected = legacy::parse(filePath, linkMode, &expectedLines);
+        }
+        catch (const std::runtime_error &) {
+            expectedError = true;
+        }
+        try {
+            parsed = DependencyFileParser::parse(content, linkMode, filePath.generic_string(utf8), &parsedLines);
+            check(DependencyFileParser::parse(filePath, linkMode).size() == parsed.size(), context + " file and content parses differ");
+        }
+        catch (const std::runtime_error &) {
+            parsedError = true;
+        }
+        check(expectedError == parsedError, context + " error status differs");
+        if (!parsedError) {
+            checkCache(filePath, linkMode, parsed, context);
+        }
+        check(expected.size() == parsed.size(), context + " " + std::to_string(parsed.size()) + " dependencies instead of " + std::to_string(expected.size()));
+        if (expected.size() != parsed.size()) {
+            continue;
+        }
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            std::string depContext = context + " dependency " + std::to_string(i) + " " + expected[i].toString();
+            check(parsed[i] == expected[i], depContext + " differs : " + parsed[i].toString());
+            check(parsed[i].getBaseRepository() == expected[i].getBaseRepository(), depContext + " base repository differs");
+            check(parsed[i].getType() == expected[i].getType(), depContext + " type differs");
+            check(std::string(parsedLines[i]) == expectedLines[i], depContext + " source line differs");
+            checkFields(parsed[i], expectedLines[i], linkMode, depContext);
+        }
+    }
+}
+
+void checkErrorLocation(const std::string & content, const std::string & expectedLocation)
+{
+    try {
+        DependencyFileParser::parse(content, "shared", "deps.txt");
+        check(false, "no error for '" + content + "'");
+    }
+    catch (const std::runtime_error & e) {
+        std::string message = e.what();
+        check(boost::algorithm::ends_with(message, " at deps.txt:" + expectedLocation), "'" + message + "' is not located at " + expectedLocation);
+    }
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    fs::path casesFolder = fs::temp_directory_path() / fs::unique_path("remaken-parser-tests-%%%%-%%%%");
+    fs::create_directories(casesFolder / "cache");
+    DependencyFileCache::setCacheFolder(casesFolder / "cache");
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        {"comments.txt", "// comment\n   // indented comment\n\t// tab comment\nopencv|3.4.3|opencv|thirdParties|https://github.com/x/releases/download\n"},
+        {"crlf.txt", "opencv|3.4.3|opencv|thirdParties|https://github.com/x/releases/download\r\n\r\nspdlog|0.14.0|spdlog|thirdParties|https://x|shared\r\n"},
+        {"spaces.txt", "  xpcf#beta%cond1%cond2 | 2.4.0 | xpcf%cond3 | bcomBuild@github | https://url | static | opts\r\n"},
+        {"conan.txt", "boost|1.78.0|boost|conan|conan-center|default|-o shared=True\nzlib|1.2.13|zlib|conan|conan-center\nzlib|1.2.13|zlib|conan|conan-center\n"},
+        {"system.txt", "libpng|1.6|libpng|system\nlibpng|1.6|libpng|apt-get@system\neigen|3.3|eigen|brew@system||na\nlibpng|1.6|libpng|yum@system\n"},
+        {"invalid.txt", "bad line\na|b|c\n\nzeta|1.0|zeta|github|https://z\nalpha|1.0|alpha|github|https://a"},
+        {"order.txt", "b|1|b|github|u\na|2|a|github|u\nb|0|b|github|u\na|1|a|github|u\n"},
+        {"empty.txt", ""}
+    };
+    for (auto & [fileName, content] : cases) {
+        std::ofstream((casesFolder / fileName).generic_string(), std::ios::out | std::ios::binary)<<content;
+        checkEquivalence(casesFolder / fileName);
+    }
+    for (int i = 1; i < argc; i++) {
+        checkEquivalence(fs::path(argv[i]));
+    }
+    fs::remove_all(casesFolder);
+
+    // unsupported repository type : column of the identifier@repository type field
+    checkErrorLocation("// comment\nfoo|1.0|foo|  unknown@weird|http://x\n", "2:15");
+    // link mode unsupported by the repository : column of the link mode field
+    checkErrorLocation("foo|1.0|foo|thirdParties|http://x| na\n", "1:36");
+
+    if (failures > 0) {
+        std::cerr<<failures<<" parser checks failed"<<std::endl;
+        return 1;
+    }
+    std::cout<<"parser checks passed"<<std::endl;
+    return 0;
+}
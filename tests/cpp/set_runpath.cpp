@@ -0,0 +1,21 @@
+// Sets the DT_RUNPATH of an ELF file with ElfUtils::setRunpath, as bundles do for their copied libraries.
+// build : tests/cpp/build.sh set_runpath, usage : set_runpath file runpath (prints updated or unchanged)
+
+#include "utils/ElfUtils.h"
+#include <iostream>
+
+int main(int argc, char ** argv)
+{
+    if (argc != 3) {
+        std::cerr<<"usage : set_runpath file runpath"<<std::endl;
+        return 2;
+    }
+    try {
+        std::cout<<(ElfUtils::setRunpath(fs::path(argv[1]), argv[2]) ? "updated" : "unchanged")<<std::endl;
+    }
+    catch (const std::exception & e) {
+        std::cerr<<"Error : "<<e.what()<<std::endl;
+        return 1;
+    }
+    return 0;
+}
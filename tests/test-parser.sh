@@ -0,0 +1,9 @@
+#!/bin/bash
+# Builds and runs the packagedependencies parser checks on the samples, then the parser benchmark (arguments are passed to it).
+set -e
+cd "$(dirname "$0")/.."
+BUILD_DIR=${BUILD_DIR:-tests/cpp/build}
+BUILD_DIR=$BUILD_DIR tests/cpp/build.sh parser_tests parser_benchmark parser_fuzz
+"$BUILD_DIR/parser_tests" samples/*.txt
+"$BUILD_DIR/parser_fuzz" samples/*.txt
+"$BUILD_DIR/parser_benchmark" "$@"
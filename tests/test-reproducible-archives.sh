@@ -0,0 +1,44 @@
+#!/bin/bash
+# Compresses the same package twice, from trees created in a different order with different modification times
+# and permissions, and checks that the archives are byte-for-byte identical.
+# usage : tests/test-reproducible-archives.sh (REMAKEN can point to the remaken binary to test)
+set -e
+REMAKEN=${REMAKEN:-remaken}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+unset SOURCE_DATE_EPOCH
+
+# createPackage root [reverse] : writes the same files, in reverse creation order when asked
+createPackage() {
+    local files="interfaces/foo.h interfaces/detail/bar.h lib/x86_64/shared/release/libfoo.so lib/x86_64/shared/release/libbar.so lib/x86_64/shared/debug/libfoo.so bin/x86_64/shared/release/foo-tool"
+    if [ -n "$2" ]; then
+        files=$(echo $files | tr ' ' '\n' | sort -r)
+    fi
+    for file in $files; do
+        mkdir -p "$1/foo/1.0.0/$(dirname "$file")"
+        echo "content of $file" > "$1/foo/1.0.0/$file"
+    done
+}
+
+createPackage "$WORK_DIR/first"
+chmod 755 "$WORK_DIR/first/foo/1.0.0/bin/x86_64/shared/release/foo-tool"
+"$REMAKEN" package compress --rootdir "$WORK_DIR/first" -d "$WORK_DIR/out-first"
+
+createPackage "$WORK_DIR/second" reverse
+find "$WORK_DIR/second" -type f -exec touch -d "2001-02-03 04:05:06" {} +
+find "$WORK_DIR/second" -type f -exec chmod 600 {} +
+chmod 700 "$WORK_DIR/second/foo/1.0.0/bin/x86_64/shared/release/foo-tool"
+"$REMAKEN" package compress --rootdir "$WORK_DIR/second" -d "$WORK_DIR/out-second"
+
+(cd "$WORK_DIR/out-first" && find . -name '*.zip' | sort | xargs sha256sum) > "$WORK_DIR/first.sha256"
+(cd "$WORK_DIR/out-second" && find . -name '*.zip' | sort | xargs sha256sum) > "$WORK_DIR/second.sha256"
+if [ ! -s "$WORK_DIR/first.sha256" ]; then
+    echo "FAILED : no archive produced"
+    exit 1
+fi
+cat "$WORK_DIR/first.sha256"
+if ! diff "$WORK_DIR/first.sha256" "$WORK_DIR/second.sha256"; then
+    echo "FAILED : archives differ"
+    exit 1
+fi
+echo "archives are reproducible"
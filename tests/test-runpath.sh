@@ -0,0 +1,67 @@
+#!/bin/bash
+# Rewrites the runpath of a small executable and library the way bundles do, then runs them without LD_LIBRARY_PATH.
+# The binaries are linked without runpath : the dynamic section moves to an appended segment.
+# A binary linked with a longer runpath is then rewritten in place.
+set -e
+cd "$(dirname "$0")/.."
+BUILD_DIR=${BUILD_DIR:-tests/cpp/build}
+BUILD_DIR=$BUILD_DIR tests/cpp/build.sh set_runpath
+SET_RUNPATH=$(pwd)/$BUILD_DIR/set_runpath
+CC=${CC:-cc}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cd "$WORK_DIR"
+
+cat > bar.c <<'SOURCE'
+int bar(void) { return 42; }
+SOURCE
+cat > foo.c <<'SOURCE'
+int bar(void);
+int foo(void) { return bar() + 1; }
+SOURCE
+cat > main.c <<'SOURCE'
+#include <stdio.h>
+int foo(void);
+int main(void) { printf("foo=%d\n", foo()); return 0; }
+SOURCE
+mkdir -p build bundle/bin bundle/lib/deps
+$CC -shared -fPIC bar.c -o build/libbar.so
+$CC -shared -fPIC foo.c -Lbuild -lbar -o build/libfoo.so
+$CC main.c -Lbuild -lfoo -Wl,-rpath-link,build -o build/app
+$CC main.c -Lbuild -lfoo -Wl,-rpath-link,build -Wl,-rpath,/a/build/folder/longer/than/the/bundle/runpath -o build/app-inplace
+cp build/app build/app-inplace bundle/bin/
+cp build/libfoo.so bundle/lib/
+cp build/libbar.so bundle/lib/deps/
+
+loadSegments() {
+    readelf -lW "$1" | grep -c ' LOAD '
+}
+
+check() {
+    if [ "$2" != "$3" ]; then
+        echo "FAILED : $1 : '$2' instead of '$3'"
+        exit 1
+    fi
+}
+
+unset LD_LIBRARY_PATH
+if bundle/bin/app > /dev/null 2>&1; then
+    echo "FAILED : the bundle runs before its runpath is set"
+    exit 1
+fi
+for file in bundle/bin/app:'$ORIGIN/../lib' bundle/lib/libfoo.so:'$ORIGIN/deps'; do
+    path=${file%%:*}
+    runpath=${file#*:}
+    segments=$(loadSegments "$path")
+    check "$path runpath update" "$("$SET_RUNPATH" "$path" "$runpath")" "updated"
+    check "$path load segments" "$(loadSegments "$path")" "$((segments + 1))"
+    check "$path runpath" "$(readelf -dW "$path" | grep -E 'RUNPATH|RPATH' | sed 's/.*\[\(.*\)\]/\1/')" "$runpath"
+    check "$path second runpath update" "$("$SET_RUNPATH" "$path" "$runpath")" "unchanged"
+done
+check "bundle run" "$(bundle/bin/app)" "foo=43"
+
+segments=$(loadSegments bundle/bin/app-inplace)
+check "in place runpath update" "$("$SET_RUNPATH" bundle/bin/app-inplace '$ORIGIN/../lib')" "updated"
+check "in place load segments" "$(loadSegments bundle/bin/app-inplace)" "$segments"
+check "in place bundle run" "$(bundle/bin/app-inplace)" "foo=43"
+echo "runpath checks passed"